@@ -0,0 +1,1107 @@
+/*************************************************************************
+Title:    Thermocouple Library Benchmark
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     benchmark.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Host-side throughput benchmarks for every conversion path - per-sample
+    and batch, float and double, random and sorted inputs, each segment on
+    its own, the rational and polynomial tables side by side, the forward
+    (temperature to voltage) conversions, the shared cold junction, raw ADC
+    code, calibrated, sensitivity, scanner, sample ring (in one thread and
+    between two), alarm, filter, integer, lookup table and tracker paths.
+
+    Each figure is the best of several repeats, in ns per sample and
+    samples per second.  The batch, shared cold junction, ADC code,
+    calibrated, sensitivity and ring paths are also checked against the
+    per-sample results (the status forms against getResult()), the
+    sensitivity temperatures against getTemperature(), the alarms against
+    limits applied to converted temperatures, the filters against direct
+    computations of their outputs, audited trackers across every segment
+    against their maxError, and the program exits non-zero if any differ,
+    so it doubles as a regression check (make -C extras check).
+
+    Built by extras/Makefile:
+      make -C extras benchmark
+      extras/build/benchmark [--json] [--samples N] [--passes N] [--repeats N] [--filter text]
+
+    --json writes the results as a single JSON object for tracking across
+    releases.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Thermocouple.h"
+#include "ThermocoupleAlarm.h"
+#include "ThermocoupleFilter.h"
+#include "ThermocoupleFixed.h"
+#include "ThermocoupleLookup.h"
+#include "ThermocoupleRing.h"
+#include "ThermocoupleScanner.h"
+#include "ThermocoupleTracker.h"
+
+#if defined(__AVX2__)
+#define BENCH_KERNEL "avx2"
+#elif defined(__SSE2__)
+#define BENCH_KERNEL "sse2"
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define BENCH_KERNEL "neon"
+#else
+#define BENCH_KERNEL "scalar"
+#endif
+
+struct BenchOptions
+{
+	bool json;
+	size_t samples;
+	int passes;
+	int repeats;
+	const char *filter;
+};
+
+struct BenchResult
+{
+	std::string name;
+	std::string type;
+	int segment;              // -1 = whole range
+	const char *precision;
+	const char *input;        // "random", "sorted" or "drift"
+	double nsPerSample;
+};
+
+static BenchOptions options = { false, 4096, 64, 5, NULL };
+static std::vector<BenchResult> results;
+static int failures = 0;
+
+// Keeps the compiler from discarding results it can see are never read
+static inline void benchClobber(const void *p)
+{
+	asm volatile("" : : "g"(p) : "memory");
+}
+
+static bool benchSelected(const char *name)
+{
+	return (NULL == options.filter) || (NULL != strstr(name, options.filter));
+}
+
+// Best of options.repeats runs of options.passes calls to body, each converting samples values
+template<typename F> static void benchRun(const char *name, const char *type, int segment, const char *precision, const char *input, size_t samples, F body)
+{
+	double best = 0.0;
+
+	if (!benchSelected(name))
+		return;
+	for (int r = 0; r < options.repeats; r++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int p = 0; p < options.passes; p++)
+			body();
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		double ns = elapsed.count() / ((double)samples * options.passes);
+		if (0 == r || ns < best)
+			best = ns;
+	}
+
+	BenchResult result = { name, type, segment, precision, input, best };
+	results.push_back(result);
+	if (!options.json)
+	{
+		char segmentName[8];
+		snprintf(segmentName, sizeof(segmentName), (segment < 0) ? "all" : "%d", segment + 1);
+		printf("%-34s %-6s %-4s %-7s %-7s %9.2f %10.2f\n", name, type, segmentName, precision, input, best, 1000.0 / best);
+	}
+}
+
+template<typename T> static void benchCompare(const char *what, const char *type, const std::vector<T> &expected, const std::vector<T> &actual)
+{
+	if (0 != memcmp(expected.data(), actual.data(), expected.size() * sizeof(T)))
+	{
+		fprintf(stderr, "Type %s: %s results differ from per-sample results\n", type, what);
+		failures++;
+	}
+}
+
+/*********************************************************************************************************
+Per-type benchmarks
+*********************************************************************************************************/
+
+template<ThermocoupleType Type, typename T>
+static void benchPrecision(const char *type, TypedThermocouple<Type> &tc, const char *precision, std::mt19937_64 &rng)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	const size_t n = options.samples;
+	const double lo = Coefficients::breakpoints[0];
+	const double hi = Coefficients::breakpoints[Coefficients::segments];
+	const double tLo = Coefficients::forwardBreakpoints[0];
+	const double tHi = Coefficients::forwardBreakpoints[Coefficients::forwardSegments];
+	std::uniform_real_distribution<double> cjDist(15.0, 35.0);
+	std::vector<T> mv(n), cj(n), temperature(n), expected(n), actual(n);
+	AbstractThermocouple &abstract = tc;
+
+	for (int sorted = 0; sorted < 2; sorted++)
+	{
+		const char *input = sorted ? "sorted" : "random";
+		std::uniform_real_distribution<double> mvDist(lo, hi);
+		std::uniform_real_distribution<double> tDist(tLo, tHi);
+		std::vector<double> target(n), targetT(n);
+
+		for (size_t i = 0; i < n; i++)
+		{
+			target[i] = mvDist(rng);
+			targetT[i] = tDist(rng);
+		}
+		if (sorted)
+		{
+			std::sort(target.begin(), target.end());
+			std::sort(targetT.begin(), targetT.end());
+		}
+		// Readings that land on target once compensated
+		for (size_t i = 0; i < n; i++)
+		{
+			cj[i] = (T)cjDist(rng);
+			mv[i] = (T)(target[i] - Thermocouple<Type>::computeColdJunctionVoltage(cj[i]));
+			temperature[i] = (T)targetT[i];
+		}
+
+		benchRun("getTemperature", type, -1, precision, input, n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				expected[i] = abstract.getTemperature(mv[i], cj[i]);
+			benchClobber(expected.data());
+		});
+		benchRun("getTemperatures", type, -1, precision, input, n, [&]() {
+			abstract.getTemperatures(mv.data(), cj.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.getTemperature(mv[i], cj[i]);
+		abstract.getTemperatures(mv.data(), cj.data(), actual.data(), n);
+		benchCompare("getTemperatures", type, expected, actual);
+
+		std::vector<uint8_t> status(n), expectedStatus(n);
+		benchRun("getTemperatures (status)", type, -1, precision, input, n, [&]() {
+			abstract.getTemperatures(mv.data(), cj.data(), actual.data(), status.data(), n);
+			benchClobber(actual.data());
+			benchClobber(status.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expectedStatus[i] = abstract.getResult(mv[i], cj[i]).status;
+		abstract.getTemperatures(mv.data(), cj.data(), actual.data(), status.data(), n);
+		benchCompare("getTemperatures (status)", type, expected, actual);
+		benchCompare("status", type, expectedStatus, status);
+
+		// Cold junctions spread over (and a little past) the type's cold
+		// junction tables, so every cold junction segment gets used
+		std::uniform_real_distribution<double> wideDist(Coefficients::coldJunctionBreakpoints[0] - 10.0, Coefficients::coldJunctionBreakpoints[Coefficients::coldJunctionSegments] + 10.0);
+		std::vector<T> wide(n);
+		for (size_t i = 0; i < n; i++)
+			wide[i] = (T)wideDist(rng);
+		benchRun("getTemperatures (wide cold junction)", type, -1, precision, input, n, [&]() {
+			abstract.getTemperatures(mv.data(), wide.data(), actual.data(), status.data(), n);
+			benchClobber(actual.data());
+			benchClobber(status.data());
+		});
+		for (size_t i = 0; i < n; i++)
+		{
+			ThermocoupleResult<T> result = abstract.getResult(mv[i], wide[i]);
+			expected[i] = result.temperature;
+			expectedStatus[i] = result.status;
+		}
+		abstract.getTemperatures(mv.data(), wide.data(), actual.data(), status.data(), n);
+		benchCompare("getTemperatures (wide cold junction)", type, expected, actual);
+		benchCompare("status (wide cold junction)", type, expectedStatus, status);
+
+		const ThermocoupleColdJunction<T> coldJunction = abstract.getColdJunction(T(25.0));
+		benchRun("convert (shared cold junction)", type, -1, precision, input, n, [&]() {
+			abstract.convert(coldJunction, mv.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.getTemperature(mv[i], T(25.0));
+		abstract.convert(coldJunction, mv.data(), actual.data(), n);
+		benchCompare("convert", type, expected, actual);
+
+		// The same readings as LTC2499 codes (4.096V reference), scaled to
+		// millivolts first and then converted straight from the codes
+		const ThermocoupleAdcScale scale = { 2048.0, 1.0, 0, 16777216 };
+		const T perCode = (T)(scale.referenceMillivolts / scale.fullScale);
+		const ThermocoupleAdcChannel<T> adcChannel = abstract.getAdcChannel(scale, T(25.0));
+		std::vector<int32_t> codes(n);
+		std::vector<T> scaled(n);
+		for (size_t i = 0; i < n; i++)
+			codes[i] = (int32_t)lround(mv[i] / perCode);
+		benchRun("convert (ADC codes scaled to mV)", type, -1, precision, input, n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				scaled[i] = (T)codes[i] * perCode;
+			abstract.convert(coldJunction, scaled.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		benchRun("convert (ADC codes)", type, -1, precision, input, n, [&]() {
+			abstract.convert(adcChannel, codes.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.convert(adcChannel, codes[i]);
+		abstract.convert(adcChannel, codes.data(), actual.data(), n);
+		benchCompare("convert (ADC codes)", type, expected, actual);
+
+		// A probe calibration applied as a separate pass over the results, then
+		// in the conversion.  The calibrated forms are checked against their
+		// own per-sample form.
+		const ThermocoupleCalibration<T> calibration = { T(-0.0021), T(1.00037), { T(0.35), T(-0.0012), T(2.5e-6), T(-1.0e-9) } };
+		benchRun("getTemperatures + calibration pass", type, -1, precision, input, n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				scaled[i] = mv[i] * calibration.gain + calibration.offset;
+			abstract.getTemperatures(scaled.data(), cj.data(), actual.data(), n);
+			for (size_t i = 0; i < n; i++)
+			{
+				T t = actual[i];
+				if (T(TC_OUT_OF_RANGE_TEMPERATURE) != t)
+					actual[i] = t + (calibration.deviation[0] + t * (calibration.deviation[1] + t * (calibration.deviation[2] + t * calibration.deviation[3])));
+			}
+			benchClobber(actual.data());
+		});
+		benchRun("getTemperatures (calibrated)", type, -1, precision, input, n, [&]() {
+			abstract.getTemperatures(calibration, mv.data(), cj.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.getTemperature(calibration, mv[i], cj[i]);
+		abstract.getTemperatures(calibration, mv.data(), cj.data(), actual.data(), n);
+		benchCompare("getTemperatures (calibrated)", type, expected, actual);
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.convert(coldJunction, calibration, mv[i]);
+		abstract.convert(coldJunction, calibration, mv.data(), actual.data(), n);
+		benchCompare("convert (calibrated)", type, expected, actual);
+
+		// Temperature with dT/dV and the uncertainty from 10uV of reading
+		// noise and 0.5C of cold junction error
+		const T sigmaMillivolts = T(0.01), sigmaTcj = T(0.5);
+		std::vector<T> slopes(n), uncertainties(n), expectedSlopes(n), expectedUncertainties(n);
+		benchRun("getSensitivity", type, -1, precision, input, n, [&]() {
+			for (size_t i = 0; i < n; i++)
+			{
+				ThermocoupleSensitivity<T> sensitivity = abstract.getSensitivity(mv[i], cj[i], sigmaMillivolts, sigmaTcj);
+				expected[i] = sensitivity.temperature;
+				expectedSlopes[i] = sensitivity.slope;
+				expectedUncertainties[i] = sensitivity.uncertainty;
+			}
+			benchClobber(expected.data());
+			benchClobber(expectedSlopes.data());
+			benchClobber(expectedUncertainties.data());
+		});
+		benchRun("getSensitivities", type, -1, precision, input, n, [&]() {
+			abstract.getSensitivities(mv.data(), cj.data(), sigmaMillivolts, sigmaTcj, actual.data(), slopes.data(), uncertainties.data(), n);
+			benchClobber(actual.data());
+			benchClobber(slopes.data());
+			benchClobber(uncertainties.data());
+		});
+		for (size_t i = 0; i < n; i++)
+		{
+			ThermocoupleSensitivity<T> sensitivity = abstract.getSensitivity(mv[i], cj[i], sigmaMillivolts, sigmaTcj);
+			expected[i] = sensitivity.temperature;
+			expectedSlopes[i] = sensitivity.slope;
+			expectedUncertainties[i] = sensitivity.uncertainty;
+		}
+		abstract.getSensitivities(mv.data(), cj.data(), sigmaMillivolts, sigmaTcj, actual.data(), slopes.data(), uncertainties.data(), n);
+		benchCompare("getSensitivities", type, expected, actual);
+		benchCompare("getSensitivities (slope)", type, expectedSlopes, slopes);
+		benchCompare("getSensitivities (uncertainty)", type, expectedUncertainties, uncertainties);
+		for (size_t i = 0; i < n; i++)
+			expected[i] = abstract.getTemperature(mv[i], cj[i]);
+		benchCompare("getSensitivities (temperature)", type, expected, actual);
+
+		benchRun("getVoltage", type, -1, precision, input, n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				expected[i] = tc.getVoltage(temperature[i], cj[i]);
+			benchClobber(expected.data());
+		});
+		benchRun("getVoltages", type, -1, precision, input, n, [&]() {
+			tc.getVoltages(temperature.data(), cj.data(), actual.data(), n);
+			benchClobber(actual.data());
+		});
+		for (size_t i = 0; i < n; i++)
+			expected[i] = tc.getVoltage(temperature[i], cj[i]);
+		tc.getVoltages(temperature.data(), cj.data(), actual.data(), n);
+		benchCompare("getVoltages", type, expected, actual);
+	}
+
+	// Each segment on its own - every sample takes the same path
+	typedef typename Thermocouple<Type>::Tables Tables;
+	for (uint8_t seg = 0; seg < Tables::segments; seg++)
+	{
+		std::uniform_real_distribution<double> mvDist(Tables::breakpoints[seg], Tables::breakpoints[seg + 1]);
+		for (size_t i = 0; i < n; i++)
+		{
+			cj[i] = T(25.0);
+			mv[i] = (T)(mvDist(rng) - Thermocouple<Type>::computeColdJunctionVoltage(25.0));
+		}
+		benchRun("getTemperature", type, seg, precision, "random", n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				expected[i] = abstract.getTemperature(mv[i], cj[i]);
+			benchClobber(expected.data());
+		});
+	}
+}
+
+// Audited trackers drifting across each segment, against their promise to
+// stay within maxError of the full conversion.  In float the full
+// conversion has an error of its own against double (a few hundredths at
+// E's cold end), which the step can be off by at both the anchor and the
+// reading, so twice that is allowed on top.
+template<ThermocoupleType Type, typename T>
+static void benchTrackerAudit(const char *type, const char *precision, std::mt19937_64 &rng)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	typedef Thermocouple<Type, T, false> Full;
+	typedef Thermocouple<Type, double, false> Reference;
+	const T maxError = T(0.01);
+	const size_t n = options.samples;
+	std::normal_distribution<double> noise(0.0, 0.002);
+	std::vector<T> mv(n);
+
+	for (uint8_t seg = 0; seg < Coefficients::segments; seg++)
+	{
+		double lo = Coefficients::breakpoints[seg], hi = Coefficients::breakpoints[seg + 1];
+		double wobble = 0.0;
+		for (size_t i = 0; i < n; i++)
+		{
+			mv[i] = (T)(lo + (hi - lo) * (i + 0.5) / n + noise(rng));
+			if (Full::inRange(mv[i]) && Reference::inRange(mv[i]) && Full::segment(mv[i]) == Reference::segment(mv[i]))
+				wobble = std::max(wobble, fabs((double)Full::computeTemperature(mv[i]) - Reference::computeTemperature(mv[i])));
+		}
+		for (uint8_t order = TC_TRACKER_LINEAR; order <= TC_TRACKER_QUADRATIC; order++)
+		{
+			ThermocoupleTracker<Type, T> tracker(maxError, order);
+			tracker.setAudit(true);
+			for (size_t i = 0; i < n; i++)
+				tracker.computeTemperature(mv[i]);
+			if (tracker.getStats().maxError > maxError + 2.0 * wobble)
+			{
+				fprintf(stderr, "Type %s: %s %s tracker is %.4fC from the full conversion in segment %d, over %.4fC\n", type,
+					(TC_TRACKER_LINEAR == order) ? "linear" : "quadratic", precision, tracker.getStats().maxError, seg + 1, maxError + 2.0 * wobble);
+				failures++;
+			}
+		}
+	}
+}
+
+template<ThermocoupleType Type>
+static void benchType(const char *type, TypedThermocouple<Type> &tc, std::mt19937_64 &rng)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	const size_t n = options.samples;
+
+	benchPrecision<Type, double>(type, tc, "double", rng);
+	benchPrecision<Type, float>(type, tc, "float", rng);
+
+	// Integer path - microvolts and 0.001C
+	std::uniform_real_distribution<double> mvDist(Coefficients::breakpoints[0], Coefficients::breakpoints[Coefficients::segments]);
+	std::vector<int32_t> microvolts(n), TcjMilli(n), milliC(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		microvolts[i] = (int32_t)(mvDist(rng) * 1000.0) - 1000;
+		TcjMilli[i] = 25000;
+	}
+	benchRun("ThermocoupleFixed::getTemperature", type, -1, "int32", "random", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+			milliC[i] = ThermocoupleFixed<Type>::getTemperature(microvolts[i], TcjMilli[i]);
+		benchClobber(milliC.data());
+	});
+
+	// Lookup tables sized for 0.01C
+	std::vector<float> mv(n), out(n);
+	for (size_t i = 0; i < n; i++)
+		mv[i] = (float)mvDist(rng);
+	for (uint8_t order = TC_LOOKUP_LINEAR; order <= TC_LOOKUP_CUBIC; order += TC_LOOKUP_CUBIC - TC_LOOKUP_LINEAR)
+	{
+		const char *name = (TC_LOOKUP_LINEAR == order) ? "lookup linear 0.01C" : "lookup cubic 0.01C";
+		ThermocoupleLookup lookup;
+		if (!benchSelected(name) || !lookup.build<Type>(0.01f, order))
+			continue;
+		benchRun(name, type, -1, "float", "random", n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				out[i] = lookup.computeTemperature(mv[i]);
+			benchClobber(out.data());
+		});
+	}
+
+	// The rational and polynomial tables side by side, whichever the type was
+	// built with, over the range both cover
+	typedef ThermocoupleTemperatureTables<Type, double, false> Rational;
+	typedef ThermocoupleTemperatureTables<Type, double, true> Polynomial;
+	std::uniform_real_distribution<double> bothDist(std::max(Rational::breakpoints[0], Polynomial::breakpoints[0]), std::min(Rational::breakpoints[Rational::segments], Polynomial::breakpoints[Polynomial::segments]));
+	for (size_t i = 0; i < n; i++)
+		mv[i] = (float)bothDist(rng);
+	benchRun("computeTemperature (rational)", type, -1, "float", "random", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+			out[i] = Thermocouple<Type, float, false>::computeTemperature(mv[i]);
+		benchClobber(out.data());
+	});
+	benchRun("computeTemperature (polynomial)", type, -1, "float", "random", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+			out[i] = Thermocouple<Type, float, true>::computeTemperature(mv[i]);
+		benchClobber(out.data());
+	});
+
+	// Tracker on a slowly drifting input - steps of about 1uV, some noise
+	std::normal_distribution<double> noise(0.0, 0.002);
+	double drift = 0.5 * (Coefficients::breakpoints[0] + Coefficients::breakpoints[Coefficients::segments]);
+	for (size_t i = 0; i < n; i++)
+	{
+		drift += 0.001;
+		mv[i] = (float)(drift + noise(rng));
+	}
+	benchRun("Thermocouple<>::computeTemperature", type, -1, "float", "drift", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+			out[i] = Thermocouple<Type, float>::computeTemperature(mv[i]);
+		benchClobber(out.data());
+	});
+	for (uint8_t order = TC_TRACKER_LINEAR; order <= TC_TRACKER_QUADRATIC; order++)
+	{
+		ThermocoupleTracker<Type, float> tracker(0.01f, order);
+		benchRun((TC_TRACKER_LINEAR == order) ? "tracker linear 0.01C" : "tracker quadratic 0.01C", type, -1, "float", "drift", n, [&]() {
+			for (size_t i = 0; i < n; i++)
+				out[i] = tracker.computeTemperature(mv[i]);
+			benchClobber(out.data());
+		});
+	}
+	benchTrackerAudit<Type, float>(type, "float", rng);
+	benchTrackerAudit<Type, double>(type, "double", rng);
+}
+
+/*********************************************************************************************************
+Scanner - a 48 channel rack of interleaved K, J and T inputs
+*********************************************************************************************************/
+
+#define BENCH_SCAN_CHANNELS 48
+
+static void benchScanner(TypeK &k, TypeJ &j, TypeT &t, std::mt19937_64 &rng)
+{
+	AbstractThermocouple *map[BENCH_SCAN_CHANNELS];
+	static ThermocoupleScanner<BENCH_SCAN_CHANNELS> scanner;
+	const int frames = (int)(options.samples / BENCH_SCAN_CHANNELS) + 1;
+	std::vector<float> mv(BENCH_SCAN_CHANNELS * frames), out(BENCH_SCAN_CHANNELS * frames);
+	std::vector<float> expected(BENCH_SCAN_CHANNELS * frames);
+	std::vector<uint8_t> status(BENCH_SCAN_CHANNELS * frames), expectedStatus(BENCH_SCAN_CHANNELS * frames);
+	// Past the end of T's range and into open circuit, to exercise the status bits
+	std::uniform_real_distribution<double> mvDist(0.0, 25.0);
+
+	for (uint8_t ch = 0; ch < BENCH_SCAN_CHANNELS; ch++)
+		map[ch] = (0 == ch % 3) ? (AbstractThermocouple *)&k : (1 == ch % 3) ? (AbstractThermocouple *)&j : (AbstractThermocouple *)&t;
+	scanner.setChannels(map);
+	for (size_t i = 0; i < mv.size(); i++)
+		mv[i] = (0 == i % 101) ? 150.0f : (float)mvDist(rng);
+
+	benchRun("ThermocoupleScanner::scan", "K/J/T", -1, "float", "random", mv.size(), [&]() {
+		for (int f = 0; f < frames; f++)
+			scanner.scan(&mv[f * BENCH_SCAN_CHANNELS], 25.0f, &out[f * BENCH_SCAN_CHANNELS], &status[f * BENCH_SCAN_CHANNELS]);
+		benchClobber(out.data());
+	});
+	benchRun("getTemperature (scan order)", "K/J/T", -1, "float", "random", mv.size(), [&]() {
+		for (size_t i = 0; i < mv.size(); i++)
+			expected[i] = map[i % BENCH_SCAN_CHANNELS]->getTemperature(mv[i], 25.0f);
+		benchClobber(expected.data());
+	});
+
+	// The status bits against getResult(), and the frame's bits ORed together,
+	// with every tenth frame's cold junction past its tables
+	bool frameBits = true;
+	for (int f = 0; f < frames; f++)
+	{
+		float Tcj = (0 == f % 10) ? 160.0f : 25.0f;
+		uint8_t any = scanner.scan(&mv[f * BENCH_SCAN_CHANNELS], Tcj, &out[f * BENCH_SCAN_CHANNELS], &status[f * BENCH_SCAN_CHANNELS]);
+		uint8_t expectedAny = TC_STATUS_OK;
+		for (uint8_t ch = 0; ch < BENCH_SCAN_CHANNELS; ch++)
+		{
+			size_t i = f * BENCH_SCAN_CHANNELS + ch;
+			ThermocoupleResult<float> result = map[ch]->getResult(mv[i], Tcj);
+			expected[i] = result.temperature;
+			expectedStatus[i] = result.status;
+			expectedAny |= result.status;
+		}
+		frameBits = frameBits && (any == expectedAny);
+	}
+
+	// An unused channel, which doesn't count towards the frame's bits
+	AbstractThermocouple *const partialMap[2] = { &k, NULL };
+	ThermocoupleScanner<2> partial(partialMap);
+	float partialIn[2] = { 1.0f, 1.0f }, partialOut[2];
+	uint8_t partialStatus[2];
+	frameBits = frameBits && (TC_STATUS_OK == partial.scan(partialIn, 25.0f, partialOut, partialStatus)) &&
+		(TC_STATUS_OK == partialStatus[0]) && ((TC_STATUS_UNUSED | TC_STATUS_OUT_OF_RANGE) == partialStatus[1]) &&
+		((float)TC_OUT_OF_RANGE_TEMPERATURE == partialOut[1]);
+	benchCompare("ThermocoupleScanner::scan", "K/J/T", expected, out);
+	benchCompare("ThermocoupleScanner::scan status", "K/J/T", expectedStatus, status);
+	if (!frameBits)
+	{
+		fprintf(stderr, "Type K/J/T: ThermocoupleScanner::scan status differs from the channels' bits\n");
+		failures++;
+	}
+}
+
+#define BENCH_RING_CAPACITY 256
+#define BENCH_RING_BATCH 32
+
+// Records pushed a ring's worth at a time and drained in batches, against
+// getTemperature() on each record - the cost of the hand-off and grouping
+static void benchRing(TypeK &k, TypeJ &j, TypeT &t, std::mt19937_64 &rng)
+{
+	AbstractThermocouple *map[BENCH_SCAN_CHANNELS];
+	static ThermocoupleRing<BENCH_RING_CAPACITY> ring;
+	static ThermocoupleRingConverter<BENCH_SCAN_CHANNELS, BENCH_RING_BATCH> converter;
+	const size_t n = options.samples;
+	std::vector<float> mv(n), Tcj(n), out(n), expected(n);
+	std::vector<uint8_t> channel(n), status(n);
+	std::vector<ThermocoupleSample<float> > samples(n);
+	std::uniform_real_distribution<double> mvDist(0.0, 20.0), cjDist(15.0, 35.0);
+
+	for (uint8_t ch = 0; ch < BENCH_SCAN_CHANNELS; ch++)
+		map[ch] = (0 == ch % 3) ? (AbstractThermocouple *)&k : (1 == ch % 3) ? (AbstractThermocouple *)&j : (AbstractThermocouple *)&t;
+	converter.setChannels(map);
+	for (size_t i = 0; i < n; i++)
+	{
+		mv[i] = (float)mvDist(rng);
+		Tcj[i] = (float)cjDist(rng);
+		channel[i] = (uint8_t)(i % BENCH_SCAN_CHANNELS);
+	}
+
+	auto pushAndDrain = [&]() {
+		size_t pushed = 0, drained = 0;
+		while (drained < n)
+		{
+			while (pushed < n && ring.push(channel[pushed], mv[pushed], Tcj[pushed]))
+				pushed++;
+			while (ring.available() > 0)
+				drained += converter.drain(ring, &samples[drained], &out[drained], &status[drained]);
+		}
+	};
+
+	benchRun("ThermocoupleRing push + drain", "K/J/T", -1, "float", "random", n, [&]() {
+		pushAndDrain();
+		benchClobber(out.data());
+	});
+	benchRun("getTemperature (ring order)", "K/J/T", -1, "float", "random", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+			expected[i] = map[channel[i]]->getTemperature(mv[i], Tcj[i]);
+		benchClobber(expected.data());
+	});
+
+	pushAndDrain();
+	for (size_t i = 0; i < n; i++)
+		expected[i] = map[channel[i]]->getTemperature(mv[i], Tcj[i]);
+	benchCompare("ThermocoupleRingConverter::drain", "K/J/T", expected, out);
+}
+
+// A small ring, so the producer thread keeps finding it full and both
+// indices wrap many times
+#define BENCH_RING_THREAD_CAPACITY 64
+
+// A producer thread pushing records while this one drains them - the
+// hand-off the ring is for.  Every record has to come out once, in order,
+// and convert as getTemperature() does.  make -C extras tsan runs it under
+// ThreadSanitizer.
+static void benchRingThreads(TypeK &k, TypeJ &j, TypeT &t, std::mt19937_64 &rng)
+{
+	AbstractThermocouple *map[BENCH_SCAN_CHANNELS];
+	static ThermocoupleRing<BENCH_RING_THREAD_CAPACITY> ring;
+	static ThermocoupleRingConverter<BENCH_SCAN_CHANNELS, BENCH_RING_BATCH> converter;
+	const size_t n = options.samples;
+	std::vector<float> mv(n), Tcj(n), out(n), expected(n);
+	std::vector<uint8_t> channel(n), status(n);
+	std::vector<ThermocoupleSample<float> > samples(n);
+	std::uniform_real_distribution<double> mvDist(0.0, 20.0), cjDist(15.0, 35.0);
+	size_t lost = 0, misordered = 0, i;
+
+	for (uint8_t ch = 0; ch < BENCH_SCAN_CHANNELS; ch++)
+		map[ch] = (0 == ch % 3) ? (AbstractThermocouple *)&k : (1 == ch % 3) ? (AbstractThermocouple *)&j : (AbstractThermocouple *)&t;
+	converter.setChannels(map);
+	for (i = 0; i < n; i++)
+	{
+		mv[i] = (float)mvDist(rng);
+		Tcj[i] = (float)cjDist(rng);
+		channel[i] = (uint8_t)(i % BENCH_SCAN_CHANNELS);
+	}
+
+	auto handOff = [&]() {
+		size_t drained = 0;
+		ring.reset();
+		std::thread producer([&]() {
+			for (size_t p = 0; p < n; )
+			{
+				if (ring.push(channel[p], mv[p], Tcj[p]))
+					p++;
+				else
+					std::this_thread::yield();
+			}
+		});
+		while (drained < n)
+		{
+			uint16_t popped = converter.drain(ring, &samples[drained], &out[drained], &status[drained]);
+			if (0 == popped)
+				std::this_thread::yield();
+			drained += popped;
+		}
+		producer.join();
+		// Anything left would have been pushed twice
+		lost += ring.available();
+	};
+
+	benchRun("ThermocoupleRing two threads", "K/J/T", -1, "float", "random", n, [&]() {
+		handOff();
+		benchClobber(out.data());
+	});
+
+	handOff();
+	for (i = 0; i < n; i++)
+	{
+		if (samples[i].millivolts != mv[i] || samples[i].Tcj != Tcj[i] || samples[i].channel != channel[i])
+			misordered++;
+		expected[i] = map[channel[i]]->getTemperature(mv[i], Tcj[i]);
+	}
+	if (0 != lost || 0 != misordered)
+	{
+		fprintf(stderr, "Type K/J/T: ThermocoupleRing lost or reordered %zu records between threads\n", lost + misordered);
+		failures++;
+	}
+	benchCompare("ThermocoupleRing two threads", "K/J/T", expected, out);
+}
+
+/*********************************************************************************************************
+Alarms - high and low limits on the scanner's rack, checked on the raw readings
+*********************************************************************************************************/
+
+#define BENCH_ALARM_LOW 100.0
+#define BENCH_ALARM_HIGH 300.0
+#define BENCH_ALARM_HYSTERESIS 2.0
+// Readings this close (C) to a threshold may go either way
+#define BENCH_ALARM_MARGIN 0.05
+
+static bool benchNearAlarmThreshold(float temperature)
+{
+	const double threshold[4] = { BENCH_ALARM_LOW, BENCH_ALARM_LOW + BENCH_ALARM_HYSTERESIS, BENCH_ALARM_HIGH - BENCH_ALARM_HYSTERESIS, BENCH_ALARM_HIGH };
+
+	for (int i = 0; i < 4; i++)
+		if (fabs(temperature - threshold[i]) < BENCH_ALARM_MARGIN)
+			return true;
+	return false;
+}
+
+// Each reading's alarm state against the same limits applied to its
+// temperature, starting from the state the alarm had before it
+static int benchAlarmMismatches(const std::vector<float> &temperatures, const std::vector<uint8_t> &states)
+{
+	int mismatches = 0;
+
+	for (size_t i = BENCH_SCAN_CHANNELS; i < temperatures.size(); i++)
+	{
+		uint8_t previous = states[i - BENCH_SCAN_CHANNELS];
+		float t = temperatures[i];
+		bool high = (previous & TC_ALARM_HIGH) ? !(t < BENCH_ALARM_HIGH - BENCH_ALARM_HYSTERESIS) : (t > BENCH_ALARM_HIGH);
+		bool low = (previous & TC_ALARM_LOW) ? !(t > BENCH_ALARM_LOW + BENCH_ALARM_HYSTERESIS) : (t < BENCH_ALARM_LOW);
+		uint8_t expected = (high ? TC_ALARM_HIGH : 0) | (low ? TC_ALARM_LOW : 0);
+
+		if (expected != states[i] && !benchNearAlarmThreshold(t))
+			mismatches++;
+	}
+	return mismatches;
+}
+
+static void benchAlarm(TypeK &k, TypeJ &j, TypeT &t, std::mt19937_64 &rng)
+{
+	static const ThermocoupleAlarmLimits limitsK = tcAlarmLimits<ThermocoupleType::K>(BENCH_ALARM_LOW, BENCH_ALARM_HIGH, BENCH_ALARM_HYSTERESIS);
+	static const ThermocoupleAlarmLimits limitsJ = tcAlarmLimits<ThermocoupleType::J>(BENCH_ALARM_LOW, BENCH_ALARM_HIGH, BENCH_ALARM_HYSTERESIS);
+	static const ThermocoupleAlarmLimits limitsT = tcAlarmLimits<ThermocoupleType::T>(BENCH_ALARM_LOW, BENCH_ALARM_HIGH, BENCH_ALARM_HYSTERESIS);
+	const ThermocoupleAdcScale scale = { 2048.0, 1.0, 0, 16777216 };
+	static ThermocoupleAlarm<BENCH_SCAN_CHANNELS> alarm;
+	static ThermocoupleAlarm<BENCH_SCAN_CHANNELS, int32_t> codeAlarm;
+	AbstractThermocouple *map[BENCH_SCAN_CHANNELS];
+	const int frames = (int)(options.samples / BENCH_SCAN_CHANNELS) + 1;
+	const size_t n = (size_t)frames * BENCH_SCAN_CHANNELS;
+	std::vector<float> mv(n), temperatures(n);
+	std::vector<int32_t> codes(n);
+	std::vector<uint8_t> states(n), codeStates(n), limitStates(n);
+	// Within every type's range - past it the alarms follow the voltage, where
+	// the temperatures read TC_OUT_OF_RANGE
+	std::uniform_real_distribution<double> mvDist(0.0, 15.0);
+
+	for (uint8_t ch = 0; ch < BENCH_SCAN_CHANNELS; ch++)
+	{
+		map[ch] = (0 == ch % 3) ? (AbstractThermocouple *)&k : (1 == ch % 3) ? (AbstractThermocouple *)&j : (AbstractThermocouple *)&t;
+		const ThermocoupleAlarmLimits &limits = (0 == ch % 3) ? limitsK : (1 == ch % 3) ? limitsJ : limitsT;
+		alarm.setChannel(ch, map[ch], limits);
+		codeAlarm.setChannel(ch, map[ch], limits);
+	}
+	codeAlarm.setScale(scale);
+	alarm.setColdJunction(25.0);
+	codeAlarm.setColdJunction(25.0);
+	for (size_t i = 0; i < n; i++)
+	{
+		codes[i] = (int32_t)lrint(mvDist(rng) * scale.fullScale / scale.referenceMillivolts);
+		mv[i] = (float)(codes[i] * scale.referenceMillivolts / scale.fullScale);
+	}
+
+	benchRun("ThermocoupleAlarm::check", "K/J/T", -1, "float", "random", n, [&]() {
+		for (int f = 0; f < frames; f++)
+			alarm.check(&mv[f * BENCH_SCAN_CHANNELS], &states[f * BENCH_SCAN_CHANNELS]);
+		benchClobber(states.data());
+	});
+	benchRun("ThermocoupleAlarm::check (codes)", "K/J/T", -1, "int32", "random", n, [&]() {
+		for (int f = 0; f < frames; f++)
+			codeAlarm.check(&codes[f * BENCH_SCAN_CHANNELS], &codeStates[f * BENCH_SCAN_CHANNELS]);
+		benchClobber(codeStates.data());
+	});
+	benchRun("getTemperature + limits", "K/J/T", -1, "float", "random", n, [&]() {
+		for (size_t i = 0; i < n; i++)
+		{
+			float temperature = map[i % BENCH_SCAN_CHANNELS]->getTemperature(mv[i], 25.0f);
+			limitStates[i] = (temperature > BENCH_ALARM_HIGH ? TC_ALARM_HIGH : 0) | (temperature < BENCH_ALARM_LOW ? TC_ALARM_LOW : 0);
+		}
+		benchClobber(limitStates.data());
+	});
+
+	alarm.reset();
+	codeAlarm.reset();
+	for (int f = 0; f < frames; f++)
+	{
+		alarm.check(&mv[f * BENCH_SCAN_CHANNELS], &states[f * BENCH_SCAN_CHANNELS]);
+		codeAlarm.check(&codes[f * BENCH_SCAN_CHANNELS], &codeStates[f * BENCH_SCAN_CHANNELS]);
+	}
+	for (size_t i = 0; i < n; i++)
+		temperatures[i] = map[i % BENCH_SCAN_CHANNELS]->getTemperature(mv[i], 25.0f);
+	if (0 != benchAlarmMismatches(temperatures, states) || 0 != benchAlarmMismatches(temperatures, codeStates))
+	{
+		fprintf(stderr, "Type K/J/T: ThermocoupleAlarm states differ from limits on the temperatures\n");
+		failures++;
+	}
+}
+
+/*********************************************************************************************************
+Filters - each stage, a chain and tcFilterBlock() on noisy millivolts, against direct computations
+*********************************************************************************************************/
+
+#define BENCH_FILTER_AVERAGE 8
+#define BENCH_FILTER_RATE 16
+#define BENCH_FILTER_MEDIAN 5
+#define BENCH_FILTER_ALPHA 0.125f
+// Every this many readings is a spike, and every BENCH_FILTER_NAN a NaN
+#define BENCH_FILTER_SPIKE 37
+#define BENCH_FILTER_NAN 101
+// Float rounding allowed in the averages (mV)
+#define BENCH_FILTER_TOLERANCE 0.00001
+
+// Mean of in[i - width + 1..i], over fewer at the start
+static std::vector<double> benchMovingAverage(const std::vector<double> &in, size_t width)
+{
+	std::vector<double> out(in.size());
+
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		size_t first = (i + 1 > width) ? i + 1 - width : 0;
+		double sum = 0.0;
+		for (size_t k = first; k <= i; k++)
+			sum += in[k];
+		out[i] = sum / (double)(i + 1 - first);
+	}
+	return out;
+}
+
+static int benchFilterMismatches(const std::vector<double> &expected, const std::vector<float> &actual, double tolerance)
+{
+	int mismatches = (expected.size() != actual.size()) ? 1 : 0;
+
+	for (size_t i = 0; i < expected.size() && i < actual.size(); i++)
+		if (!(fabs(expected[i] - actual[i]) <= tolerance) && !(std::isnan(expected[i]) && std::isnan(actual[i])))
+			mismatches++;
+	return mismatches;
+}
+
+static void benchFilter(std::mt19937_64 &rng)
+{
+	typedef ThermocoupleMovingAverage<BENCH_FILTER_AVERAGE> Average;
+	typedef ThermocoupleDecimator<BENCH_FILTER_RATE, 2> Decimator;
+	typedef ThermocoupleRunningMedian<BENCH_FILTER_MEDIAN> Median;
+	typedef ThermocoupleFilterChain<Median, Decimator> Chain;
+	static Average average;
+	static Decimator decimator;
+	static Median median;
+	static ThermocoupleExponentialFilter<> exponential(BENCH_FILTER_ALPHA);
+	static Chain chain, blockChain;
+	const size_t n = options.samples;
+	std::vector<float> mv(n), clean(n), out(n), chained(n);
+	std::vector<double> expected, window;
+	std::normal_distribution<double> noise(0.0, 0.005);
+	size_t outputs = 0, i;
+	int mismatches = 0;
+
+	// A slow ramp with noise and spikes, and NaNs for the stages that hold them off
+	for (i = 0; i < n; i++)
+	{
+		clean[i] = (float)(10.0 + 5.0 * i / n + noise(rng) + ((0 == i % BENCH_FILTER_SPIKE) ? 2.0 : 0.0));
+		mv[i] = (BENCH_FILTER_NAN - 1 == i % BENCH_FILTER_NAN) ? NAN : clean[i];
+	}
+
+	benchRun("ThermocoupleMovingAverage<8>", "mV", -1, "float", "drift", n, [&]() {
+		tcFilterBlock(average, clean.data(), n, out.data());
+		benchClobber(out.data());
+	});
+	benchRun("ThermocoupleDecimator<16, 2>", "mV", -1, "float", "drift", n, [&]() {
+		tcFilterBlock(decimator, clean.data(), n, out.data());
+		benchClobber(out.data());
+	});
+	benchRun("ThermocoupleRunningMedian<5>", "mV", -1, "float", "drift", n, [&]() {
+		tcFilterBlock(median, mv.data(), n, out.data());
+		benchClobber(out.data());
+	});
+	benchRun("ThermocoupleExponentialFilter", "mV", -1, "float", "drift", n, [&]() {
+		tcFilterBlock(exponential, mv.data(), n, out.data());
+		benchClobber(out.data());
+	});
+	benchRun("ThermocoupleFilterChain (med+dec)", "mV", -1, "float", "drift", n, [&]() {
+		tcFilterBlock(chain, mv.data(), n, out.data());
+		benchClobber(out.data());
+	});
+
+	// Moving average
+	std::vector<double> in(clean.begin(), clean.end());
+	average.reset();
+	out.resize(tcFilterBlock(average, clean.data(), n, out.data()));
+	mismatches += benchFilterMismatches(benchMovingAverage(in, BENCH_FILTER_AVERAGE), out, BENCH_FILTER_TOLERANCE);
+
+	// Decimator - two cascaded averages, every BENCH_FILTER_RATEth output
+	std::vector<double> twice = benchMovingAverage(benchMovingAverage(in, BENCH_FILTER_RATE), BENCH_FILTER_RATE);
+	expected.clear();
+	for (i = BENCH_FILTER_RATE - 1; i < n; i += BENCH_FILTER_RATE)
+		expected.push_back(twice[i]);
+	out.resize(n);
+	decimator.reset();
+	out.resize(tcFilterBlock(decimator, clean.data(), n, out.data()));
+	mismatches += benchFilterMismatches(expected, out, BENCH_FILTER_TOLERANCE);
+
+	// Median of the last few readings that weren't NaN, held over a NaN
+	expected.assign(n, NAN);
+	for (i = 0; i < n; i++)
+	{
+		if (std::isnan(mv[i]))
+		{
+			expected[i] = (i > 0) ? expected[i - 1] : NAN;
+			continue;
+		}
+		window.push_back(mv[i]);
+		if (window.size() > BENCH_FILTER_MEDIAN)
+			window.erase(window.begin());
+		std::vector<double> sorted(window);
+		std::sort(sorted.begin(), sorted.end());
+		size_t m = sorted.size();
+		expected[i] = (m & 1) ? sorted[m / 2] : (double)(((float)sorted[m / 2 - 1] + (float)sorted[m / 2]) / 2.0f);
+	}
+	out.resize(n);
+	median.reset();
+	out.resize(tcFilterBlock(median, mv.data(), n, out.data()));
+	mismatches += benchFilterMismatches(expected, out, 0.0);
+
+	// Exponential filter, held over a NaN
+	float state = 0.0f;
+	bool primed = false;
+	for (i = 0; i < n; i++)
+	{
+		if (!std::isnan(mv[i]))
+		{
+			state = primed ? state + BENCH_FILTER_ALPHA * (mv[i] - state) : mv[i];
+			primed = true;
+		}
+		expected[i] = primed ? state : NAN;
+	}
+	out.resize(n);
+	exponential.reset();
+	out.resize(tcFilterBlock(exponential, mv.data(), n, out.data()));
+	mismatches += benchFilterMismatches(expected, out, 0.0);
+
+	// The chain pushed one reading at a time, and through tcFilterBlock() in place
+	chain.reset();
+	for (i = 0; i < n; i++)
+		outputs += chain.push(mv[i], &chained[outputs]);
+	chained.resize(outputs);
+	out.assign(mv.begin(), mv.end());
+	blockChain.reset();
+	out.resize(tcFilterBlock(blockChain, out.data(), n, out.data()));
+	if (outputs != n / BENCH_FILTER_RATE || out != chained)
+		mismatches++;
+
+	if (0 != mismatches)
+	{
+		fprintf(stderr, "Filters: %d outputs differ from direct computation\n", mismatches);
+		failures++;
+	}
+}
+
+/*********************************************************************************************************
+Output
+*********************************************************************************************************/
+
+static void printJson()
+{
+	printf("{\n");
+	printf("  \"library\": \"arduino-thermocouple\",\n");
+#if defined(__VERSION__)
+	printf("  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+	printf("  \"kernel\": \"%s\",\n", BENCH_KERNEL);
+	printf("  \"samples\": %zu,\n  \"passes\": %d,\n  \"repeats\": %d,\n", options.samples, options.passes, options.repeats);
+	printf("  \"failures\": %d,\n", failures);
+	printf("  \"results\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult &r = results[i];
+		printf("    { \"name\": \"%s\", \"type\": \"%s\", ", r.name.c_str(), r.type.c_str());
+		if (r.segment < 0)
+			printf("\"segment\": null, ");
+		else
+			printf("\"segment\": %d, ", r.segment + 1);
+		printf("\"precision\": \"%s\", \"input\": \"%s\", \"ns_per_sample\": %.3f, \"samples_per_second\": %.0f }%s\n",
+			r.precision, r.input, r.nsPerSample, 1.0e9 / r.nsPerSample, (i + 1 < results.size()) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+#if defined(TC_PROFILE)
+// Upper end of the histogram bucket holding the median call
+static uint32_t profileMedian(const ThermocoupleProfileTimes &times)
+{
+	uint32_t seen = 0;
+	for (uint8_t i = 0; i < TC_PROFILE_BUCKETS; i++)
+	{
+		seen += times.histogram[i];
+		if (2 * seen >= times.calls)
+			return (2UL << i) - 1;
+	}
+	return 0;
+}
+
+// What the library's counters saw over the whole run, and a check that an
+// exported snapshot is the size it says
+static void printProfile()
+{
+	static const char *types[] = { "B", "E", "J", "K", "N", "R", "S", "T" };
+	static const char *clocks[] = { "none", "cycles", "tsc", "ns", "us" };
+	uint8_t buffer[TC_PROFILE_SIZE];
+
+	printf("\nProfile - median call in %s, rounded up to a power of two less one\n", clocks[tcProfileClock()]);
+	printf("%-4s %14s %8s %14s %8s %14s %8s %10s %10s  %s\n", "type", "getTemperature", "median", "computeTemp", "median", "coldJunction", "median", "under", "over", "per segment");
+	for (uint8_t t = 0; t < 8; t++)
+	{
+		ThermocoupleProfile profile;
+		if (!tcProfileSnapshot((ThermocoupleType)t, &profile))
+			continue;
+		if (TC_PROFILE_SIZE != tcProfileExport((ThermocoupleType)t, profile, buffer))
+		{
+			fprintf(stderr, "Type %s: exported profile isn't TC_PROFILE_SIZE bytes\n", types[t]);
+			failures++;
+		}
+		printf("%-4s %14lu %8lu %14lu %8lu %14lu %8lu %10lu %10lu ", types[t],
+			(unsigned long)profile.conversion.calls, (unsigned long)profileMedian(profile.conversion),
+			(unsigned long)profile.temperature.calls, (unsigned long)profileMedian(profile.temperature),
+			(unsigned long)profile.coldJunction.calls, (unsigned long)profileMedian(profile.coldJunction),
+			(unsigned long)profile.underRange, (unsigned long)profile.overRange);
+		uint8_t used = TC_MAX_SEGMENTS;
+		while (used > 1 && 0 == profile.segmentCalls[used - 1])
+			used--;
+		for (uint8_t seg = 0; seg < used; seg++)
+			printf(" %lu", (unsigned long)profile.segmentCalls[seg]);
+		printf("\n");
+	}
+}
+#endif
+
+static TypeB typeB;
+static TypeE typeE;
+static TypeJ typeJ;
+static TypeK typeK;
+static TypeN typeN;
+static TypeR typeR;
+static TypeS typeS;
+static TypeT typeT;
+
+int main(int argc, char **argv)
+{
+	std::mt19937_64 rng(1);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "--json"))
+			options.json = true;
+		else if (0 == strcmp(argv[i], "--samples") && i + 1 < argc)
+			options.samples = strtoul(argv[++i], NULL, 0);
+		else if (0 == strcmp(argv[i], "--passes") && i + 1 < argc)
+			options.passes = atoi(argv[++i]);
+		else if (0 == strcmp(argv[i], "--repeats") && i + 1 < argc)
+			options.repeats = atoi(argv[++i]);
+		else if (0 == strcmp(argv[i], "--filter") && i + 1 < argc)
+			options.filter = argv[++i];
+		else
+		{
+			fprintf(stderr, "usage: %s [--json] [--samples N] [--passes N] [--repeats N] [--filter text]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (0 == options.samples || options.passes < 1 || options.repeats < 1)
+	{
+		fprintf(stderr, "samples, passes and repeats must be at least 1\n");
+		return 2;
+	}
+
+	if (!options.json)
+	{
+		printf("Kernel: %s, %zu samples x %d passes, best of %d\n\n", BENCH_KERNEL, options.samples, options.passes, options.repeats);
+		printf("%-34s %-6s %-4s %-7s %-7s %9s %10s\n", "benchmark", "type", "seg", "prec", "input", "ns/sample", "Msample/s");
+	}
+
+#if defined(TC_PROFILE)
+	tcProfileReset();
+#endif
+	benchType("B", typeB, rng);
+	benchType("E", typeE, rng);
+	benchType("J", typeJ, rng);
+	benchType("K", typeK, rng);
+	benchType("N", typeN, rng);
+	benchType("R", typeR, rng);
+	benchType("S", typeS, rng);
+	benchType("T", typeT, rng);
+	benchScanner(typeK, typeJ, typeT, rng);
+	benchRing(typeK, typeJ, typeT, rng);
+	benchRingThreads(typeK, typeJ, typeT, rng);
+	benchAlarm(typeK, typeJ, typeT, rng);
+	benchFilter(rng);
+
+#if defined(TC_PROFILE)
+	if (!options.json)
+		printProfile();
+#endif
+	if (options.json)
+		printJson();
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library - footprint probe
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     footprint.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    A minimal program that converts one reading with every TypeX class the
+    library was built with (see TC_SELECT_TYPES), so that its size is what
+    those types cost a sketch.  Built and measured by footprint.sh - with
+    no types selected it's the empty baseline the others are compared to.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include "Thermocouple.h"
+
+#if defined(__AVR__)
+// Normally supplied by the Arduino core
+extern "C" void __cxa_pure_virtual() { while (1); }
+#endif
+
+// volatile, so nothing is folded away at compile time
+volatile float millivolts;
+volatile float Tcj;
+volatile float temperature;
+
+#if TC_TYPE_B
+static TypeB typeB;
+#endif
+#if TC_TYPE_E
+static TypeE typeE;
+#endif
+#if TC_TYPE_J
+static TypeJ typeJ;
+#endif
+#if TC_TYPE_K
+static TypeK typeK;
+#endif
+#if TC_TYPE_N
+static TypeN typeN;
+#endif
+#if TC_TYPE_R
+static TypeR typeR;
+#endif
+#if TC_TYPE_S
+static TypeS typeS;
+#endif
+#if TC_TYPE_T
+static TypeT typeT;
+#endif
+
+// Through the base class, as a sketch handling several types would
+static void convert(AbstractThermocouple *tc)
+{
+	temperature = tc->getTemperature((float)millivolts, (float)Tcj);
+}
+
+int main()
+{
+#if TC_TYPE_B
+	convert(&typeB);
+#endif
+#if TC_TYPE_E
+	convert(&typeE);
+#endif
+#if TC_TYPE_J
+	convert(&typeJ);
+#endif
+#if TC_TYPE_K
+	convert(&typeK);
+#endif
+#if TC_TYPE_N
+	convert(&typeN);
+#endif
+#if TC_TYPE_R
+	convert(&typeR);
+#endif
+#if TC_TYPE_S
+	convert(&typeS);
+#endif
+#if TC_TYPE_T
+	convert(&typeT);
+#endif
+	return 0;
+}
@@ -0,0 +1,83 @@
+#!/bin/sh
+#*************************************************************************
+# Title:    Thermocouple Direct Measurement Library - footprint report
+# Authors:  Nathan D. Holmes <maverick@drgw.net>
+# Authors:  Michael D. Petersen <railfan@drgw.net>
+# File:     footprint.sh
+# License:  GNU General Public License v3
+#
+# ABOUT:
+#   Builds footprint.cpp against the library once per configuration and
+#   reports its flash and RAM use, and what that adds to an empty program.
+#   A configuration is the build flags that select types and segments, e.g.
+#     "-DTC_SELECT_TYPES -DTC_TYPE_K -DTC_TYPE_K_MIN=0 -DTC_TYPE_K_MAX=500"
+#   From the library root:
+#     extras/footprint/footprint.sh                  the standard set
+#     extras/footprint/footprint.sh "FLAGS" ...      your own configurations
+#   or make -C extras footprint.
+#
+#   Defaults to avr-g++ for an ATmega328P with the Arduino core's flags.
+#   Override CXX, SIZE, MCU or TARGETFLAGS for another target, e.g. for the
+#   host (flash and RAM are then text+data and data+bss):
+#     CXX=g++ SIZE=size TARGETFLAGS=-DTC_FLASH_TABLES extras/footprint/footprint.sh
+#
+# LICENSE:
+#   Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 3 of the License, or
+#   any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#*************************************************************************
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC="$HERE/../../src"
+BUILD=${BUILD:-"$HERE/../build/footprint"}
+CXX=${CXX:-avr-g++}
+SIZE=${SIZE:-avr-size}
+MCU=${MCU:-atmega328p}
+TARGETFLAGS=${TARGETFLAGS-"-mmcu=$MCU -DF_CPU=16000000L"}
+# As the Arduino AVR core compiles and links a sketch
+FLAGS="-Os -std=gnu++11 -fno-exceptions -fno-threadsafe-statics -ffunction-sections -fdata-sections -flto -Wl,--gc-sections"
+
+if ! command -v "$CXX" >/dev/null 2>&1; then
+	echo "$CXX not found - set CXX and SIZE (see the top of $0)" >&2
+	exit 1
+fi
+
+if [ $# -eq 0 ]; then
+	set -- \
+		"-DTC_SELECT_TYPES -DTC_TYPE_K" \
+		"-DTC_SELECT_TYPES -DTC_TYPE_K -DTC_TYPE_K_MIN=0 -DTC_TYPE_K_MAX=500" \
+		"-DTC_SELECT_TYPES -DTC_TYPE_K -DTC_TYPE_K_POLYNOMIAL=1" \
+		"-DTC_SELECT_TYPES -DTC_TYPE_J -DTC_TYPE_K" \
+		"-DTC_SELECT_TYPES -DTC_TYPE_T -DTC_TYPE_T_MIN=-50 -DTC_TYPE_T_MAX=150" \
+		""
+fi
+
+mkdir -p "$BUILD" || exit 1
+
+# Prints "flash ram" for one configuration
+measure()
+{
+	$CXX $FLAGS $TARGETFLAGS $1 -I"$SRC" "$HERE/footprint.cpp" "$SRC/Thermocouple.cpp" "$SRC/ThermocoupleBatch.cpp" -o "$BUILD/footprint" || return 1
+	$SIZE "$BUILD/footprint" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+}
+
+base=$(measure "-DTC_SELECT_TYPES") || exit 1
+base_flash=${base% *}
+base_ram=${base#* }
+
+printf "%-72s %7s %7s %7s %7s\n" "configuration" "flash" "RAM" "+flash" "+RAM"
+printf "%-72s %7s %7s\n" "(empty program)" "$base_flash" "$base_ram"
+for config in "$@"; do
+	result=$(measure "$config") || exit 1
+	flash=${result% *}
+	ram=${result#* }
+	printf "%-72s %7s %7s %7s %7s\n" "${config:-all types}" "$flash" "$ram" $((flash - base_flash)) $((ram - base_ram))
+done
@@ -0,0 +1,153 @@
+/*************************************************************************
+Title:    NIST ITS-90 Thermocouple Reference Functions
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     nist_its90.h
+License:  GNU General Public License v3
+
+ABOUT:
+    The NIST ITS-90 reference functions E(t) for the eight letter
+    designated thermocouple types, from NIST Monograph 175.  Temperature
+    is in degrees C, voltage in millivolts.  These are the polynomials the
+    published tables are generated from; the library's own rational fits
+    are checked and generated against them by the host tools in extras.
+
+    Host only - not part of the Arduino library.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _NIST_ITS90_H_
+#define _NIST_ITS90_H_
+
+#include <math.h>
+
+// One polynomial range of a reference function, valid for lo <= t <= hi
+struct NistRange
+{
+	double lo;
+	double hi;
+	int terms;
+	double c[15];
+};
+
+struct NistReference
+{
+	const char *name;
+	int ranges;
+	NistRange range[3];
+	// Type K adds a0 * exp(a1 * (t - a2)^2) above 0C
+	double a[3];
+};
+
+static const NistReference nistReference[] =
+{
+	{ "B", 2, {
+		{ 0.0, 630.615, 7, { 0.000000000000E+00, -0.246508183460E-03, 0.590404211710E-05, -0.132579316360E-08, 0.156682919010E-11, -0.169445292400E-14, 0.629903470940E-18 } },
+		{ 630.615, 1820.0, 9, { -0.389381686210E+01, 0.285717474700E-01, -0.848851047850E-04, 0.157852801640E-06, -0.168353448640E-09, 0.111097940130E-12, -0.445154310330E-16, 0.989756408210E-20, -0.937913302890E-24 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "E", 2, {
+		{ -270.0, 0.0, 14, { 0.000000000000E+00, 0.586655087080E-01, 0.454109771240E-04, -0.779980486860E-06, -0.258001608430E-07, -0.594525830570E-09, -0.932140586670E-11, -0.102876055340E-12, -0.803701236210E-15, -0.439794973910E-17, -0.164147763550E-19, -0.396736195160E-22, -0.558273287210E-25, -0.346578420130E-28 } },
+		{ 0.0, 1000.0, 11, { 0.000000000000E+00, 0.586655087100E-01, 0.450322755820E-04, 0.289084072120E-07, -0.330568966520E-09, 0.650244032700E-12, -0.191974955040E-15, -0.125366004970E-17, 0.214892175690E-20, -0.143880417820E-23, 0.359608994810E-27 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "J", 2, {
+		{ -210.0, 760.0, 9, { 0.000000000000E+00, 0.503811878150E-01, 0.304758369300E-04, -0.856810657200E-07, 0.132281952950E-09, -0.170529583370E-12, 0.209480906970E-15, -0.125383953360E-18, 0.156317256970E-22 } },
+		{ 760.0, 1200.0, 6, { 0.296456256810E+03, -0.149761277860E+01, 0.317871039240E-02, -0.318476867010E-05, 0.157208190040E-08, -0.306913690560E-12 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "K", 2, {
+		{ -270.0, 0.0, 11, { 0.000000000000E+00, 0.394501280250E-01, 0.236223735980E-04, -0.328589067840E-06, -0.499048287770E-08, -0.675090591730E-10, -0.574103274280E-12, -0.310888728940E-14, -0.104516093650E-16, -0.198892668780E-19, -0.163226974860E-22 } },
+		{ 0.0, 1372.0, 10, { -0.176004136860E-01, 0.389212049750E-01, 0.185587700320E-04, -0.994575928740E-07, 0.318409457190E-09, -0.560728448890E-12, 0.560750590590E-15, -0.320207200030E-18, 0.971511471520E-22, -0.121047212750E-25 } },
+	}, { 0.118597600000E+00, -0.118343200000E-03, 0.126968600000E+03 } },
+	{ "N", 2, {
+		{ -270.0, 0.0, 9, { 0.000000000000E+00, 0.261591059620E-01, 0.109574842280E-04, -0.938411115540E-07, -0.464120397590E-10, -0.263033577160E-11, -0.226534380030E-13, -0.760893007910E-16, -0.934196678350E-19 } },
+		{ 0.0, 1300.0, 11, { 0.000000000000E+00, 0.259293946010E-01, 0.157101418800E-04, 0.438256272370E-07, -0.252611697940E-09, 0.643118193390E-12, -0.100634715190E-14, 0.997453389920E-18, -0.608632456070E-21, 0.208492293390E-24, -0.306821961510E-28 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "R", 3, {
+		{ -50.0, 1064.18, 10, { 0.000000000000E+00, 0.528961729765E-02, 0.139166589782E-04, -0.238855693017E-07, 0.356916001063E-10, -0.462347666298E-13, 0.500777441034E-16, -0.373105886191E-19, 0.157716482367E-22, -0.281038625251E-26 } },
+		{ 1064.18, 1664.5, 6, { 0.295157925316E+01, -0.252061251332E-02, 0.159564501865E-04, -0.764085947576E-08, 0.205305291024E-11, -0.293359668173E-15 } },
+		{ 1664.5, 1768.1, 5, { 0.152232118209E+03, -0.268819888545E+00, 0.171280280471E-03, -0.345895706453E-07, -0.934633971046E-14 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "S", 3, {
+		{ -50.0, 1064.18, 9, { 0.000000000000E+00, 0.540313308631E-02, 0.125934289740E-04, -0.232477968689E-07, 0.322028823036E-10, -0.331465196389E-13, 0.255744251786E-16, -0.125068871393E-19, 0.271443176145E-23 } },
+		{ 1064.18, 1664.5, 5, { 0.132900444085E+01, 0.334509311344E-02, 0.654805192818E-05, -0.164856259209E-08, 0.129989605174E-13 } },
+		{ 1664.5, 1768.1, 5, { 0.146628232636E+03, -0.258430516752E+00, 0.163693574641E-03, -0.330439046987E-07, -0.943223690612E-14 } },
+	}, { 0.0, 0.0, 0.0 } },
+	{ "T", 2, {
+		{ -270.0, 0.0, 15, { 0.000000000000E+00, 0.387481063640E-01, 0.441944343470E-04, 0.118443231050E-06, 0.200329735540E-07, 0.901380195590E-09, 0.226511565930E-10, 0.360711542050E-12, 0.384939398830E-14, 0.282135219250E-16, 0.142515947790E-18, 0.487686622860E-21, 0.107955392700E-23, 0.139450270620E-26, 0.797951539270E-30 } },
+		{ 0.0, 400.0, 9, { 0.000000000000E+00, 0.387481063640E-01, 0.332922278800E-04, 0.206182434040E-06, -0.218822568460E-08, 0.109968809280E-10, -0.308157587720E-13, 0.454791352900E-16, -0.275129016730E-19 } },
+	}, { 0.0, 0.0, 0.0 } },
+};
+
+#define NIST_TYPES (sizeof(nistReference) / sizeof(nistReference[0]))
+
+static inline double nistMinTemperature(const NistReference *ref)
+{
+	return ref->range[0].lo;
+}
+
+static inline double nistMaxTemperature(const NistReference *ref)
+{
+	return ref->range[ref->ranges - 1].hi;
+}
+
+// Reference voltage (mV) at t (C).  t must be within the type's range.
+static inline double nistVoltage(const NistReference *ref, double t)
+{
+	int r = 0;
+	while (r < ref->ranges - 1 && t > ref->range[r].hi)
+		r++;
+
+	const NistRange *range = &ref->range[r];
+	double e = 0.0;
+	for (int i = range->terms - 1; i >= 0; i--)
+		e = e * t + range->c[i];
+	if (t > 0.0 && 0.0 != ref->a[0])
+		e += ref->a[0] * exp(ref->a[1] * (t - ref->a[2]) * (t - ref->a[2]));
+	return e;
+}
+
+// Reference Seebeck coefficient dE/dt (mV/C) at t (C)
+static inline double nistSeebeck(const NistReference *ref, double t)
+{
+	int r = 0;
+	while (r < ref->ranges - 1 && t > ref->range[r].hi)
+		r++;
+
+	const NistRange *range = &ref->range[r];
+	double s = 0.0;
+	for (int i = range->terms - 1; i >= 1; i--)
+		s = s * t + i * range->c[i];
+	if (t > 0.0 && 0.0 != ref->a[0])
+		s += ref->a[0] * exp(ref->a[1] * (t - ref->a[2]) * (t - ref->a[2])) * 2.0 * ref->a[1] * (t - ref->a[2]);
+	return s;
+}
+
+// Temperature (C) at which the reference reaches millivolts (bisection -
+// the reference rises monotonically over every inverse range)
+static inline double nistTemperature(const NistReference *ref, double millivolts)
+{
+	double lo = nistMinTemperature(ref), hi = nistMaxTemperature(ref);
+	for (int i = 0; i < 200 && hi - lo > 1e-12; i++)
+	{
+		double mid = 0.5 * (lo + hi);
+		if (nistVoltage(ref, mid) < millivolts)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return 0.5 * (lo + hi);
+}
+
+#endif
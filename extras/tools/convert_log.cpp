@@ -0,0 +1,596 @@
+/*************************************************************************
+Title:    Thermocouple Log Converter
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     convert_log.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Converts a recorded millivolt log to temperatures on every core.  The
+    input is memory-mapped and cut into chunks; worker threads convert the
+    chunks with the library's batch kernels (AVX2, SSE2 or NEON, whichever
+    the build has) while the main thread writes the finished chunks out in
+    order.  Only a few chunks per thread are held in memory at once, so
+    logs far larger than memory stream through.
+
+    The batch kernels are bit-identical to getTemperature(), so the output
+    is exactly what converting sample by sample would give.  --check
+    confirms that by also converting every sample through getTemperature()
+    and comparing.
+
+    Input, one record per sample:
+      binary  millivolts and cold junction C as native doubles (floats with
+              --float), interleaved - or millivolts only with --tcj
+      csv     "millivolts,Tcj" per line - or "millivolts" with --tcj.  Lines
+              that don't start with a number (headers, comments) are skipped.
+      log     a ThermocoupleLog.h log - the channel map gives each channel's
+              type, so TYPE is left out.  Its columns are converted in
+              place, and --from/--to pick a timestamp range, skipping the
+              blocks outside it.
+    The format comes from --csv, --binary or --log, or else the input
+    file's extension (.csv is text, .tclog a log, anything else binary).
+
+    Output is one temperature per record in the input's format: native
+    doubles (or floats), or one per line with enough digits to read back
+    exactly.  Logs give one row per sample - binary rows of a temperature
+    per channel, or "timestamp,t0,t1,..." lines if OUTPUT ends in .csv.
+    Out of range samples are TC_OUT_OF_RANGE (-1000).  OUTPUT may be - for
+    stdout.  Throughput goes to stderr.
+
+    Linux (or any POSIX system with mmap).  Built by extras/Makefile:
+      make -C extras
+      extras/build/convert_log [options] B|E|J|K|N|R|S|T INPUT OUTPUT
+      extras/build/convert_log [options] LOG OUTPUT
+        --threads N   worker threads (default: all cores)
+        --chunk N     samples per chunk (default 1048576)
+        --float       single precision input, conversion and output
+        --tcj C       one cold junction temperature for the whole log
+        --csv, --binary, --log
+        --from T, --to T   log timestamps to convert (inclusive)
+        --check       compare against per-sample getTemperature()
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Thermocouple.h"
+#include "ThermocoupleLog.h"
+
+#define CONVERT_CHUNK_SAMPLES (1 << 20)
+// Chunks in flight per worker - converted but not yet written
+#define CONVERT_CHUNKS_PER_THREAD 2
+// Longest CSV line that will be parsed
+#define CONVERT_LINE_MAX 128
+// Approximate CSV bytes per sample, for sizing text chunks
+#define CONVERT_CSV_BYTES_PER_SAMPLE 16
+
+struct ConvertOptions
+{
+	unsigned threads;
+	size_t chunk;
+	bool single;
+	bool haveTcj;
+	double Tcj;
+	bool csv;
+	bool log;
+	bool csvOutput;
+	bool check;
+	bool haveFrom;
+	bool haveTo;
+	int64_t from;
+	int64_t to;
+};
+
+struct ConvertType
+{
+	const char *name;
+	AbstractThermocouple *tc;
+};
+
+// One piece of the input and, once converted, its output
+struct ConvertChunk
+{
+	const char *begin;
+	const char *end;
+	uint32_t block;      // log input - rows [first, last) of block
+	uint32_t first;
+	uint32_t last;
+	std::string output;
+	size_t samples;
+	size_t skipped;      // CSV lines that didn't parse
+	size_t mismatches;   // --check differences from getTemperature()
+	bool done;
+};
+
+static TypeB typeB;
+static TypeE typeE;
+static TypeJ typeJ;
+static TypeK typeK;
+static TypeN typeN;
+static TypeR typeR;
+static TypeS typeS;
+static TypeT typeT;
+
+// In ThermocoupleType order
+static const ConvertType types[] =
+{
+	{ "B", &typeB },
+	{ "E", &typeE },
+	{ "J", &typeJ },
+	{ "K", &typeK },
+	{ "N", &typeN },
+	{ "R", &typeR },
+	{ "S", &typeS },
+	{ "T", &typeT },
+};
+
+static ConvertOptions options = { 0, CONVERT_CHUNK_SAMPLES, false, false, 0.0, false, false, false, false, false, false, 0, 0 };
+static ThermocoupleLogReader logReader;
+
+/*********************************************************************************************************
+Conversion
+*********************************************************************************************************/
+
+static inline double convertParse(const char *text, char **end, double) { return strtod(text, end); }
+static inline float convertParse(const char *text, char **end, float) { return strtof(text, end); }
+
+// "millivolts[,Tcj]" - returns false for lines that don't hold the numbers expected
+template<typename T> static bool convertLine(const char *begin, const char *end, T *millivolts, T *Tcj)
+{
+	char line[CONVERT_LINE_MAX];
+	char *p, *q;
+	size_t length = end - begin;
+
+	if (length >= sizeof(line))
+		return false;
+	memcpy(line, begin, length);
+	line[length] = '\0';
+
+	*millivolts = convertParse(line, &p, T());
+	if (p == line)
+		return false;
+	if (options.haveTcj)
+		return true;
+	while (' ' == *p || '\t' == *p)
+		p++;
+	if (',' == *p)
+		p++;
+	*Tcj = convertParse(p, &q, T());
+	return (q != p);
+}
+
+// Log blocks are converted straight from the mapping, a channel at a time
+template<typename T> static void convertBlock(ConvertChunk &chunk)
+{
+	const uint8_t channels = logReader.channels();
+	const size_t n = chunk.last - chunk.first;
+	const int64_t *timestamps = logReader.timestamps(chunk.block) + chunk.first;
+	const T *Tcj = logReader.coldJunction<T>(chunk.block) + chunk.first;
+	std::vector<T> temperatures(n * channels);
+
+	for (uint8_t ch = 0; ch < channels; ch++)
+	{
+		AbstractThermocouple *tc = types[(uint8_t)logReader.type(ch)].tc;
+		const T *millivolts = logReader.millivolts<T>(chunk.block, ch) + chunk.first;
+		T *column = &temperatures[ch * n];
+		tc->getTemperatures(millivolts, Tcj, column, n);
+		if (options.check)
+			for (size_t i = 0; i < n; i++)
+			{
+				T expected = tc->getTemperature(millivolts[i], Tcj[i]);
+				if (0 != memcmp(&expected, &column[i], sizeof(T)))
+					chunk.mismatches++;
+			}
+	}
+
+	if (options.csvOutput)
+	{
+		char text[32];
+		chunk.output.reserve(n * (20 + 20 * channels));
+		for (size_t i = 0; i < n; i++)
+		{
+			chunk.output.append(text, snprintf(text, sizeof(text), "%lld", (long long)timestamps[i]));
+			for (uint8_t ch = 0; ch < channels; ch++)
+				chunk.output.append(text, snprintf(text, sizeof(text), (sizeof(T) == sizeof(float)) ? ",%.9g" : ",%.17g", (double)temperatures[ch * n + i]));
+			chunk.output.push_back('\n');
+		}
+	}
+	else
+	{
+		chunk.output.resize(n * channels * sizeof(T));
+		T *row = (T *)&chunk.output[0];
+		for (size_t i = 0; i < n; i++)
+			for (uint8_t ch = 0; ch < channels; ch++)
+				*row++ = temperatures[ch * n + i];
+	}
+	chunk.samples = n * channels;
+}
+
+template<typename T> static void convertChunk(AbstractThermocouple *tc, ConvertChunk &chunk)
+{
+	std::vector<T> millivolts, Tcj, temperatures;
+
+	if (options.log)
+	{
+		convertBlock<T>(chunk);
+		return;
+	}
+
+	if (options.csv)
+	{
+		const char *line = chunk.begin;
+		while (line < chunk.end)
+		{
+			const char *newline = (const char *)memchr(line, '\n', chunk.end - line);
+			const char *next = newline ? newline + 1 : chunk.end;
+			T mv, cj = T(0);
+			if (convertLine(line, newline ? newline : chunk.end, &mv, &cj))
+			{
+				millivolts.push_back(mv);
+				Tcj.push_back(cj);
+			}
+			else
+				chunk.skipped++;
+			line = next;
+		}
+	}
+	else
+	{
+		// Copied out rather than cast in place - the mapping has no alignment guarantee
+		const size_t fields = options.haveTcj ? 1 : 2;
+		const size_t n = (chunk.end - chunk.begin) / (fields * sizeof(T));
+		millivolts.resize(n);
+		Tcj.resize(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			memcpy(&millivolts[i], chunk.begin + i * fields * sizeof(T), sizeof(T));
+			if (2 == fields)
+				memcpy(&Tcj[i], chunk.begin + (i * fields + 1) * sizeof(T), sizeof(T));
+		}
+	}
+
+	const size_t n = millivolts.size();
+	temperatures.resize(n);
+	if (options.haveTcj)
+	{
+		ThermocoupleColdJunction<T> coldJunction = tc->getColdJunction((T)options.Tcj);
+		tc->convert(coldJunction, millivolts.data(), temperatures.data(), n);
+	}
+	else
+		tc->getTemperatures(millivolts.data(), Tcj.data(), temperatures.data(), n);
+
+	if (options.check)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			T expected = tc->getTemperature(millivolts[i], options.haveTcj ? (T)options.Tcj : Tcj[i]);
+			if (0 != memcmp(&expected, &temperatures[i], sizeof(T)))
+				chunk.mismatches++;
+		}
+	}
+
+	if (options.csvOutput)
+	{
+		char text[32];
+		chunk.output.reserve(n * 20);
+		for (size_t i = 0; i < n; i++)
+		{
+			int length = snprintf(text, sizeof(text), (sizeof(T) == sizeof(float)) ? "%.9g\n" : "%.17g\n", (double)temperatures[i]);
+			chunk.output.append(text, length);
+		}
+	}
+	else
+		chunk.output.assign((const char *)temperatures.data(), n * sizeof(T));
+	chunk.samples = n;
+}
+
+/*********************************************************************************************************
+Chunking and output
+*********************************************************************************************************/
+
+// Binary chunks are whole records; text chunks end just after a newline
+static std::vector<ConvertChunk> convertSplit(const char *data, size_t size)
+{
+	std::vector<ConvertChunk> chunks;
+	const size_t record = (options.single ? sizeof(float) : sizeof(double)) * (options.haveTcj ? 1 : 2);
+	const size_t target = options.csv ? options.chunk * CONVERT_CSV_BYTES_PER_SAMPLE : options.chunk * record;
+	const char *end = data + (options.csv ? size : size - size % record);
+	const char *begin = data;
+
+	while (begin < end)
+	{
+		const char *stop = ((size_t)(end - begin) > target) ? begin + target : end;
+		if (options.csv && stop < end)
+		{
+			const char *newline = (const char *)memchr(stop, '\n', end - stop);
+			stop = newline ? newline + 1 : end;
+		}
+		ConvertChunk chunk = { begin, stop, 0, 0, 0, std::string(), 0, 0, 0, false };
+		chunks.push_back(chunk);
+		begin = stop;
+	}
+	return chunks;
+}
+
+// A chunk per log block in the --from/--to range - blocks outside it are
+// skipped on their headers alone
+static std::vector<ConvertChunk> convertSplitLog()
+{
+	std::vector<ConvertChunk> chunks;
+	uint32_t b = options.haveFrom ? logReader.find(options.from) : 0;
+
+	for (; b < logReader.blocks(); b++)
+	{
+		const ThermocoupleLogBlockHeader *block = logReader.block(b);
+		const int64_t *timestamps = logReader.timestamps(b);
+		if (options.haveTo && block->firstTimestamp > options.to)
+			break;
+		uint32_t first = options.haveFrom ? std::lower_bound(timestamps, timestamps + block->samples, options.from) - timestamps : 0;
+		uint32_t last = options.haveTo ? std::upper_bound(timestamps, timestamps + block->samples, options.to) - timestamps : block->samples;
+		if (first >= last)
+			continue;
+		ConvertChunk chunk = { NULL, NULL, b, first, last, std::string(), 0, 0, 0, false };
+		chunks.push_back(chunk);
+	}
+	return chunks;
+}
+
+static bool convertWrite(int fd, const std::string &data)
+{
+	const char *p = data.data();
+	size_t left = data.size();
+	while (left > 0)
+	{
+		ssize_t written = write(fd, p, left);
+		if (written < 0)
+			return false;
+		p += written;
+		left -= written;
+	}
+	return true;
+}
+
+static void usage(const char *program)
+{
+	fprintf(stderr, "usage: %s [--threads N] [--chunk N] [--float] [--tcj C] [--csv|--binary] [--check] B|E|J|K|N|R|S|T INPUT OUTPUT\n", program);
+	fprintf(stderr, "       %s [--threads N] [--check] [--from T] [--to T] [--log] LOG OUTPUT\n", program);
+}
+
+int main(int argc, char **argv)
+{
+	const char *positional[3];
+	int positionals = 0;
+	int format = 0;   // 0 = by extension, 1 = csv, 2 = binary, 3 = log
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "--threads") && i + 1 < argc)
+			options.threads = (unsigned)strtoul(argv[++i], NULL, 0);
+		else if (0 == strcmp(argv[i], "--chunk") && i + 1 < argc)
+			options.chunk = strtoul(argv[++i], NULL, 0);
+		else if (0 == strcmp(argv[i], "--float"))
+			options.single = true;
+		else if (0 == strcmp(argv[i], "--tcj") && i + 1 < argc)
+		{
+			options.haveTcj = true;
+			options.Tcj = atof(argv[++i]);
+		}
+		else if (0 == strcmp(argv[i], "--csv"))
+			format = 1;
+		else if (0 == strcmp(argv[i], "--binary"))
+			format = 2;
+		else if (0 == strcmp(argv[i], "--log"))
+			format = 3;
+		else if (0 == strcmp(argv[i], "--from") && i + 1 < argc)
+		{
+			options.haveFrom = true;
+			options.from = strtoll(argv[++i], NULL, 0);
+		}
+		else if (0 == strcmp(argv[i], "--to") && i + 1 < argc)
+		{
+			options.haveTo = true;
+			options.to = strtoll(argv[++i], NULL, 0);
+		}
+		else if (0 == strcmp(argv[i], "--check"))
+			options.check = true;
+		else if ('-' != argv[i][0] || '\0' == argv[i][1])
+		{
+			if (positionals == 3)
+			{
+				usage(argv[0]);
+				return 2;
+			}
+			positional[positionals++] = argv[i];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 2;
+		}
+	}
+
+	// A log carries its own channel map, so takes no TYPE
+	if (positionals < 2)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+	const char *inputName = positional[positionals - 2];
+	const char *outputName = positional[positionals - 1];
+	const char *extension = strrchr(inputName, '.');
+	const char *outputExtension = strrchr(outputName, '.');
+	options.log = (3 == format) || (0 == format && NULL != extension && 0 == strcmp(extension, ".tclog"));
+	options.csv = (1 == format) || (0 == format && NULL != extension && 0 == strcmp(extension, ".csv"));
+	options.csvOutput = options.log ? (NULL != outputExtension && 0 == strcmp(outputExtension, ".csv")) : options.csv;
+
+	const ConvertType *type = NULL;
+	if (3 == positionals)
+		for (const ConvertType &candidate : types)
+			if (0 == strcmp(positional[0], candidate.name))
+				type = &candidate;
+	if ((options.log ? 2 : 3) != positionals || (!options.log && NULL == type) || 0 == options.chunk)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+	if (0 == options.threads)
+		options.threads = std::thread::hardware_concurrency();
+	if (0 == options.threads)
+		options.threads = 1;
+
+	int in = -1;
+	size_t size = 0;
+	const char *data = NULL;
+	if (options.log)
+	{
+		if (!logReader.open(inputName))
+		{
+			fprintf(stderr, "%s: not a readable thermocouple log\n", inputName);
+			return 1;
+		}
+		options.single = (sizeof(float) == logReader.sampleSize());
+	}
+	else
+	{
+		struct stat info;
+		in = open(inputName, O_RDONLY);
+		if (in < 0 || 0 != fstat(in, &info))
+		{
+			perror(inputName);
+			return 1;
+		}
+		size = (size_t)info.st_size;
+	}
+	if (size > 0)
+	{
+		void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, in, 0);
+		if (MAP_FAILED == mapping)
+		{
+			perror(inputName);
+			return 1;
+		}
+		madvise(mapping, size, MADV_SEQUENTIAL);
+		data = (const char *)mapping;
+	}
+
+	int out = (0 == strcmp(outputName, "-")) ? STDOUT_FILENO : open(outputName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (out < 0)
+	{
+		perror(outputName);
+		return 1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<ConvertChunk> chunks = options.log ? convertSplitLog() : convertSplit(data, size);
+	const size_t window = (size_t)options.threads * CONVERT_CHUNKS_PER_THREAD;
+	std::atomic<size_t> next(0);
+	std::mutex lock;
+	std::condition_variable ready, space;
+	size_t written = 0;
+	std::vector<std::thread> workers;
+
+	// Chunks are claimed in order, and a worker holds off on a chunk more
+	// than window ahead of the writer - the oldest unwritten chunk is always
+	// claimable, so this can't deadlock
+	for (unsigned t = 0; t < options.threads; t++)
+	{
+		workers.push_back(std::thread([&]() {
+			for (;;)
+			{
+				size_t k = next++;
+				if (k >= chunks.size())
+					return;
+				{
+					std::unique_lock<std::mutex> guard(lock);
+					space.wait(guard, [&]() { return k < written + window; });
+				}
+				if (options.single)
+					convertChunk<float>(type ? type->tc : NULL, chunks[k]);
+				else
+					convertChunk<double>(type ? type->tc : NULL, chunks[k]);
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					chunks[k].done = true;
+				}
+				ready.notify_all();
+			}
+		}));
+	}
+
+	size_t samples = 0, skipped = 0, mismatches = 0;
+	bool failed = false;
+	for (size_t k = 0; k < chunks.size(); k++)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			ready.wait(guard, [&]() { return chunks[k].done; });
+		}
+		if (!failed && !convertWrite(out, chunks[k].output))
+		{
+			perror(outputName);
+			failed = true;
+		}
+		samples += chunks[k].samples;
+		skipped += chunks[k].skipped;
+		mismatches += chunks[k].mismatches;
+		std::string().swap(chunks[k].output);
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			written++;
+		}
+		space.notify_all();
+	}
+	for (std::thread &worker : workers)
+		worker.join();
+	if (STDOUT_FILENO != out && 0 != close(out))
+	{
+		perror(outputName);
+		failed = true;
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	if (options.log)
+		fprintf(stderr, "Log, %u channels: %zu samples from %zu blocks", logReader.channels(), samples, chunks.size());
+	else
+		fprintf(stderr, "Type %s: %zu samples", type->name, samples);
+	fprintf(stderr, " in %.3f s, %.0f samples/s (%u threads, %s, %s)\n", elapsed.count(), (elapsed.count() > 0.0) ? samples / elapsed.count() : 0.0,
+		options.threads, options.log ? "log" : (options.csv ? "csv" : "binary"), options.single ? "float" : "double");
+	if (skipped)
+		fprintf(stderr, "%zu lines skipped\n", skipped);
+	if (options.check)
+		fprintf(stderr, "%zu samples differ from getTemperature()\n", mismatches);
+
+	if (data)
+		munmap((void *)data, size);
+	if (in >= 0)
+		close(in);
+	return (failed || mismatches) ? 1 : 0;
+}
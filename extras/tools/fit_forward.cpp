@@ -0,0 +1,356 @@
+/*************************************************************************
+Title:    Thermocouple Forward Model Fit Generator
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     fit_forward.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Generates the temperature to voltage (forward) tables in
+    ThermocoupleCoefficients.h from the NIST ITS-90 reference functions.
+
+    Each segment is a rational in the same form as the Mosaic inverse fits,
+    with the roles of temperature and voltage swapped:
+
+      mV = V0 + x*(p1 + x*(p2 + x*(p3 + p4*x))) / (1 + x*(q1 + x*(q2 + q3*x)))
+      x = t - T0
+
+    Segments are grown greedily from the bottom of each range, as wide as
+    they can be while the worst-case error (expressed in degrees, i.e.
+    voltage error divided by the Seebeck coefficient) stays under the
+    tolerance.  Each candidate is fitted by Sanathanan-Koerner iteration
+    (linearized least squares, reweighted by the previous denominator)
+    followed by Lawson reweighting towards minimax.  The NIST polynomial
+    range boundaries are always kept as breakpoints.
+
+    With --cold-junction it generates the cold junction tables instead:
+    the same form without q3, covering TC_CJ_MIN_TEMPERATURE to
+    TC_CJ_MAX_TEMPERATURE (type B from 0C, where its reference function
+    starts).
+
+    Built by extras/Makefile - paste the output over the forward (or cold
+    junction) tables:
+      make -C extras
+      extras/build/fit_forward [--cold-junction] [tolerance C, default 0.001]
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../reference/nist_its90.h"
+#include "../../src/ThermocoupleCoefficients.h"
+
+#define FIT_TERMS 7      // p1..p4, q1..q3
+#define FIT_SAMPLES 400
+#define FIT_CHECK_SAMPLES 4000
+
+// Type B's Seebeck coefficient passes through zero near 21C, so errors are
+// converted to degrees with at least this sensitivity (mV/C)
+#define FIT_MIN_SEEBECK 0.0001
+
+struct Fit
+{
+	double T0;
+	double V0;
+	double c[FIT_TERMS];   // p1..p4, q1..q3
+	double error;          // worst case, in degrees C
+	bool valid;
+};
+
+static double evaluate(const Fit &f, double t)
+{
+	double x = t - f.T0;
+	double numerator = x * (f.c[0] + x * (f.c[1] + x * (f.c[2] + f.c[3] * x)));
+	double denominator = 1.0 + x * (f.c[4] + x * (f.c[5] + f.c[6] * x));
+	return f.V0 + numerator / denominator;
+}
+
+static double denominator(const Fit &f, double t)
+{
+	double x = t - f.T0;
+	return 1.0 + x * (f.c[4] + x * (f.c[5] + f.c[6] * x));
+}
+
+// Least squares solution of A z = b (rows x cols, row stride FIT_TERMS) by Householder QR
+static bool leastSquares(std::vector<long double> &A, std::vector<long double> &b, int rows, int cols, long double *z)
+{
+	for (int k = 0; k < cols; k++)
+	{
+		long double norm = 0;
+		for (int i = k; i < rows; i++)
+			norm += A[i * FIT_TERMS + k] * A[i * FIT_TERMS + k];
+		norm = sqrtl(norm);
+		if (0 == norm)
+			return false;
+		long double alpha = (A[k * FIT_TERMS + k] > 0) ? -norm : norm;
+		std::vector<long double> v(rows, 0);
+		for (int i = k; i < rows; i++)
+			v[i] = A[i * FIT_TERMS + k];
+		v[k] -= alpha;
+		long double vv = 0;
+		for (int i = k; i < rows; i++)
+			vv += v[i] * v[i];
+		for (int j = k; j < cols; j++)
+		{
+			long double s = 0;
+			for (int i = k; i < rows; i++)
+				s += v[i] * A[i * FIT_TERMS + j];
+			s = 2 * s / vv;
+			for (int i = k; i < rows; i++)
+				A[i * FIT_TERMS + j] -= s * v[i];
+		}
+		long double s = 0;
+		for (int i = k; i < rows; i++)
+			s += v[i] * b[i];
+		s = 2 * s / vv;
+		for (int i = k; i < rows; i++)
+			b[i] -= s * v[i];
+	}
+	for (int k = cols - 1; k >= 0; k--)
+	{
+		long double s = b[k];
+		for (int j = k + 1; j < cols; j++)
+			s -= A[k * FIT_TERMS + j] * z[j];
+		z[k] = s / A[k * FIT_TERMS + k];
+	}
+	return true;
+}
+
+// Round to the 8 significant digits the tables are printed with
+static double roundCoefficient(double v)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.7E", v);
+	return atof(buffer);
+}
+
+static void measure(const NistReference *ref, Fit &f, double lo, double hi)
+{
+	f.error = 0;
+	f.valid = true;
+	for (int i = 0; i <= FIT_CHECK_SAMPLES; i++)
+	{
+		double t = lo + (hi - lo) * i / FIT_CHECK_SAMPLES;
+		if (denominator(f, t) <= 0.1)
+			f.valid = false;
+		double e = fabs(evaluate(f, t) - nistVoltage(ref, t)) / fmax(fabs(nistSeebeck(ref, t)), FIT_MIN_SEEBECK);
+		if (e > f.error)
+			f.error = e;
+	}
+}
+
+// qTerms is the number of denominator terms fitted (0-3), the rest are zero
+static Fit fitRational(const NistReference *ref, double lo, double hi, int qTerms)
+{
+	Fit f;
+	// Centers on whole degrees keep the printed tables tidy
+	f.T0 = floor((lo + hi) / 2.0 + 0.5);
+	f.V0 = roundCoefficient(nistVoltage(ref, f.T0));
+	double h = (hi - lo) / 2.0;
+
+	std::vector<double> u(FIT_SAMPLES), y(FIT_SAMPLES), w(FIT_SAMPLES), lawson(FIT_SAMPLES, 1.0), d(FIT_SAMPLES, 1.0);
+	for (int i = 0; i < FIT_SAMPLES; i++)
+	{
+		// Chebyshev nodes, including the ends
+		double t = (lo + hi) / 2.0 - h * cos(M_PI * i / (FIT_SAMPLES - 1));
+		u[i] = (t - f.T0) / h;
+		y[i] = nistVoltage(ref, t) - f.V0;
+		w[i] = 1.0 / fmax(fabs(nistSeebeck(ref, t)), FIT_MIN_SEEBECK);
+	}
+
+	long double z[FIT_TERMS] = { 0 };
+	for (int iteration = 0; iteration < 40; iteration++)
+	{
+		std::vector<long double> A(FIT_SAMPLES * FIT_TERMS), b(FIT_SAMPLES);
+		for (int i = 0; i < FIT_SAMPLES; i++)
+		{
+			long double s = w[i] * lawson[i] / d[i];
+			long double uk = u[i];
+			for (int k = 0; k < 4; k++, uk *= u[i])
+				A[i * FIT_TERMS + k] = s * uk;
+			uk = u[i];
+			for (int k = 0; k < qTerms; k++, uk *= u[i])
+				A[i * FIT_TERMS + 4 + k] = -s * y[i] * uk;
+			b[i] = s * y[i];
+		}
+		if (!leastSquares(A, b, FIT_SAMPLES, 4 + qTerms, z))
+			break;
+
+		double maxError = 0;
+		for (int i = 0; i < FIT_SAMPLES; i++)
+		{
+			d[i] = 1.0 + u[i] * (z[4] + u[i] * (z[5] + u[i] * z[6]));
+			if (fabs(d[i]) < 1e-6)
+				d[i] = 1e-6;
+			double n = u[i] * (z[0] + u[i] * (z[1] + u[i] * (z[2] + u[i] * z[3])));
+			double e = fabs(n / d[i] - y[i]) * w[i];
+			if (e > maxError)
+				maxError = e;
+			if (iteration >= 10)
+				lawson[i] *= e;
+		}
+		// Past the Sanathanan-Koerner warm-up, reweight towards equal ripple
+		if (iteration >= 10)
+		{
+			double sum = 0;
+			for (int i = 0; i < FIT_SAMPLES; i++)
+				sum += lawson[i];
+			for (int i = 0; i < FIT_SAMPLES; i++)
+				lawson[i] = lawson[i] / sum * FIT_SAMPLES + 1e-9;
+		}
+	}
+
+	for (int k = 0; k < 4; k++)
+		f.c[k] = roundCoefficient((double)(z[k] / powl(h, k + 1)));
+	for (int k = 0; k < 3; k++)
+		f.c[4 + k] = roundCoefficient((double)(z[4 + k] / powl(h, k + 1)));
+	measure(ref, f, lo, hi);
+	return f;
+}
+
+// Short, nearly straight segments can make the full rational degenerate (a
+// pole cancelling a zero), so fall back to smaller denominators
+static Fit fitSegment(const NistReference *ref, double lo, double hi, int maxQTerms)
+{
+	Fit best = fitRational(ref, lo, hi, maxQTerms);
+	for (int qTerms = maxQTerms - 1; qTerms >= 0; qTerms--)
+	{
+		Fit f = fitRational(ref, lo, hi, qTerms);
+		if (f.valid && (!best.valid || f.error < best.error))
+			best = f;
+	}
+	return best;
+}
+
+// Fits lo..hi with as few segments as meet the tolerance, appending them
+// and their upper limits
+static bool fitRange(const NistReference *ref, double lo, double hi, double tolerance, int maxQTerms, std::vector<Fit> &fits, std::vector<double> &breakpoints)
+{
+	while (lo < hi)
+	{
+		// Binary search for the widest segment that meets the tolerance
+		double good = lo, bad = hi;
+		Fit best = fitSegment(ref, lo, bad, maxQTerms);
+		if (best.valid && best.error <= tolerance)
+			good = bad;
+		else
+		{
+			best.valid = false;
+			while (bad - good > 1.0)
+			{
+				double mid = floor((good + bad) / 2.0);
+				if (mid <= good)
+					break;
+				Fit f = fitSegment(ref, lo, mid, maxQTerms);
+				if (f.valid && f.error <= tolerance)
+				{
+					good = mid;
+					best = f;
+				}
+				else
+					bad = mid;
+			}
+			if (!best.valid)
+			{
+				fprintf(stderr, "Type %s: no fit meets %g C above %g C\n", ref->name, tolerance, lo);
+				return false;
+			}
+		}
+		fits.push_back(best);
+		breakpoints.push_back(good);
+		lo = good;
+	}
+	return true;
+}
+
+static void printTables(const NistReference *ref, const char *prefix, const char *segments, const char *breakpointArray, const char *coefficientArray,
+	const char *countName, int rows, bool perSegment, const std::vector<Fit> &fits, const std::vector<double> &breakpoints)
+{
+	const char *names[TC_COEFF_COUNT] = { "T0", "V0", "p1", "p2", "p3", "p4", "q1", "q2", "q3" };
+	size_t n = fits.size();
+	double worst = 0;
+	for (size_t i = 0; i < n; i++)
+		worst = fmax(worst, fits[i].error);
+
+	printf("// Type %s: %s%u segments, worst case %.5f C\n", ref->name, prefix, (unsigned)n, worst);
+	if (perSegment)
+		for (size_t i = 0; i < n; i++)
+			printf("\t// %gC to %gC: within %.6fC\n", breakpoints[i], breakpoints[i + 1], fits[i].error);
+	printf("\tstatic constexpr uint8_t %s = %u;\n", segments, (unsigned)n);
+	printf("\tstatic constexpr T %s[%u] = {", breakpointArray, (unsigned)(n + 1));
+	for (size_t i = 0; i <= n; i++)
+		printf("%s %g", i ? "," : "", breakpoints[i]);
+	printf(" };\n");
+	printf("\tstatic constexpr T %s[%s * %u] =\n\t{\n", coefficientArray, countName, (unsigned)n);
+	for (int row = 0; row < rows; row++)
+	{
+		printf("\t\t");
+		for (size_t i = 0; i < n; i++)
+		{
+			double v = (0 == row) ? fits[i].T0 : ((1 == row) ? fits[i].V0 : fits[i].c[row - 2]);
+			printf("%s%.7E,", i ? " " : "", v);
+		}
+		printf("\t// %s\n", names[row]);
+	}
+	printf("\t};\n\n");
+}
+
+int main(int argc, char **argv)
+{
+	bool coldJunction = (argc > 1 && 0 == strcmp(argv[1], "--cold-junction"));
+	if (coldJunction)
+	{
+		argc--;
+		argv++;
+	}
+	double tolerance = (argc > 1) ? atof(argv[1]) : 0.001;
+
+	for (size_t type = 0; type < NIST_TYPES; type++)
+	{
+		const NistReference *ref = &nistReference[type];
+		std::vector<double> breakpoints;
+		std::vector<Fit> fits;
+
+		if (coldJunction)
+		{
+			// Only q1 and q2 - the cold junction rational has no q3
+			double lo = fmax(TC_CJ_MIN_TEMPERATURE, nistMinTemperature(ref));
+			breakpoints.push_back(lo);
+			for (int r = 0; r < ref->ranges; r++)
+			{
+				double hi = fmin(ref->range[r].hi, TC_CJ_MAX_TEMPERATURE);
+				if (hi <= lo)
+					continue;
+				if (!fitRange(ref, lo, hi, tolerance, 2, fits, breakpoints))
+					return 1;
+				lo = hi;
+			}
+			printTables(ref, "cold junction, ", "coldJunctionSegments", "coldJunctionBreakpoints", "coldJunction", "TC_CJ_COEFF_COUNT", TC_CJ_COEFF_COUNT, true, fits, breakpoints);
+			continue;
+		}
+
+		breakpoints.push_back(nistMinTemperature(ref));
+		for (int r = 0; r < ref->ranges; r++)
+			if (!fitRange(ref, ref->range[r].lo, ref->range[r].hi, tolerance, 3, fits, breakpoints))
+				return 1;
+		printTables(ref, "", "forwardSegments", "forwardBreakpoints", "forwardCoefficients", "TC_COEFF_COUNT", TC_COEFF_COUNT, false, fits, breakpoints);
+	}
+	return 0;
+}
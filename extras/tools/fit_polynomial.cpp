@@ -0,0 +1,401 @@
+/*************************************************************************
+Title:    Thermocouple Polynomial Kernel Fit Generator
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     fit_polynomial.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Generates the millivolt-to-temperature polynomial tables in
+    ThermocoupleCoefficients.h from the NIST ITS-90 reference functions.
+    These are what the TypeX classes and Thermocouple<> evaluate in place
+    of the Mosaic rationals when a type is built with TC_TYPE_x_POLYNOMIAL
+    - no division per sample:
+
+      t = T0 + x*(a1 + x*(a2 + ... + x*aN))
+      x = mV - V0
+
+    A polynomial can't follow the reference as far as a rational can, so
+    each type gets its own segments: from the bottom of its range, each
+    segment is made as wide (in whole degrees) as it can be while meeting
+    the target against NIST, in C.  The range is the rational tables',
+    clipped to the reference's, and the reference's own range boundaries
+    are always breakpoints.  Every segment has the same degree - 5 unless
+    --degree says otherwise.  Each is a least squares fit on Chebyshev nodes
+    followed by Lawson reweighting towards minimax, and is measured after
+    rounding to the 8 significant digits it's printed with.  The
+    coefficients take the rational tables' columns (T0, V0, then a1..a7 in
+    place of p1..q3), but only as many as the degree needs.
+
+    After the tables it reports, per type, the polynomial's worst case
+    against the rational's, both segment counts, and the operations per
+    sample each kernel takes once the segment is found.  It exits non-zero
+    if a type can't meet the target at that degree.
+
+    Built by extras/Makefile - paste each type's tables over its
+    polynomial tables, and set TC_MAX_SEGMENTS if the most segments changes:
+      make -C extras
+      extras/build/fit_polynomial [--degree N] [target C, default 0.01]
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../reference/nist_its90.h"
+#include "../../src/ThermocoupleCoefficients.h"
+
+#define FIT_MAX_DEGREE TC_POLYNOMIAL_MAX_DEGREE
+#define FIT_SAMPLES 400
+#define FIT_CHECK_SAMPLES 4000
+#define FIT_ITERATIONS 200
+#define FIT_DEFAULT_DEGREE 5
+
+// One type's rational segments as the library has them
+struct FitType
+{
+	const NistReference *ref;
+	uint8_t segments;
+	bool upperInclusive;
+	const double *breakpoints;
+	const double *coefficients;   // the rationals, TC_COEFF_* columns
+};
+
+struct Fit
+{
+	double c[TC_COEFF_COUNT];   // T0, V0, a1..a7
+	double error;               // worst case against NIST, C
+	bool valid;
+};
+
+template<ThermocoupleType Type> static FitType fitType(size_t index)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	FitType type = { &nistReference[index], Coefficients::segments, Coefficients::upperInclusive, Coefficients::breakpoints, Coefficients::coefficients };
+	return type;
+}
+
+// In the order the kernel evaluates it
+static double evaluate(const Fit &f, int degree, double mv)
+{
+	double x = mv - f.c[TC_COEFF_V0];
+	double r = f.c[TC_POLYNOMIAL_A1 + degree - 1];
+	for (int k = degree - 1; k >= 1; k--)
+		r = f.c[TC_POLYNOMIAL_A1 + k - 1] + x * r;
+	return f.c[TC_COEFF_T0] + x * r;
+}
+
+static double evaluateRational(const FitType &type, uint8_t seg, double mv)
+{
+	const double *c = type.coefficients;
+	const uint8_t n = type.segments;
+	double x = mv - c[TC_COEFF_V0 * n + seg];
+	double numerator = x * (c[TC_COEFF_P1 * n + seg] + x * (c[TC_COEFF_P2 * n + seg] + x * (c[TC_COEFF_P3 * n + seg] + c[TC_COEFF_P4 * n + seg] * x)));
+	double denominator = 1.0 + x * (c[TC_COEFF_Q1 * n + seg] + x * (c[TC_COEFF_Q2 * n + seg] + c[TC_COEFF_Q3 * n + seg] * x));
+	return c[TC_COEFF_T0 * n + seg] + numerator / denominator;
+}
+
+// Least squares solution of A z = b (rows x cols, row stride FIT_MAX_DEGREE + 1) by Householder QR
+static bool leastSquares(std::vector<long double> &A, std::vector<long double> &b, int rows, int cols, long double *z)
+{
+	const int stride = FIT_MAX_DEGREE + 1;
+	for (int k = 0; k < cols; k++)
+	{
+		long double norm = 0;
+		for (int i = k; i < rows; i++)
+			norm += A[i * stride + k] * A[i * stride + k];
+		norm = sqrtl(norm);
+		if (0 == norm)
+			return false;
+		long double alpha = (A[k * stride + k] > 0) ? -norm : norm;
+		std::vector<long double> v(rows, 0);
+		for (int i = k; i < rows; i++)
+			v[i] = A[i * stride + k];
+		v[k] -= alpha;
+		long double vv = 0;
+		for (int i = k; i < rows; i++)
+			vv += v[i] * v[i];
+		for (int j = k; j < cols; j++)
+		{
+			long double s = 0;
+			for (int i = k; i < rows; i++)
+				s += v[i] * A[i * stride + j];
+			s = 2 * s / vv;
+			for (int i = k; i < rows; i++)
+				A[i * stride + j] -= s * v[i];
+		}
+		long double s = 0;
+		for (int i = k; i < rows; i++)
+			s += v[i] * b[i];
+		s = 2 * s / vv;
+		for (int i = k; i < rows; i++)
+			b[i] -= s * v[i];
+	}
+	for (int k = cols - 1; k >= 0; k--)
+	{
+		long double s = b[k];
+		for (int j = k + 1; j < cols; j++)
+			s -= A[k * stride + j] * z[j];
+		z[k] = s / A[k * stride + k];
+	}
+	return true;
+}
+
+// Round to the 8 significant digits the tables are printed with
+static double roundCoefficient(double v)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.7E", v);
+	return atof(buffer);
+}
+
+// Worst case of f over lo..hi against NIST, C
+static double measure(const NistReference *ref, const Fit &f, int degree, double lo, double hi)
+{
+	double worst = 0;
+	for (int i = 0; i <= FIT_CHECK_SAMPLES; i++)
+	{
+		double mv = lo + (hi - lo) * i / FIT_CHECK_SAMPLES;
+		worst = fmax(worst, fabs(evaluate(f, degree, mv) - nistTemperature(ref, mv)));
+	}
+	return worst;
+}
+
+// Millivolt breakpoints and V0 are kept to the microvolt, as the Mosaic ones are
+static double roundMillivolts(double mv)
+{
+	return floor(mv * 1000.0 + 0.5) / 1000.0;
+}
+
+static Fit fitSegment(const NistReference *ref, double lo, double hi, int degree)
+{
+	const int terms = degree + 1;
+	const int stride = FIT_MAX_DEGREE + 1;
+	Fit f;
+	memset(&f, 0, sizeof(f));
+	f.c[TC_COEFF_V0] = roundMillivolts((lo + hi) / 2.0);
+	// Scaled so the powers of u stay near 1
+	const double h = fmax(hi - f.c[TC_COEFF_V0], f.c[TC_COEFF_V0] - lo);
+
+	std::vector<double> u(FIT_SAMPLES), y(FIT_SAMPLES), lawson(FIT_SAMPLES, 1.0);
+	for (int i = 0; i < FIT_SAMPLES; i++)
+	{
+		// Chebyshev nodes, including the ends
+		double mv = (lo + hi) / 2.0 - (hi - lo) / 2.0 * cos(M_PI * i / (FIT_SAMPLES - 1));
+		u[i] = (mv - f.c[TC_COEFF_V0]) / h;
+		y[i] = nistTemperature(ref, mv);
+	}
+
+	long double z[FIT_MAX_DEGREE + 1] = { 0 };
+	for (int iteration = 0; iteration < FIT_ITERATIONS; iteration++)
+	{
+		std::vector<long double> A(FIT_SAMPLES * stride), b(FIT_SAMPLES);
+		for (int i = 0; i < FIT_SAMPLES; i++)
+		{
+			long double s = sqrtl(lawson[i]);
+			long double uk = 1;
+			for (int k = 0; k < terms; k++, uk *= u[i])
+				A[i * stride + k] = s * uk;
+			b[i] = s * y[i];
+		}
+		if (!leastSquares(A, b, FIT_SAMPLES, terms, z))
+			return f;
+
+		// Lawson: reweight by each node's error, towards equal ripple
+		double sum = 0;
+		for (int i = 0; i < FIT_SAMPLES; i++)
+		{
+			long double p = z[degree];
+			for (int k = degree - 1; k >= 0; k--)
+				p = z[k] + u[i] * p;
+			lawson[i] *= fabs((double)p - y[i]);
+			sum += lawson[i];
+		}
+		for (int i = 0; i < FIT_SAMPLES; i++)
+			lawson[i] = lawson[i] / sum * FIT_SAMPLES + 1e-12;
+	}
+
+	f.c[TC_COEFF_T0] = roundCoefficient((double)z[0]);
+	for (int k = 1; k <= degree; k++)
+		f.c[TC_POLYNOMIAL_A1 + k - 1] = roundCoefficient((double)(z[k] / powl(h, k)));
+	f.error = measure(ref, f, degree, lo, hi);
+	f.valid = true;
+	return f;
+}
+
+// Fits lo..hi (mV) with as few segments as meet the target, appending them
+// and their upper limits.  Segments end on whole degrees.
+static bool fitRange(const NistReference *ref, double lo, double hi, double target, int degree, std::vector<Fit> &fits, std::vector<double> &breakpoints)
+{
+	const double top = nistTemperature(ref, hi);
+	while (lo < hi)
+	{
+		// Binary search for the widest segment that meets the target
+		double good = nistTemperature(ref, lo), bad = top;
+		double end = hi;
+		Fit best = fitSegment(ref, lo, hi, degree);
+		if (!(best.valid && best.error <= target))
+		{
+			best.valid = false;
+			while (bad - good > 1.0)
+			{
+				double mid = floor((good + bad) / 2.0);
+				double mv = roundMillivolts(nistVoltage(ref, mid));
+				if (mid <= good || mv <= lo)
+				{
+					good = mid;
+					continue;
+				}
+				Fit f = fitSegment(ref, lo, mv, degree);
+				if (f.valid && f.error <= target)
+				{
+					good = mid;
+					end = mv;
+					best = f;
+				}
+				else
+					bad = mid;
+			}
+			if (!best.valid)
+			{
+				fprintf(stderr, "Type %s: no degree %d fit meets %g C above %g mV\n", ref->name, degree, target, lo);
+				return false;
+			}
+		}
+		fits.push_back(best);
+		breakpoints.push_back(end);
+		lo = end;
+	}
+	return true;
+}
+
+// The rational tables' worst case against NIST over lo..hi (mV)
+static double rationalError(const FitType &type, double lo, double hi)
+{
+	double worst = 0;
+	for (uint8_t seg = 0; seg < type.segments; seg++)
+	{
+		double a = fmax(lo, type.breakpoints[seg]), b = fmin(hi, type.breakpoints[seg + 1]);
+		for (int i = 0; a < b && i <= FIT_CHECK_SAMPLES; i++)
+		{
+			double mv = a + (b - a) * i / FIT_CHECK_SAMPLES;
+			worst = fmax(worst, fabs(evaluateRational(type, seg, mv) - nistTemperature(type.ref, mv)));
+		}
+	}
+	return worst;
+}
+
+static void printTables(const FitType &type, int degree, double worst, const std::vector<Fit> &fits, const std::vector<double> &breakpoints)
+{
+	const char *names[TC_COEFF_COUNT] = { "T0", "V0", "a1", "a2", "a3", "a4", "a5", "a6", "a7" };
+	size_t n = fits.size();
+
+	printf("// Type %s: degree %d, %u segments, worst case %.5f C\n", type.ref->name, degree, (unsigned)n, worst);
+	printf("\tstatic constexpr uint8_t polynomialDegree = %d;\n", degree);
+	printf("\tstatic constexpr uint8_t polynomialSegments = %u;\n", (unsigned)n);
+	printf("\tstatic constexpr T polynomialBreakpoints[%u] = {", (unsigned)(n + 1));
+	for (size_t i = 0; i <= n; i++)
+		printf("%s %.3f", i ? "," : "", breakpoints[i]);
+	printf(" };\n");
+	printf("\tstatic constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(%d) * %u] =\n\t{\n", degree, (unsigned)n);
+	for (int row = 0; row < TC_POLYNOMIAL_COLUMNS(degree); row++)
+	{
+		printf("\t\t");
+		for (size_t i = 0; i < n; i++)
+			printf("%s%.7E,", i ? " " : "", fits[i].c[row]);
+		printf("\t// %s\n", names[row]);
+	}
+	printf("\t};\n\n");
+}
+
+int main(int argc, char **argv)
+{
+	int degree = FIT_DEFAULT_DEGREE;
+	double target = 0.01;
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "--degree") && i + 1 < argc)
+			degree = atoi(argv[++i]);
+		else if (argv[i][0] != '-' || isdigit((unsigned char)argv[i][1]))
+			target = atof(argv[i]);
+		else
+		{
+			fprintf(stderr, "usage: %s [--degree N] [target C, default 0.01]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (degree < 1 || degree > FIT_MAX_DEGREE || !(target > 0))
+	{
+		fprintf(stderr, "degree must be 1 to %d, and the target above 0\n", FIT_MAX_DEGREE);
+		return 2;
+	}
+
+	const FitType types[] =
+	{
+		fitType<ThermocoupleType::B>(0), fitType<ThermocoupleType::E>(1), fitType<ThermocoupleType::J>(2), fitType<ThermocoupleType::K>(3),
+		fitType<ThermocoupleType::N>(4), fitType<ThermocoupleType::R>(5), fitType<ThermocoupleType::S>(6), fitType<ThermocoupleType::T>(7),
+	};
+	char report[NIST_TYPES][128];
+
+	for (size_t t = 0; t < NIST_TYPES; t++)
+	{
+		const FitType &type = types[t];
+		const NistReference *ref = type.ref;
+		std::vector<double> breakpoints;
+		std::vector<Fit> fits;
+
+		// The rational tables' limits, but no further than the reference goes
+		// (K's last rational segment runs on past 1372C, and S's first starts
+		// just below -50C) - past its ends the reference is flat
+		double lo = fmax(type.breakpoints[0], ceil(nistVoltage(ref, nistMinTemperature(ref)) * 1000.0) / 1000.0);
+		double hi = fmin(type.breakpoints[type.segments], floor(nistVoltage(ref, nistMaxTemperature(ref)) * 1000.0) / 1000.0);
+		breakpoints.push_back(lo);
+		for (int r = 0; r < ref->ranges; r++)
+		{
+			// The reference's own range boundaries are always kept
+			double end = (r + 1 < ref->ranges) ? roundMillivolts(nistVoltage(ref, ref->range[r].hi)) : hi;
+			if (end <= lo)
+				continue;
+			if (!fitRange(ref, lo, fmin(end, hi), target, degree, fits, breakpoints))
+				return 1;
+			lo = fmin(end, hi);
+			if (lo >= hi)
+				break;
+		}
+
+		double worst = 0;
+		for (size_t i = 0; i < fits.size(); i++)
+			worst = fmax(worst, fits[i].error);
+		printTables(type, degree, worst, fits, breakpoints);
+
+		// Per sample once the segment is found: x = mV - V0, then Horner for
+		// the polynomial, or the rational's numerator, denominator and divide.
+		// Finding the segment takes one compare per interior breakpoint.
+		snprintf(report[t], sizeof(report[t]), "//   %-4s %9.5f %9.5f   %2u %2u   %d mul %d add       7 mul 7 add 1 div",
+			ref->name, rationalError(type, breakpoints.front(), breakpoints.back()), worst,
+			(unsigned)type.segments, (unsigned)fits.size(), degree, degree);
+	}
+
+	printf("// Worst case against NIST (C), segments and operations per sample\n");
+	printf("//   %-4s %9s %9s   %5s   %-17s %s\n", "type", "rational", "poly", "segs", "polynomial", "rational");
+	for (size_t t = 0; t < NIST_TYPES; t++)
+		printf("%s\n", report[t]);
+	return 0;
+}
@@ -0,0 +1,195 @@
+/*************************************************************************
+Title:    Thermocouple Lookup Table Generator
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     lookup_table.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Builds ThermocoupleLookup tables on the host, either to report table
+    size against accuracy for every type, or to write one table out as a
+    header that can be compiled into a sketch (arrays in PROGMEM on AVR)
+    and read with tcLookupTemperature().
+
+    The reported error is measured independently of the builder, against
+    the library's double precision computeTemperature() at 64 points per
+    interval, so it includes the step between the rational fits at their
+    breakpoints and the float rounding of the result.
+
+    Built by extras/Makefile:
+      make -C extras
+      extras/build/lookup_table                          size vs accuracy report
+      extras/build/lookup_table K 0.01 cubic [uniform]   header for one table
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ThermocoupleLookup.h"
+
+#define LOOKUP_CHECK_SAMPLES 64
+
+struct LookupType
+{
+	const char *name;
+	bool (*build)(ThermocoupleLookup &lookup, float maxError, uint8_t order, bool aligned);
+	double (*reference)(double millivolts);
+};
+
+template<ThermocoupleType Type> static bool buildType(ThermocoupleLookup &lookup, float maxError, uint8_t order, bool aligned)
+{
+	return lookup.build<Type>(maxError, order, aligned);
+}
+
+template<ThermocoupleType Type> static double referenceType(double millivolts)
+{
+	return Thermocouple<Type>::computeTemperature(millivolts);
+}
+
+#define LOOKUP_TYPE(t) { #t, &buildType<ThermocoupleType::t>, &referenceType<ThermocoupleType::t> }
+
+static const LookupType types[] =
+{
+	LOOKUP_TYPE(B),
+	LOOKUP_TYPE(E),
+	LOOKUP_TYPE(J),
+	LOOKUP_TYPE(K),
+	LOOKUP_TYPE(N),
+	LOOKUP_TYPE(R),
+	LOOKUP_TYPE(S),
+	LOOKUP_TYPE(T),
+};
+
+// Worst difference from the library over the table's range
+static double checkTable(const LookupType &lt, ThermocoupleLookup &lookup)
+{
+	const ThermocoupleLookupTable *table = lookup.table();
+	const float lo = table->breakpoints[0];
+	const float hi = table->breakpoints[table->segments];
+	const uint32_t samples = (uint32_t)table->first[table->segments] * LOOKUP_CHECK_SAMPLES;
+	double worst = 0.0;
+	uint32_t i;
+
+	for (i = 0; i <= samples; i++)
+	{
+		float mv = (i == samples) ? hi : lo + (float)((double)(hi - lo) * i / samples);
+		double expected = lt.reference(mv);
+		if (TC_OUT_OF_RANGE_TEMPERATURE == expected)
+			continue;   // open end of the library's range
+		double err = fabs(lookup.computeTemperature(mv) - expected);
+		if (err > worst)
+			worst = err;
+	}
+	return worst;
+}
+
+static void report()
+{
+	static const float tolerances[] = { 0.1f, 0.01f, 0.001f };
+	static const uint8_t orders[] = { TC_LOOKUP_LINEAR, TC_LOOKUP_CUBIC };
+
+	printf("type  order   tolerance C   aligned: intervals   bytes  max err C   uniform: intervals   bytes  max err C\n");
+	for (const LookupType &lt : types)
+	{
+		for (uint8_t order : orders)
+		{
+			for (float tolerance : tolerances)
+			{
+				printf("%-4s  %-6s  %11g", lt.name, (TC_LOOKUP_LINEAR == order) ? "linear" : "cubic", tolerance);
+				for (int aligned = 1; aligned >= 0; aligned--)
+				{
+					ThermocoupleLookup lookup;
+					if (lt.build(lookup, tolerance, order, aligned))
+						printf("   %19u  %6zu  %9.5f", lookup.table()->first[lookup.table()->segments], lookup.bytes(), checkTable(lt, lookup));
+					else
+						printf("   %19s  %6s  %9s", "n/a", "", "");
+				}
+				printf("\n");
+			}
+		}
+	}
+}
+
+static void printFloats(const char *type, const char *name, const float *values, size_t count, size_t perLine)
+{
+	size_t i;
+
+	printf("static const float tcLookupType%s%s[] PROGMEM =\n{", type, name);
+	for (i = 0; i < count; i++)
+		printf("%s%.9g%s", (i % perLine) ? " " : "\n\t", values[i], (i + 1 < count) ? "," : "");
+	printf("\n};\n\n");
+}
+
+static void emit(const LookupType &lt, ThermocoupleLookup &lookup, float tolerance, bool aligned)
+{
+	const ThermocoupleLookupTable *table = lookup.table();
+	const size_t intervals = table->first[table->segments];
+	uint8_t i;
+
+	printf("// Type %s %s lookup table, %s, %zu intervals, %zu bytes\n", lt.name,
+		(TC_LOOKUP_LINEAR == table->order) ? "linear" : "cubic", aligned ? "breakpoint-aligned" : "uniform", intervals, lookup.bytes());
+	printf("// Generated by extras/tools/lookup_table.cpp for a maximum error of %g C (measured %.5f C)\n\n", tolerance, checkTable(lt, lookup));
+	printf("#ifndef _THERMOCOUPLE_LOOKUP_TYPE_%s_H_\n#define _THERMOCOUPLE_LOOKUP_TYPE_%s_H_\n\n", lt.name, lt.name);
+	printf("#include \"ThermocoupleLookup.h\"\n\n");
+
+	printFloats(lt.name, "Breakpoints", table->breakpoints, table->segments + 1, 8);
+	printFloats(lt.name, "Scale", table->scale, table->segments, 8);
+	printf("static const uint16_t tcLookupType%sFirst[] PROGMEM =\n{\n\t", lt.name);
+	for (i = 0; i <= table->segments; i++)
+		printf("%u%s", table->first[i], (i < table->segments) ? ", " : "");
+	printf("\n};\n\n");
+	printFloats(lt.name, "Coefficients", table->coefficients, intervals * (table->order + 1), table->order + 1);
+
+	printf("static const ThermocoupleLookupTable tcLookupType%s =\n{\n", lt.name);
+	printf("\t%u,\n\t%s,\n", table->segments, (TC_LOOKUP_LINEAR == table->order) ? "TC_LOOKUP_LINEAR" : "TC_LOOKUP_CUBIC");
+	printf("\ttcLookupType%sBreakpoints,\n\ttcLookupType%sScale,\n\ttcLookupType%sFirst,\n\ttcLookupType%sCoefficients\n};\n\n", lt.name, lt.name, lt.name, lt.name);
+	printf("#endif\n");
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		report();
+		return 0;
+	}
+
+	const LookupType *lt = NULL;
+	for (const LookupType &candidate : types)
+		if (0 == strcmp(argv[1], candidate.name))
+			lt = &candidate;
+	float tolerance = (argc > 2) ? atof(argv[2]) : 0.01f;
+	uint8_t order = (argc > 3 && 0 == strcmp(argv[3], "cubic")) ? TC_LOOKUP_CUBIC : TC_LOOKUP_LINEAR;
+	bool aligned = !(argc > 4 && 0 == strcmp(argv[4], "uniform"));
+
+	if (NULL == lt || tolerance <= 0.0f)
+	{
+		fprintf(stderr, "usage: %s [B|E|J|K|N|R|S|T [tolerance C] [linear|cubic] [aligned|uniform]]\n", argv[0]);
+		return 2;
+	}
+
+	ThermocoupleLookup lookup;
+	if (!lt->build(lookup, tolerance, order, aligned))
+	{
+		fprintf(stderr, "Type %s: no table meets %g C within 65535 intervals\n", lt->name, tolerance);
+		return 1;
+	}
+	emit(*lt, lookup, tolerance, aligned);
+	return 0;
+}
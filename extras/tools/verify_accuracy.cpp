@@ -0,0 +1,790 @@
+/*************************************************************************
+Title:    Thermocouple Accuracy Verification
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     verify_accuracy.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Checks every conversion path against the NIST ITS-90 reference
+    functions in extras/reference/nist_its90.h.
+
+    Each segment of each type's rational and polynomial tables is swept
+    densely in temperature, the reference voltage at each point is
+    converted by every path, and the result is compared with the
+    temperature it came from.  The double path and the paths built on it
+    use whichever tables the type was built with (see TC_TYPE_x_POLYNOMIAL
+    - make -C extras verify-polynomial checks the polynomial build); the
+    rational and polynomial paths check both tables in every build.  The cold
+    junction fits are swept over their segments with errors in uV, and the
+    forward (temperature to voltage) fits with errors converted to degrees
+    through the reference Seebeck coefficient.  For each path it reports:
+      - max and RMS error against NIST
+      - max difference from the path it approximates (the double path
+        for the fast paths, the per-sample path for the batch paths)
+      - the largest step against the reference's direction (monotonicity)
+    and for each type the fixed point path's largest difference from the
+    rationals at every 1/256 uV input it takes, the largest step between
+    neighbouring fits at their breakpoints (continuity), and how far getSensitivity()'s dT/dV strays
+    from the reference's 1/Seebeck - checked inside the range the README
+    calls usable, and reported outside it.
+
+    Every path has a declared error budget - the double paths against
+    NIST, the others against the path they approximate - and a limit on
+    backward steps.  The budgets against NIST are the accuracy the README
+    claims for each fit.  Apart from those, each type's current results
+    are pinned, to catch a changed coefficient.  The program exits
+    non-zero if any budget or pin is exceeded.
+
+    Built and run by extras/Makefile:
+      make -C extras verify     (or make -C extras, which also runs it)
+      extras/build/verify_accuracy [--segments] [--samples N]
+
+    --segments reports every segment separately.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../reference/nist_its90.h"
+#include "Thermocouple.h"
+#include "ThermocoupleFixed.h"
+#include "ThermocoupleKernel.h"
+#include "ThermocoupleLookup.h"
+
+// Type B's Seebeck coefficient passes through zero near 21C, so forward
+// errors are converted to degrees with at least this sensitivity (mV/C)
+#define VERIFY_MIN_SEEBECK 0.0001
+
+// The forward and cold junction tables' target against NIST (C), from
+// fit_forward.cpp
+#define VERIFY_FORWARD 0.001
+
+// The polynomial tables' target against NIST (C), from fit_polynomial.cpp.
+// Where the reference is steep a fit that close can also step back by as
+// much, so it's their limit on backward steps too.
+#define VERIFY_POLYNOMIAL 0.01
+
+// ThermocoupleFixed's bound against the double rationals (C), from the
+// README.  It holds at every 1/256 uV input, not just whole microvolts.
+#define VERIFY_FIXED 0.005
+
+// getSensitivity()'s dT/dV against the reference's 1/Seebeck (%), from the
+// README, inside each type's usable range (VerifyBudget) - rational and
+// polynomial tables
+#define VERIFY_SLOPE 1.0
+#define VERIFY_POLYNOMIAL_SLOPE 2.0
+
+// One way of converting an array of inputs.  baseline is the index of the
+// path this one is budgeted against, or -1 for NIST.  A negative budget is
+// reported but checked elsewhere.
+struct VerifyPath
+{
+	const char *name;
+	int baseline;
+	double budget;      // C, or uV for the cold junction
+	double backwards;   // largest allowed step against the reference's direction
+	void (*convert)(const double *in, double *out, size_t count);
+};
+
+// What the README claims for each type's Mosaic inverse fits against NIST,
+// in C, and the range in which it claims getSensitivity()'s dT/dV is
+// usable.  Outside it the fits' slopes stray (the cold ends, where the
+// Seebeck coefficient falls away, and one join in T's rationals), so the
+// slope is reported there but not checked.  The forward, cold junction,
+// polynomial, fixed point and slope claims are the same for every type.
+struct VerifyBudget
+{
+	double temperature;
+	double slopeFrom;   // C
+	double slopeTo;
+	double gapFrom;     // not usable between these either, if they differ
+	double gapTo;
+};
+
+// Regression pins - what the fits give now, against NIST.  They aren't
+// accuracy claims, just tripwires for a changed coefficient or evaluation,
+// and move when a table is deliberately changed.
+struct VerifyPins
+{
+	double temperature;   // rational mV to C (C)
+	double coldJunction;  // cold junction (uV)
+	double inverseStep;   // between neighbouring rational fits (C)
+	double forwardStep;   // between neighbouring forward fits (C)
+};
+
+struct VerifyStats
+{
+	double maxError;
+	double sumSquares;
+	double maxDeviation;
+	size_t count;
+	double backwards;   // largest step against the reference's direction
+};
+
+static size_t samplesPerSegment = 20000;
+static bool perSegment = false;
+static int failures = 0;
+
+/*********************************************************************************************************
+Paths
+*********************************************************************************************************/
+
+template<ThermocoupleType Type> struct VerifyPaths
+{
+	typedef Thermocouple<Type> Double;
+	typedef Thermocouple<Type, float> Single;
+	typedef Thermocouple<Type, double, false> Rational;
+	typedef Thermocouple<Type, double, true> Polynomial;
+	typedef Thermocouple<Type, float, true> PolynomialSingle;
+
+	// Millivolts to temperature
+	static void temperatureDouble(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = Double::computeTemperature(mv[i]);
+	}
+
+	static void temperatureFloat(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = Single::computeTemperature((float)mv[i]);
+	}
+
+	static void temperatureRational(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = Rational::computeTemperature(mv[i]);
+	}
+
+	static void temperaturePolynomial(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = Polynomial::computeTemperature(mv[i]);
+	}
+
+	static void temperaturePolynomialFloat(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = PolynomialSingle::computeTemperature((float)mv[i]);
+	}
+
+	// The rationals at the 1/256 uV steps the fixed path takes
+	static void temperatureRationalFixedInput(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = Rational::computeTemperature(lround(mv[i] * 256000.0) / 256000.0);
+	}
+
+	static void temperatureFixed(const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = ThermocoupleFixed<Type>::computeTemperature((int32_t)lround(mv[i] * 256000.0)) / 1000.0;
+	}
+
+	static void temperatureLookup(ThermocoupleLookup *lookup, const double *mv, double *t, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			t[i] = lookup->computeTemperature((float)mv[i]);
+	}
+
+	static void temperatureLookupLinear(const double *mv, double *t, size_t n)
+	{
+		static ThermocoupleLookup lookup;
+		if (NULL == lookup.table()->breakpoints)
+			lookup.build<Type>(0.01f, TC_LOOKUP_LINEAR);
+		temperatureLookup(&lookup, mv, t, n);
+	}
+
+	static void temperatureLookupCubic(const double *mv, double *t, size_t n)
+	{
+		static ThermocoupleLookup lookup;
+		if (NULL == lookup.table()->breakpoints)
+			lookup.build<Type>(0.01f, TC_LOOKUP_CUBIC);
+		temperatureLookup(&lookup, mv, t, n);
+	}
+
+	// Batch kernels, through convert() with a zero cold junction voltage
+	static void temperatureBatch(const double *mv, double *t, size_t n)
+	{
+		const ThermocoupleColdJunction<double> none = { 0.0, 0.0, TC_STATUS_OK };
+		thermocouple().convert(none, mv, t, n);
+	}
+
+	static void temperatureBatchFloat(const double *mv, double *t, size_t n)
+	{
+		const ThermocoupleColdJunction<float> none = { 0.0f, 0.0f, TC_STATUS_OK };
+		std::vector<float> in(mv, mv + n), out(n);
+		thermocouple().convert(none, in.data(), out.data(), n);
+		widen(out, t);
+	}
+
+	// getSensitivities() at a 0C cold junction, keeping the temperature
+	static void temperatureSensitivity(const double *mv, double *t, size_t n)
+	{
+		std::vector<double> Tcj(n, 0.0);
+		thermocouple().getSensitivities(mv, Tcj.data(), 0.0, 0.0, t, NULL, NULL, n);
+	}
+
+	static void temperatureSensitivityFloat(const double *mv, double *t, size_t n)
+	{
+		std::vector<float> in(mv, mv + n), Tcj(n, 0.0f), out(n);
+		thermocouple().getSensitivities(in.data(), Tcj.data(), 0.0f, 0.0f, out.data(), NULL, NULL, n);
+		widen(out, t);
+	}
+
+	// Raw ADC codes, on a 30 bit scale with an offset and gain so the
+	// quantization (under 0.001 uV) stays out of the comparison
+	static void adcCodes(const double *mv, int32_t *codes, double Vcj, size_t n)
+	{
+		const ThermocoupleAdcScale &scale = adcScale();
+		double perCode = scale.referenceMillivolts / (scale.gain * scale.fullScale);
+		for (size_t i = 0; i < n; i++)
+			codes[i] = scale.offset + (int32_t)lround((mv[i] - Vcj) / perCode);
+	}
+
+	static const ThermocoupleAdcScale &adcScale()
+	{
+		static const ThermocoupleAdcScale scale = { 2048.0, 2.0, 1234, 1L << 30 };
+		return scale;
+	}
+
+	static void temperatureAdc(const double *mv, double *t, size_t n)
+	{
+		TypedThermocouple<Type> &tc = thermocouple();
+		ThermocoupleAdcChannel<double> channel = tc.getAdcChannel(adcScale(), 0.0);
+		std::vector<int32_t> codes(n);
+		adcCodes(mv, codes.data(), tc.getColdJunction(0.0).millivolts, n);
+		tc.convert(channel, codes.data(), t, n);
+	}
+
+	static void temperatureAdcFloat(const double *mv, double *t, size_t n)
+	{
+		TypedThermocouple<Type> &tc = thermocouple();
+		ThermocoupleAdcChannel<float> channel = tc.getAdcChannel(adcScale(), 0.0f);
+		std::vector<int32_t> codes(n);
+		std::vector<float> out(n);
+		adcCodes(mv, codes.data(), tc.getColdJunction(0.0).millivolts, n);
+		tc.convert(channel, codes.data(), out.data(), n);
+		widen(out, t);
+	}
+
+	// Calibrated batch kernels, fed readings the calibration's gain and offset
+	// map back onto mv, with the constant deviation term taken off again
+	static const ThermocoupleCalibration<double> &calibration()
+	{
+		static const ThermocoupleCalibration<double> c = { -0.0021, 1.00037, { 0.25, 0.0, 0.0, 0.0 } };
+		return c;
+	}
+
+	static void temperatureCalibrated(const double *mv, double *t, size_t n)
+	{
+		const ThermocoupleColdJunction<double> none = { 0.0, 0.0, TC_STATUS_OK };
+		const ThermocoupleCalibration<double> &c = calibration();
+		std::vector<double> raw(n);
+		for (size_t i = 0; i < n; i++)
+			raw[i] = (mv[i] - c.offset) / c.gain;
+		thermocouple().convert(none, c, raw.data(), t, n);
+		for (size_t i = 0; i < n; i++)
+			if (TC_OUT_OF_RANGE_TEMPERATURE != t[i])
+				t[i] -= c.deviation[0];
+	}
+
+	static void temperatureCalibratedFloat(const double *mv, double *t, size_t n)
+	{
+		const ThermocoupleColdJunction<float> none = { 0.0f, 0.0f, TC_STATUS_OK };
+		const ThermocoupleCalibration<double> &c = calibration();
+		const ThermocoupleCalibration<float> single = { (float)c.offset, (float)c.gain, { (float)c.deviation[0], 0.0f, 0.0f, 0.0f } };
+		std::vector<float> raw(n), out(n);
+		for (size_t i = 0; i < n; i++)
+			raw[i] = (float)((mv[i] - c.offset) / c.gain);
+		thermocouple().convert(none, single, raw.data(), out.data(), n);
+		widen(out, t);
+		for (size_t i = 0; i < n; i++)
+			if (TC_OUT_OF_RANGE_TEMPERATURE != t[i])
+				t[i] -= c.deviation[0];
+	}
+
+	// Cold junction temperature to millivolts
+	static void coldJunctionDouble(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = Double::computeColdJunctionVoltage(t[i]);
+	}
+
+	static void coldJunctionFloat(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = Single::computeColdJunctionVoltage((float)t[i]);
+	}
+
+	// The double path at the whole millidegrees the fixed path takes, so the
+	// fixed path isn't charged for the rounding of its input
+	static void coldJunctionMillidegrees(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = Double::computeColdJunctionVoltage(lround(t[i] * 1000.0) / 1000.0);
+	}
+
+	static void coldJunctionFixed(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = ThermocoupleFixed<Type>::computeColdJunctionVoltage((int32_t)lround(t[i] * 1000.0)) / 256000.0;
+	}
+
+	// Temperature to millivolts
+	static void voltageDouble(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = Double::computeVoltage(t[i]);
+	}
+
+	static void voltageFloat(const double *t, double *mv, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			mv[i] = Single::computeVoltage((float)t[i]);
+	}
+
+	static void voltageBatch(const double *t, double *mv, size_t n)
+	{
+		thermocouple().getVoltages(t, NULL, mv, n);
+	}
+
+	static void voltageBatchFloat(const double *t, double *mv, size_t n)
+	{
+		std::vector<float> in(t, t + n), out(n);
+		thermocouple().getVoltages(in.data(), NULL, out.data(), n);
+		widen(out, mv);
+	}
+
+	// A float path's results, widened into the array the sweep compares
+	static void widen(const std::vector<float> &from, double *to)
+	{
+		std::copy(from.begin(), from.end(), to);
+	}
+
+	// The one TypeX object every path that needs one shares
+	static TypedThermocouple<Type> &thermocouple();
+};
+
+template<> TypedThermocouple<ThermocoupleType::B> &VerifyPaths<ThermocoupleType::B>::thermocouple() { static TypeB tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::E> &VerifyPaths<ThermocoupleType::E>::thermocouple() { static TypeE tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::J> &VerifyPaths<ThermocoupleType::J>::thermocouple() { static TypeJ tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::K> &VerifyPaths<ThermocoupleType::K>::thermocouple() { static TypeK tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::N> &VerifyPaths<ThermocoupleType::N>::thermocouple() { static TypeN tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::R> &VerifyPaths<ThermocoupleType::R>::thermocouple() { static TypeR tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::S> &VerifyPaths<ThermocoupleType::S>::thermocouple() { static TypeS tc; return tc; }
+template<> TypedThermocouple<ThermocoupleType::T> &VerifyPaths<ThermocoupleType::T>::thermocouple() { static TypeT tc; return tc; }
+
+/*********************************************************************************************************
+Sweeps
+*********************************************************************************************************/
+
+static void accumulate(VerifyStats *total, const VerifyStats &part)
+{
+	total->maxError = fmax(total->maxError, part.maxError);
+	total->maxDeviation = fmax(total->maxDeviation, part.maxDeviation);
+	total->sumSquares += part.sumSquares;
+	total->count += part.count;
+	total->backwards = fmax(total->backwards, part.backwards);
+}
+
+static void report(const char *type, const char *direction, const char *segment, const VerifyPath &path, const VerifyPath *paths, const VerifyStats &stats, bool check)
+{
+	double checked = (path.baseline < 0) ? stats.maxError : stats.maxDeviation;
+	bool pass = (path.budget < 0.0 || checked <= path.budget) && (stats.backwards <= path.backwards);
+	char budget[16] = "-";
+
+	if (path.budget >= 0.0)
+		snprintf(budget, sizeof(budget), "%10.6f", path.budget);
+	printf("%-4s %-9s %-14s %-4s %10.6f %10.6f  %-8s %10.6f %10s %10.6f  %s\n", type, direction, path.name, segment,
+		stats.maxError, sqrt(stats.sumSquares / stats.count),
+		(path.baseline < 0) ? "NIST" : paths[path.baseline].name, checked, budget, stats.backwards,
+		check ? (pass ? "ok" : "FAIL") : "");
+	if (check && !pass)
+		failures++;
+}
+
+// One figure checked against a limit - a step, a slope or a pin.  A
+// negative limit is reported but not checked.
+static void check(const char *type, const char *direction, const char *name, const char *segment, const char *against, double value, double limit)
+{
+	bool pass = limit < 0.0 || value <= limit;
+	char shown[16] = "-";
+
+	if (limit >= 0.0)
+		snprintf(shown, sizeof(shown), "%10.6f", limit);
+	printf("%-4s %-9s %-14s %-4s %10s %10s  %-8s %10.6f %10s %10s  %s\n", type, direction, name, segment, "", "", against, value, shown, "",
+		(limit < 0.0) ? "" : (pass ? "ok" : "FAIL"));
+	if (!pass)
+		failures++;
+}
+
+static void check(const char *type, const char *direction, const char *name, const char *against, double value, double limit)
+{
+	check(type, direction, name, "", against, value, limit);
+}
+
+// What a sweep feeds the paths and how its errors are reported
+enum VerifyDirection
+{
+	VERIFY_TEMPERATURE,     // mV in, C out, errors in C
+	VERIFY_COLD_JUNCTION,   // C in, mV out, errors in uV
+	VERIFY_VOLTAGE          // C in, mV out, errors in C through the Seebeck coefficient
+};
+
+// Sweep one direction.  ranges[s]..ranges[s+1] is segment s in temperature.
+// Returns each path's totals.
+static std::vector<VerifyStats> sweep(const char *type, const char *direction, const NistReference *ref, const std::vector<double> &ranges,
+	const VerifyPath *paths, size_t pathCount, VerifyDirection mode)
+{
+	const size_t segments = ranges.size() - 1;
+	std::vector<VerifyStats> totals(pathCount);
+	std::vector<double> in(samplesPerSegment), expected(samplesPerSegment), scale(samplesPerSegment);
+	std::vector<std::vector<double> > out(pathCount, std::vector<double>(samplesPerSegment));
+	size_t p, i, s;
+
+	memset(totals.data(), 0, sizeof(VerifyStats) * pathCount);
+	for (s = 0; s < segments; s++)
+	{
+		std::vector<VerifyStats> stats(pathCount);
+		memset(stats.data(), 0, sizeof(VerifyStats) * pathCount);
+
+		// Interior points only - the ends belong to one segment or the other
+		for (i = 0; i < samplesPerSegment; i++)
+		{
+			double t = ranges[s] + (ranges[s + 1] - ranges[s]) * (i + 0.5) / samplesPerSegment;
+			in[i] = (VERIFY_TEMPERATURE == mode) ? nistVoltage(ref, t) : t;
+			expected[i] = (VERIFY_TEMPERATURE == mode) ? t : nistVoltage(ref, t);
+			if (VERIFY_TEMPERATURE == mode)
+				scale[i] = 1.0;
+			else if (VERIFY_COLD_JUNCTION == mode)
+				scale[i] = 1000.0;
+			else
+				scale[i] = 1.0 / fmax(fabs(nistSeebeck(ref, t)), VERIFY_MIN_SEEBECK);
+		}
+		for (p = 0; p < pathCount; p++)
+			paths[p].convert(in.data(), out[p].data(), samplesPerSegment);
+
+		for (p = 0; p < pathCount; p++)
+		{
+			const std::vector<double> &y = out[p];
+			for (i = 0; i < samplesPerSegment; i++)
+			{
+				double err = fabs(y[i] - expected[i]) * scale[i];
+				stats[p].maxError = fmax(stats[p].maxError, err);
+				stats[p].sumSquares += err * err;
+				if (paths[p].baseline >= 0)
+					stats[p].maxDeviation = fmax(stats[p].maxDeviation, fabs(y[i] - out[paths[p].baseline][i]) * scale[i]);
+				// Steps against the reference's direction, within the segment
+				// (steps between segments are reported as continuity)
+				if (i > 0 && (y[i] - y[i - 1]) * (expected[i] - expected[i - 1]) < 0.0)
+					stats[p].backwards = fmax(stats[p].backwards, fabs(y[i] - y[i - 1]) * scale[i]);
+			}
+			stats[p].count = samplesPerSegment;
+			accumulate(&totals[p], stats[p]);
+		}
+
+		if (perSegment)
+		{
+			char name[24];
+			snprintf(name, sizeof(name), "%zu", s + 1);
+			for (p = 0; p < pathCount; p++)
+				report(type, direction, name, paths[p], paths, stats[p], false);
+		}
+	}
+
+	for (p = 0; p < pathCount; p++)
+		report(type, direction, "all", paths[p], paths, totals[p], true);
+	return totals;
+}
+
+// A millivolt-to-temperature table's segments in temperature
+template<typename Tables> static std::vector<double> temperatureRanges(const NistReference *ref)
+{
+	std::vector<double> ranges;
+	for (uint8_t s = 0; s <= Tables::segments; s++)
+		ranges.push_back(nistTemperature(ref, Tables::breakpoints[s]));
+	return ranges;
+}
+
+// Largest step between neighbouring segments of Conversion at their breakpoints
+template<typename Conversion> static double inverseStep()
+{
+	typedef typename Conversion::Tables Tables;
+	double step = 0.0;
+	for (uint8_t s = 1; s < Tables::segments; s++)
+	{
+		double mv = Tables::breakpoints[s];
+		step = fmax(step, fabs(Conversion::evaluateSegment(mv, s) - Conversion::evaluateSegment(mv, s - 1)));
+	}
+	return step;
+}
+
+// Largest difference between the fixed point path and the double rationals
+// at every 1/256 uV input in the fixed tables' range
+template<ThermocoupleType Type> static double fixedDeviation()
+{
+	typedef ThermocoupleFixed<Type> Fixed;
+	typedef typename VerifyPaths<Type>::Rational Rational;
+	const uint8_t segments = ThermocoupleCoefficients<Type, double>::segments;
+	double deviation = 0.0;
+
+	for (int32_t v = Fixed::Tables::breakpoints[0]; v <= Fixed::Tables::breakpoints[segments]; v++)
+	{
+		int32_t t = Fixed::computeTemperature(v);
+		double expected = Rational::computeTemperature(v / TC_FIXED_VOLTAGE_SCALE);
+		if (TC_FIXED_OUT_OF_RANGE != t && TC_OUT_OF_RANGE_TEMPERATURE != expected)
+			deviation = fmax(deviation, fabs(t / TC_FIXED_TEMPERATURE_SCALE - expected));
+	}
+	return deviation;
+}
+
+template<ThermocoupleType Type> static void verifyType(const char *type, const VerifyBudget &budget, const VerifyPins &pins)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	typedef typename Thermocouple<Type>::Tables Tables;
+	typedef VerifyPaths<Type> Paths;
+	const NistReference *ref = NULL;
+	std::vector<double> ranges;
+	std::vector<VerifyStats> totals;
+	uint8_t s;
+
+	for (size_t r = 0; r < NIST_TYPES; r++)
+		if (0 == strcmp(nistReference[r].name, type))
+			ref = &nistReference[r];
+
+	// Millivolts to temperature, over the segments of the tables the type was
+	// built with.  Beyond the double path the budgets are each fast path's
+	// own: single precision at the E and K cold ends (where it also wobbles
+	// by a few hundredths), the lookup tables' build tolerance, bit-identical
+	// batch kernels, the cold junction fit's residual at 0C (which the
+	// sensitivity paths add back in), ADC codes quantized to under 0.001 uV,
+	// and the rounding of a calibration's gain and offset.  The paths built
+	// on the double one inherit its backward steps.
+	const double wobble = Tables::degree ? VERIFY_POLYNOMIAL : 0.0;
+	const VerifyPath temperaturePaths[] =
+	{
+		{ "double", -1, Tables::degree ? VERIFY_POLYNOMIAL : budget.temperature, wobble, &Paths::temperatureDouble },
+		{ "float", 0, 0.03, 0.03, &Paths::temperatureFloat },
+		{ "lookup linear", 0, 0.01, wobble, &Paths::temperatureLookupLinear },
+		{ "lookup cubic", 0, 0.01, wobble, &Paths::temperatureLookupCubic },
+		{ "batch", 0, 0.0, wobble, &Paths::temperatureBatch },
+		{ "batch float", 1, 0.0, 0.03, &Paths::temperatureBatchFloat },
+		{ "sensitivity", 0, 0.001, wobble, &Paths::temperatureSensitivity },
+		{ "sensitivity float", 1, 0.04, 0.03, &Paths::temperatureSensitivityFloat },
+		{ "adc", 0, 0.001, wobble, &Paths::temperatureAdc },
+		{ "adc float", 0, 0.03, 0.035, &Paths::temperatureAdcFloat },
+		{ "calibrated", 0, 0.000001, wobble, &Paths::temperatureCalibrated },
+		{ "calibrated float", 0, 0.03, 0.035, &Paths::temperatureCalibratedFloat },
+	};
+	ranges = temperatureRanges<Tables>(ref);
+	sweep(type, "mV to C", ref, ranges, temperaturePaths, sizeof(temperaturePaths) / sizeof(temperaturePaths[0]), VERIFY_TEMPERATURE);
+
+	// Both sets of tables whichever the type was built with, each over its own
+	// segments.  The fixed point tables are always the rationals, to within
+	// integer rounding, and are held against them at the same 1/256 uV input.
+	// Where the fit is steep that rounding can also step back, by as much.
+	const VerifyPath rationalPaths[] =
+	{
+		{ "rational", -1, budget.temperature, 0.0, &Paths::temperatureRational },
+		{ "rounded", 0, -1.0, 0.0, &Paths::temperatureRationalFixedInput },
+		{ "fixed", 1, VERIFY_FIXED, VERIFY_FIXED, &Paths::temperatureFixed },
+	};
+	ranges = temperatureRanges<typename Paths::Rational::Tables>(ref);
+	totals = sweep(type, "mV to C", ref, ranges, rationalPaths, sizeof(rationalPaths) / sizeof(rationalPaths[0]), VERIFY_TEMPERATURE);
+
+	const VerifyPath polynomialPaths[] =
+	{
+		{ "polynomial", -1, VERIFY_POLYNOMIAL, VERIFY_POLYNOMIAL, &Paths::temperaturePolynomial },
+		{ "poly float", 0, 0.001, VERIFY_POLYNOMIAL, &Paths::temperaturePolynomialFloat },
+	};
+	ranges = temperatureRanges<typename Paths::Polynomial::Tables>(ref);
+	sweep(type, "mV to C", ref, ranges, polynomialPaths, sizeof(polynomialPaths) / sizeof(polynomialPaths[0]), VERIFY_TEMPERATURE);
+
+	double rationalError = totals[0].maxError;
+
+	// Cold junction, in uV, over each cold junction segment.  The integer
+	// path takes whole millidegrees and steps in 1/256 uV, so it's held
+	// against the double path at the same millidegrees.  The double path's
+	// claim is in degrees, like the forward fits', so it's checked in a
+	// sweep of its own.
+	const VerifyPath coldJunctionPaths[] =
+	{
+		{ "double", -1, -1.0, 0.0, &Paths::coldJunctionDouble },
+		{ "float", 0, 0.005, 0.005, &Paths::coldJunctionFloat },
+		{ "rounded", 0, -1.0, 0.005, &Paths::coldJunctionMillidegrees },
+		{ "fixed", 2, 0.025, 0.005, &Paths::coldJunctionFixed },
+	};
+	ranges.clear();
+	for (s = 0; s <= Coefficients::coldJunctionSegments; s++)
+		ranges.push_back(Coefficients::coldJunctionBreakpoints[s]);
+	totals = sweep(type, "CJ uV", ref, ranges, coldJunctionPaths, sizeof(coldJunctionPaths) / sizeof(coldJunctionPaths[0]), VERIFY_COLD_JUNCTION);
+	double coldJunctionError = totals[0].maxError;
+
+	const VerifyPath coldJunctionDegrees[] =
+	{
+		{ "double", -1, VERIFY_FORWARD, 0.0, &Paths::coldJunctionDouble },
+	};
+	sweep(type, "CJ C", ref, ranges, coldJunctionDegrees, 1, VERIFY_VOLTAGE);
+
+	const VerifyPath voltagePaths[] =
+	{
+		{ "double", -1, VERIFY_FORWARD, 0.0, &Paths::voltageDouble },
+		{ "float", 0, 0.002, 0.001, &Paths::voltageFloat },
+		{ "batch", 0, 0.0, 0.0, &Paths::voltageBatch },
+		{ "batch float", 1, 0.0, 0.001, &Paths::voltageBatchFloat },
+	};
+	ranges.clear();
+	for (s = 0; s <= Coefficients::forwardSegments; s++)
+		ranges.push_back(Coefficients::forwardBreakpoints[s]);
+	sweep(type, "C to mV", ref, ranges, voltagePaths, sizeof(voltagePaths) / sizeof(voltagePaths[0]), VERIFY_VOLTAGE);
+
+	// Step between neighbouring fits at each interior breakpoint, in degrees.
+	// Two fits each within their claim can be up to twice it apart.
+	double rationalStep = inverseStep<typename Paths::Rational>();
+	double polynomialStep = inverseStep<typename Paths::Polynomial>();
+	double forwardStep = 0.0;
+	for (s = 1; s < Coefficients::forwardSegments; s++)
+	{
+		double t = Coefficients::forwardBreakpoints[s];
+		double below = tcEvaluateSegment<TC_COEFF_T0, TC_COEFF_V0>(Coefficients::forwardCoefficients, Coefficients::forwardSegments, s - 1, t);
+		double above = tcEvaluateSegment<TC_COEFF_T0, TC_COEFF_V0>(Coefficients::forwardCoefficients, Coefficients::forwardSegments, s, t);
+		forwardStep = fmax(forwardStep, fabs(above - below) / nistSeebeck(ref, t));
+	}
+
+	// getSensitivity()'s dT/dV against the reference's 1/Seebeck, in percent,
+	// inside the usable range and outside it.  The fits were made for
+	// temperature, so their slopes stray most where the Seebeck coefficient
+	// falls away at the ends of the ranges.  Some tables run past the
+	// reference (K's to 69.553mV), and there's nothing to compare with.
+	TypedThermocouple<Type> &tc = Paths::thermocouple();
+	double referenceLo = nistVoltage(ref, nistMinTemperature(ref)), referenceHi = nistVoltage(ref, nistMaxTemperature(ref));
+	double slopeError = 0.0, unusableError = 0.0;
+	double slopeBudget = Tables::degree ? VERIFY_POLYNOMIAL_SLOPE : VERIFY_SLOPE;
+	for (s = 0; s < Tables::segments; s++)
+	{
+		double lo = Tables::breakpoints[s], hi = Tables::breakpoints[s + 1];
+		double segmentError = 0.0;
+		for (size_t i = 0; i < samplesPerSegment; i++)
+		{
+			double mv = lo + (hi - lo) * (i + 0.5) / samplesPerSegment;
+			if (mv < referenceLo || mv > referenceHi)
+				continue;
+			double t = nistTemperature(ref, mv);
+			ThermocoupleSensitivity<double> sensitivity = tc.getSensitivity(mv, 0.0);
+			double slope = 1.0 / nistSeebeck(ref, t);
+			double error = 100.0 * fabs(sensitivity.slope - slope) / slope;
+			if (TC_OUT_OF_RANGE_TEMPERATURE == sensitivity.temperature)
+				continue;
+			if (t < budget.slopeFrom || t > budget.slopeTo || (t > budget.gapFrom && t < budget.gapTo))
+				unusableError = fmax(unusableError, error);
+			else
+				segmentError = fmax(segmentError, error);
+		}
+		if (perSegment)
+		{
+			char segment[8];
+			snprintf(segment, sizeof(segment), "%u", (unsigned)s);
+			check(type, "mV to C", "dT/dV %", segment, "NIST", segmentError, -1.0);
+		}
+		slopeError = fmax(slopeError, segmentError);
+	}
+
+	double fixedError = fixedDeviation<Type>();
+
+	check(type, "mV to C", "fixed 1/256uV", "rational", fixedError, VERIFY_FIXED);
+	check(type, "mV to C", "breakpoints", "step", rationalStep, 2.0 * budget.temperature);
+	check(type, "mV to C", "poly breaks", "step", polynomialStep, 2.0 * VERIFY_POLYNOMIAL);
+	check(type, "C to mV", "breakpoints", "step", forwardStep, 2.0 * VERIFY_FORWARD);
+	check(type, "mV to C", "dT/dV %", "NIST", slopeError, slopeBudget);
+	check(type, "mV to C", "dT/dV % unused", "NIST", unusableError, -1.0);
+
+	check(type, "mV to C", "rational", "pin", rationalError, pins.temperature);
+	check(type, "CJ uV", "double", "pin", coldJunctionError, pins.coldJunction);
+	check(type, "mV to C", "breakpoints", "pin", rationalStep, pins.inverseStep);
+	check(type, "C to mV", "breakpoints", "pin", forwardStep, pins.forwardStep);
+}
+
+// The Mosaic inverse fits' accuracy as the README states it: 0.05C for B,
+// J, K and T, 0.1C for R and S (worst near 1768C) and 0.4C for E and N
+// (worst below -200C), and where it states getSensitivity()'s slope is usable
+static const VerifyBudget budgets[] =
+{
+	// mV to C   dT/dV usable (C)   gap (C)
+	{ 0.05,      0,    1820,        0,    0    },  // B
+	{ 0.4,       -230, 1000,        0,    0    },  // E
+	{ 0.05,      -210, 1200,        0,    0    },  // J
+	{ 0.05,      -215, 1372,        0,    0    },  // K
+	{ 0.4,       -215, 1300,        0,    0    },  // N
+	{ 0.1,       -50,  1760,        0,    0    },  // R
+	{ 0.1,       -50,  1760,        0,    0    },  // S
+	{ 0.05,      -210, 400,         -151, -149 },  // T
+};
+
+// The current results, a little over - see VerifyPins
+static const VerifyPins pins[] =
+{
+	// mV to C   CJ uV      steps (inverse, forward)
+	{ 0.0275,    0.00002,   0.0201, 0.0006   },  // B
+	{ 0.355,     0.0084,    0.0043, 0.00095  },  // E
+	{ 0.0083,    0.0002,    0.0040, 0.00088  },  // J
+	{ 0.0305,    0.0355,    0.0146, 0.00092  },  // K
+	{ 0.195,     0.00065,   0.0027, 0.00065  },  // N
+	{ 0.097,     0.000025,  0.0108, 0.00135  },  // R
+	{ 0.072,     0.00001,   0.0040, 0.00094  },  // S
+	{ 0.0188,    0.0205,    0.0272, 0.00088  },  // T
+};
+
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "--segments"))
+			perSegment = true;
+		else if (0 == strcmp(argv[i], "--samples") && i + 1 < argc)
+			samplesPerSegment = strtoul(argv[++i], NULL, 0);
+		else
+		{
+			fprintf(stderr, "usage: %s [--segments] [--samples N per segment]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (samplesPerSegment < 2)
+	{
+		fprintf(stderr, "need at least 2 samples per segment\n");
+		return 2;
+	}
+
+	printf("%-4s %-9s %-14s %-4s %10s %10s  %-8s %10s %10s %10s\n", "type", "direction", "path", "seg", "max err", "rms err", "vs", "max", "budget", "backwards");
+
+	verifyType<ThermocoupleType::B>("B", budgets[0], pins[0]);
+	verifyType<ThermocoupleType::E>("E", budgets[1], pins[1]);
+	verifyType<ThermocoupleType::J>("J", budgets[2], pins[2]);
+	verifyType<ThermocoupleType::K>("K", budgets[3], pins[3]);
+	verifyType<ThermocoupleType::N>("N", budgets[4], pins[4]);
+	verifyType<ThermocoupleType::R>("R", budgets[5], pins[5]);
+	verifyType<ThermocoupleType::S>("S", budgets[6], pins[6]);
+	verifyType<ThermocoupleType::T>("T", budgets[7], pins[7]);
+
+	printf("\n%s - %d check%s failed\n", failures ? "FAIL" : "PASS", failures, (1 == failures) ? "" : "s");
+	return failures ? 1 : 0;
+}
@@ -28,728 +28,1071 @@ LICENSE:
 
 *************************************************************************/
 
+#include <math.h>
+#include <string.h>
 #include "Thermocouple.h"
+#include "ThermocoupleKernel.h"
+#include "ThermocoupleFlash.h"
+
+constexpr double AbstractThermocouple::TCOUPLE_OUT_OF_RANGE;
+
+#if defined(__AVR__)
+float tcTableRead(const float *p)
+{
+	float value;
+	memcpy_P(&value, p, sizeof(value));
+	return value;
+}
+
+double tcTableRead(const double *p)
+{
+	double value;
+	memcpy_P(&value, p, sizeof(value));
+	return value;
+}
+#endif
+
+#if defined(TC_PROFILE)
+// A TypeX conversion counted and timed into its type's profile, along with
+// the segment the reading fell in.  C is the precision the conversion
+// evaluates in (double on AVR, for float readings too).
+template<typename Conversion, typename T> static T tcProfileTemperature(ThermocoupleProfile *profile, const ThermocoupleSegmentTable *table, T millivolts)
+{
+	typedef decltype(Conversion::computeTemperature(millivolts)) C;
+	uint32_t start = tcProfileTicks();
+	T temperature = Conversion::computeTemperature(millivolts);
+	uint8_t seg;
+
+	tcProfileCount(&profile->temperature, tcProfileTicks() - start);
+	if (tcTemperatureSegment(tcBreakpoints(table, C()), table->segments, table->upperInclusive, (C)millivolts, &seg))
+		profile->segmentCalls[seg]++;
+	else if ((C)millivolts < tcTableRead(&tcBreakpoints(table, C())[0]))
+		profile->underRange++;
+	else
+		profile->overRange++;
+	return temperature;
+}
+
+template<typename Conversion, typename T> static T tcProfileColdJunction(ThermocoupleProfile *profile, T Tcj)
+{
+	uint32_t start = tcProfileTicks();
+	T Vcj = Conversion::computeColdJunctionVoltage(Tcj);
+
+	tcProfileCount(&profile->coldJunction, tcProfileTicks() - start);
+	return Vcj;
+}
+
+template<typename T> static T tcProfileConversion(ThermocoupleProfile *profile, uint32_t start, T temperature)
+{
+	tcProfileCount(&profile->conversion, tcProfileTicks() - start);
+	return temperature;
+}
+
+#define TC_PROFILE_TEMPERATURE(Conversion, profile, table, millivolts) tcProfileTemperature<Conversion>(&(profile), &(table), millivolts)
+#define TC_PROFILE_COLD_JUNCTION(Conversion, profile, Tcj) tcProfileColdJunction<Conversion>(&(profile), Tcj)
+#else
+// Without TC_PROFILE the plain conversions, and no counters exist
+#define TC_PROFILE_TEMPERATURE(Conversion, profile, table, millivolts) Conversion::computeTemperature(millivolts)
+#define TC_PROFILE_COLD_JUNCTION(Conversion, profile, Tcj) Conversion::computeColdJunctionVoltage(Tcj)
+#endif
 
 float AbstractThermocouple::getTemperature(float millivolts, float Tcj)
 {
-	return (float)this->getTemperature((double)millivolts, (double)Tcj);
+#if defined(TC_PROFILE)
+	uint32_t start = tcProfileTicks();
+	float Vcj = this->computeColdJunctionVoltage(Tcj);
+	return tcProfileConversion(this->profile(), start, this->computeTemperature(millivolts + Vcj));
+#else
+	float Vcj = this->computeColdJunctionVoltage(Tcj);
+	return this->computeTemperature(millivolts + Vcj);
+#endif
 }
 
 double AbstractThermocouple::getTemperature(double millivolts, double Tcj)
 {
+#if defined(TC_PROFILE)
+	uint32_t start = tcProfileTicks();
+	double Vcj = this->computeColdJunctionVoltage(Tcj);
+	return tcProfileConversion(this->profile(), start, this->computeTemperature(millivolts + Vcj));
+#else
 	double Vcj = this->computeColdJunctionVoltage(Tcj);
 	return this->computeTemperature(millivolts + Vcj);
+#endif
+}
+
+ThermocoupleColdJunction<float> AbstractThermocouple::getColdJunction(float Tcj)
+{
+	ThermocoupleColdJunction<float> coldJunction = { Tcj, this->computeColdJunctionVoltage(Tcj), tcColdJunctionStatus<tc_single_t>(this->temperatureTable(), Tcj) };
+	return coldJunction;
+}
+
+ThermocoupleColdJunction<double> AbstractThermocouple::getColdJunction(double Tcj)
+{
+	ThermocoupleColdJunction<double> coldJunction = { Tcj, this->computeColdJunctionVoltage(Tcj), tcColdJunctionStatus(this->temperatureTable(), Tcj) };
+	return coldJunction;
+}
+
+float AbstractThermocouple::convert(const ThermocoupleColdJunction<float> &coldJunction, float millivolts)
+{
+	return this->computeTemperature(millivolts + coldJunction.millivolts);
+}
+
+double AbstractThermocouple::convert(const ThermocoupleColdJunction<double> &coldJunction, double millivolts)
+{
+	return this->computeTemperature(millivolts + coldJunction.millivolts);
+}
+
+ThermocoupleResult<float> AbstractThermocouple::getResult(float millivolts, float Tcj)
+{
+	return this->getResult(this->getColdJunction(Tcj), millivolts);
+}
+
+ThermocoupleResult<double> AbstractThermocouple::getResult(double millivolts, double Tcj)
+{
+	return this->getResult(this->getColdJunction(Tcj), millivolts);
+}
+
+ThermocoupleResult<float> AbstractThermocouple::getResult(const ThermocoupleColdJunction<float> &coldJunction, float millivolts)
+{
+	float compensated = millivolts + coldJunction.millivolts;
+	ThermocoupleResult<float> result;
+	result.temperature = this->computeTemperature(compensated);
+	// tc_single_t - the float tables are the double ones where the two are the same size
+	result.status = tcStatusScalar<tc_single_t>(this->temperatureTable(), millivolts, compensated) | coldJunction.status;
+	return result;
+}
+
+ThermocoupleResult<double> AbstractThermocouple::getResult(const ThermocoupleColdJunction<double> &coldJunction, double millivolts)
+{
+	double compensated = millivolts + coldJunction.millivolts;
+	ThermocoupleResult<double> result;
+	result.temperature = this->computeTemperature(compensated);
+	result.status = tcStatusScalar(this->temperatureTable(), millivolts, compensated) | coldJunction.status;
+	return result;
+}
+
+static int32_t tcAdcCode(double code)
+{
+	if (code > (double)TC_ADC_CODE_LIMIT)
+		return TC_ADC_CODE_LIMIT;
+	if (code < -(double)TC_ADC_CODE_LIMIT)
+		return -TC_ADC_CODE_LIMIT;
+	return (int32_t)code;
+}
+
+// Breakpoints and segment offsets moved from compensated millivolts to
+// codes.  A voltage above breakpoint b (at or above it, for types whose
+// segments are closed below) is a code above the threshold for b, so every
+// type's segments become (threshold[i], threshold[i + 1]].
+template<typename T> static ThermocoupleAdcChannel<T> tcAdcChannel(const ThermocoupleSegmentTable *table, const ThermocoupleAdcScale &scale, T Tcj, double Vcj)
+{
+	ThermocoupleAdcChannel<T> channel;
+	const uint8_t n = table->segments;
+	const double perCode = scale.referenceMillivolts / (scale.gain * (double)scale.fullScale);
+	uint8_t i;
+
+	channel.Tcj = Tcj;
+	channel.millivoltsPerCode = (T)perCode;
+	channel.status = tcColdJunctionStatus(table, (double)Tcj);
+	for (i = 0; i <= n; i++)
+	{
+		double code = scale.offset + (tcTableRead(&table->breakpoints[i]) - Vcj) / perCode;
+		channel.threshold[i] = tcAdcCode(table->upperInclusive ? floor(code) : ceil(code) - 1.0);
+	}
+	for (i = 0; i < n; i++)
+	{
+		double code = scale.offset + (tcTableRead(&table->coefficients[TC_COEFF_V0 * n + i]) - Vcj) / perCode;
+		channel.origin[i] = tcAdcCode(floor(code));
+		channel.fraction[i] = (T)((code - channel.origin[i]) * perCode);
+	}
+	return channel;
+}
+
+ThermocoupleAdcChannel<float> AbstractThermocouple::getAdcChannel(const ThermocoupleAdcScale &scale, float Tcj)
+{
+	return tcAdcChannel(this->temperatureTable(), scale, Tcj, this->computeColdJunctionVoltage((double)Tcj));
+}
+
+ThermocoupleAdcChannel<double> AbstractThermocouple::getAdcChannel(const ThermocoupleAdcScale &scale, double Tcj)
+{
+	return tcAdcChannel(this->temperatureTable(), scale, Tcj, this->computeColdJunctionVoltage(Tcj));
+}
+
+float AbstractThermocouple::convert(const ThermocoupleAdcChannel<float> &channel, int32_t code)
+{
+	return tcAdcTemperatureScalar<tc_single_t>(this->temperatureTable(), channel, code);
+}
+
+double AbstractThermocouple::convert(const ThermocoupleAdcChannel<double> &channel, int32_t code)
+{
+	return tcAdcTemperatureScalar<double>(this->temperatureTable(), channel, code);
 }
 
+float AbstractThermocouple::getTemperature(const ThermocoupleCalibration<float> &calibration, float millivolts, float Tcj)
+{
+	return this->convert(this->getColdJunction(Tcj), calibration, millivolts);
+}
 
-double AbstractThermocouple::computeColdJunction(double Tcj, 
-	const double T0,
-	const double V0,
-	const double p1,
-	const double p2,
-	const double p3,
-	const double p4,
-	const double q1,
-	const double q2)
+double AbstractThermocouple::getTemperature(const ThermocoupleCalibration<double> &calibration, double millivolts, double Tcj)
 {
-	
-#define numerator   ((Tcj - T0)*(p1 + (Tcj - T0)*(p2 + (Tcj - T0) * (p3 + p4*(Tcj - T0)))))
-#define denominator (1.0 + (Tcj - T0) * (q1 + q2*(Tcj - T0)))
-	return (V0 + (numerator / denominator));
-#undef numerator
-#undef denominator
+	return this->convert(this->getColdJunction(Tcj), calibration, millivolts);
 }
 
-double AbstractThermocouple::computeTemperatureInternal(double millivolts, 
-	const double T0,
-	const double V0,
-	const double p1,
-	const double p2,
-	const double p3,
-	const double p4,
-	const double q1,
-	const double q2,
-	const double q3)
+float AbstractThermocouple::convert(const ThermocoupleColdJunction<float> &coldJunction, const ThermocoupleCalibration<float> &calibration, float millivolts)
 {
-#define numerator ((millivolts - V0)*(p1 + (millivolts - V0)*(p2 + (millivolts - V0)*(p3 + p4*(millivolts-V0)))))
-#define denominator (1.0 + (millivolts - V0)*(q1 + (millivolts - V0)*(q2 + q3*(millivolts - V0))))
-	return (T0 + (numerator / denominator));
-#undef numerator
-#undef denominator  
+	float temperature = this->computeTemperature(tcCalibratedMillivolts<float>(calibration, millivolts) + coldJunction.millivolts);
+	return tcDeviation<float>(calibration, temperature);
+}
+
+double AbstractThermocouple::convert(const ThermocoupleColdJunction<double> &coldJunction, const ThermocoupleCalibration<double> &calibration, double millivolts)
+{
+	double temperature = this->computeTemperature(tcCalibratedMillivolts<double>(calibration, millivolts) + coldJunction.millivolts);
+	return tcDeviation<double>(calibration, temperature);
+}
+
+ThermocoupleSensitivity<float> AbstractThermocouple::getSensitivity(float millivolts, float Tcj, float sigmaMillivolts, float sigmaTcj)
+{
+	tc_single_t slope, uncertainty;
+	ThermocoupleSensitivity<float> result;
+	result.temperature = tcSensitivityScalar<tc_single_t>(this->temperatureTable(), millivolts, Tcj, sigmaMillivolts, sigmaTcj, &slope, &uncertainty);
+	result.slope = slope;
+	result.uncertainty = uncertainty;
+	return result;
+}
+
+ThermocoupleSensitivity<double> AbstractThermocouple::getSensitivity(double millivolts, double Tcj, double sigmaMillivolts, double sigmaTcj)
+{
+	ThermocoupleSensitivity<double> result;
+	result.temperature = tcSensitivityScalar(this->temperatureTable(), millivolts, Tcj, sigmaMillivolts, sigmaTcj, &result.slope, &result.uncertainty);
+	return result;
+}
+
+double AbstractThermocouple::computeColdJunction(double Tcj, const ThermocoupleSegmentTable *table)
+{
+	return tcColdJunctionScalar(table, Tcj);
+}
+
+double AbstractThermocouple::computeTemperatureInternal(double millivolts, const ThermocoupleSegmentTable *table)
+{
+	return tcTemperatureScalar(table, millivolts);
+}
+
+/*********************************************************************************************************
+Calibration storage
+*********************************************************************************************************/
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+static uint16_t tcCalibrationCrc(const uint8_t *data, size_t size)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while (size--)
+	{
+		crc ^= (uint16_t)(*data++) << 8;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	return crc;
+}
+
+// Single precision in little-endian byte order, whatever the machine's order
+static uint8_t *tcCalibrationPut(uint8_t *buffer, float value)
+{
+	uint32_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	for (uint8_t i = 0; i < 4; i++)
+		*buffer++ = (uint8_t)(bits >> (8 * i));
+	return buffer;
+}
+
+static const uint8_t *tcCalibrationGet(const uint8_t *buffer, float *value)
+{
+	uint32_t bits = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+		bits |= (uint32_t)(*buffer++) << (8 * i);
+	memcpy(value, &bits, sizeof(bits));
+	return buffer;
+}
+
+template<typename T> static size_t tcSaveCalibration(const ThermocoupleCalibration<T> &calibration, uint8_t *buffer)
+{
+	uint8_t *p = buffer;
+	uint16_t crc;
+
+	*p++ = TC_CALIBRATION_VERSION;
+	*p++ = TC_DEVIATION_TERMS;
+	p = tcCalibrationPut(p, (float)calibration.offset);
+	p = tcCalibrationPut(p, (float)calibration.gain);
+	for (uint8_t i = 0; i < TC_DEVIATION_TERMS; i++)
+		p = tcCalibrationPut(p, (float)calibration.deviation[i]);
+	crc = tcCalibrationCrc(buffer, p - buffer);
+	*p++ = (uint8_t)crc;
+	*p++ = (uint8_t)(crc >> 8);
+	return p - buffer;
+}
+
+template<typename T> static bool tcLoadCalibration(ThermocoupleCalibration<T> *calibration, const uint8_t *buffer, size_t size)
+{
+	const uint8_t *p = buffer + 2;
+	float value;
+
+	if (size < TC_CALIBRATION_SIZE || TC_CALIBRATION_VERSION != buffer[0] || TC_DEVIATION_TERMS != buffer[1])
+		return false;
+	if (tcCalibrationCrc(buffer, TC_CALIBRATION_SIZE - 2) != (uint16_t)(buffer[TC_CALIBRATION_SIZE - 2] | (buffer[TC_CALIBRATION_SIZE - 1] << 8)))
+		return false;
+
+	p = tcCalibrationGet(p, &value);
+	calibration->offset = value;
+	p = tcCalibrationGet(p, &value);
+	calibration->gain = value;
+	for (uint8_t i = 0; i < TC_DEVIATION_TERMS; i++)
+	{
+		p = tcCalibrationGet(p, &value);
+		calibration->deviation[i] = value;
+	}
+	return true;
+}
+
+size_t tcCalibrationSave(const ThermocoupleCalibration<float> &calibration, uint8_t *buffer)
+{
+	return tcSaveCalibration(calibration, buffer);
+}
+
+size_t tcCalibrationSave(const ThermocoupleCalibration<double> &calibration, uint8_t *buffer)
+{
+	return tcSaveCalibration(calibration, buffer);
+}
+
+bool tcCalibrationLoad(ThermocoupleCalibration<float> *calibration, const uint8_t *buffer, size_t size)
+{
+	return tcLoadCalibration(calibration, buffer, size);
+}
+
+bool tcCalibrationLoad(ThermocoupleCalibration<double> *calibration, const uint8_t *buffer, size_t size)
+{
+	return tcLoadCalibration(calibration, buffer, size);
 }
 
 /*********************************************************************************************************
 Type B Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_B
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::B> typeBFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::B>::build();
+static const ThermocoupleSegmentTable typeBTable = typeBFlash.table();
+
+typedef ThermocoupleTableConversion<&typeBTable> TypeBTemplate;
+typedef ThermocoupleTableConversion<&typeBTable, tc_single_t> TypeBSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::B> TypeBTemplate;
+typedef Thermocouple<ThermocoupleType::B, tc_single_t> TypeBSingleTemplate;
+
+static const ThermocoupleSegmentTable typeBTable =
+{
+	TypeBTemplate::Tables::segments,
+	TypeBTemplate::Tables::upperInclusive,
+	TypeBTemplate::Tables::degree,
+	TypeBTemplate::Coefficients::coldJunctionSegments,
+	TypeBTemplate::Tables::breakpoints,
+	TypeBTemplate::Tables::coefficients,
+	TypeBTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeBTemplate::Coefficients::coldJunction,
+	TypeBSingleTemplate::Tables::breakpoints,
+	TypeBSingleTemplate::Tables::coefficients,
+	TypeBSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeBSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeBProfile;
+#endif
+
 double TypeB::computeColdJunctionVoltage(double Tcj)
 {
-	// Type K equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-
-	const double T0 = 4.2000000E+01;
-	const double V0 = 3.3933898E-04;
-	const double p1 = 2.1196684E-04;
-	const double p2 = 3.3801250E-06;
-	const double p3 = -1.4793289E-07;
-	const double p4 = -3.3571424E-09;
-	const double q1 = -1.0920410E-02;
-	const double q2 = -4.9782932E-04;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeBTemplate, typeBProfile, Tcj);
 }
 
 double TypeB::computeTemperature(double millivolts)
 {
-	// Type B equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeBTemplate, typeBProfile, typeBTable, millivolts);
+}
 
-	if (0.291 <= millivolts && millivolts< 2.431)
-	{
-		T0 = 5.0000000E+02;
-		V0 = 1.2417900E+00;
-		p1 = 1.9858097E+02;
-		p2 = 2.4284248E+01;
-		p3 = 9.7271640E+01;
-		p4 = -1.5701178E+01;
-		q1 = 3.1009445E-01;
-		q2 = -5.0880251E-01;
-		q3 = -1.6163342E-01;
-	}
-	else if (2.431<=millivolts && millivolts<13.820)
-	{
-		T0 = 1.2461474E+03;
-		V0 = 7.2701221E+00;
-		p1 = 9.4321033E+01;
-		p2 = 7.3899296E+00;
-		p3 = -1.5880987E-01;
-		p4 = 1.2681877E-02;
-		q1 = 1.0113834E-01;
-		q2 = -1.6145962E-03;
-		q3 = -4.1086314E-06;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeB::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeBSingleTemplate, typeBProfile, Tcj);
+}
+
+float TypeB::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeBSingleTemplate, typeBProfile, typeBTable, millivolts);
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+const ThermocoupleSegmentTable *TypeB::temperatureTable()
+{
+	return &typeBTable;
+}
+
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeB::profile()
+{
+	return &typeBProfile;
 }
+#endif
+
+#endif
 
 /*********************************************************************************************************
 Type E Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_E
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::E> typeEFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::E>::build();
+static const ThermocoupleSegmentTable typeETable = typeEFlash.table();
+
+typedef ThermocoupleTableConversion<&typeETable> TypeETemplate;
+typedef ThermocoupleTableConversion<&typeETable, tc_single_t> TypeESingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::E> TypeETemplate;
+typedef Thermocouple<ThermocoupleType::E, tc_single_t> TypeESingleTemplate;
+
+static const ThermocoupleSegmentTable typeETable =
+{
+	TypeETemplate::Tables::segments,
+	TypeETemplate::Tables::upperInclusive,
+	TypeETemplate::Tables::degree,
+	TypeETemplate::Coefficients::coldJunctionSegments,
+	TypeETemplate::Tables::breakpoints,
+	TypeETemplate::Tables::coefficients,
+	TypeETemplate::Coefficients::coldJunctionBreakpoints,
+	TypeETemplate::Coefficients::coldJunction,
+	TypeESingleTemplate::Tables::breakpoints,
+	TypeESingleTemplate::Tables::coefficients,
+	TypeESingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeESingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeEProfile;
+#endif
+
 double TypeE::computeColdJunctionVoltage(double Tcj)
 {
-	// Type E equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-	const double T0 = 2.5000000E+01;
-	const double V0 = 1.4950582E+00;
-	const double p1 = 6.0958443E-02;
-	const double p2 = -2.7351789E-04;
-	const double p3 = -1.9130146E-05;
-	const double p4 = -1.3948840E-08;
-	const double q1 = -5.2382378E-03;
-	const double q2 = -3.0970168E-04;
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeETemplate, typeEProfile, Tcj);
 }
 
 double TypeE::computeTemperature(double millivolts)
 {
-	// Type E equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeETemplate, typeEProfile, typeETable, millivolts);
+}
 
-	if (-9.835 <= millivolts && millivolts < -5.237)
-	{
-		T0 = -1.1721668E+02;
-		V0 = -5.9901698E+00;
-		p1 = 2.3647275E+01;
-		p2 = 1.2807377E+01;
-		p3 = 2.0665069E+00;
-		p4 = 8.6513472E-02;
-		q1 = 5.8995860E-01;
-		q2 = 1.0960713E-01;
-		q3 = 6.1769588E-03;
-	}
-	else if (-5.237 <= millivolts && millivolts < 0.591)
-	{
-		T0 = -5.0000000E+01;
-		V0 = -2.7871777E+00;
-		p1 = 1.9022736E+01;
-		p2 = -1.7042725E+00;
-		p3 = -3.5195189E-01;
-		p4 = 4.7766102E-03;
-		q1 = -6.5379760E-02;
-		q2 = -2.1732833E-02;	
-		q3 = 0.0;
-	}
-	else if (0.591 <= millivolts && millivolts < 24.964)
-	{
-		T0 = 2.5014600E+02;
-		V0 = 1.7191713E+01;
-		p1 = 1.3115522E+01;
-		p2 = 1.1780364E+00;
-		p3 = 3.6422433E-02;
-		p4 = 3.9584261E-04;
-		q1 = 9.3112756E-02;
-		q2 = 2.9804232E-03;	
-		q3 = 3.3263032E-05;
-	}
-	else if (24.964 <= millivolts && millivolts < 53.112)
-	{
-		T0 = 6.0139890E+02;
-		V0 = 4.5206167E+01;
-		p1 = 1.2399357E+01;
-		p2 = 4.3399963E-01;
-		p3 = 9.1967085E-03;
-		p4 = 1.6901585E-04;
-		q1 = 3.4424680E-02;
-		q2 = 6.9741215E-04;	
-		q3 = 1.2946992E-05;
-	}
-	else if (53.112 <= millivolts && millivolts < 76.373)
-	{
-		T0 = 8.0435911E+02;
-		V0 = 6.1359178E+01;
-		p1 = 1.2759508E+01;
-		p2 = -1.1116072E+00;
-		p3 = 3.5332536E-02;
-		p4 = 3.3080380E-05;
-		q1 = -8.8196889E-02;
-		q2 = 2.8497415E-03;	
-		q3 = 0.0;
-	}		
-	else 
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeE::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeESingleTemplate, typeEProfile, Tcj);
+}
+
+float TypeE::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeESingleTemplate, typeEProfile, typeETable, millivolts);
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+const ThermocoupleSegmentTable *TypeE::temperatureTable()
+{
+	return &typeETable;
 }
 
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeE::profile()
+{
+	return &typeEProfile;
+}
+#endif
+
+#endif
+
 /*********************************************************************************************************
 Type J Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_J
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::J> typeJFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::J>::build();
+static const ThermocoupleSegmentTable typeJTable = typeJFlash.table();
+
+typedef ThermocoupleTableConversion<&typeJTable> TypeJTemplate;
+typedef ThermocoupleTableConversion<&typeJTable, tc_single_t> TypeJSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::J> TypeJTemplate;
+typedef Thermocouple<ThermocoupleType::J, tc_single_t> TypeJSingleTemplate;
+
+static const ThermocoupleSegmentTable typeJTable =
+{
+	TypeJTemplate::Tables::segments,
+	TypeJTemplate::Tables::upperInclusive,
+	TypeJTemplate::Tables::degree,
+	TypeJTemplate::Coefficients::coldJunctionSegments,
+	TypeJTemplate::Tables::breakpoints,
+	TypeJTemplate::Tables::coefficients,
+	TypeJTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeJTemplate::Coefficients::coldJunction,
+	TypeJSingleTemplate::Tables::breakpoints,
+	TypeJSingleTemplate::Tables::coefficients,
+	TypeJSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeJSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeJProfile;
+#endif
+
 double TypeJ::computeColdJunctionVoltage(double Tcj)
 {
-	// Type J equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-	const double T0 = 2.5000000E+01;
-	const double V0 = 1.2773432E+00;
-	const double p1 = 5.1744084E-02;
-	const double p2 = -5.4138663E-05;
-	const double p3 = -2.2895769E-06;
-	const double p4 = -7.7947143E-10;
-	const double q1 = -1.5173342E-03;
-	const double q2 = -4.2314514E-05;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeJTemplate, typeJProfile, Tcj);
 }
 
 double TypeJ::computeTemperature(double millivolts)
 {
-	// Type J equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeJTemplate, typeJProfile, typeJTable, millivolts);
+}
 
-	if (-8.095 <= millivolts && millivolts < 0)
-	{
-		T0 = -6.4936529E+01;
-		V0 = -3.1169773E+00;
-		p1 = 2.2133797E+01;
-		p2 = 2.0476437E+00;
-		p3 = -4.6867532E-01;
-		p4 = -3.6673992E-02;
-		q1 = 1.1746348E-01;
-		q2 = -2.0903413E-02;
-		q3 = -2.1823704E-03;
-	}
-	else if (0 <= millivolts && millivolts < 21.840)
-	{
-		T0 = 2.5066947E+02;
-		V0 = 1.3592329E+01;
-		p1 = 1.8014787E+01;
-		p2 = -6.5218881E-02;
-		p3 = -1.2179108E-02;
-		p4 = 2.0061707E-04;
-		q1 = -3.9494552E-03;
-		q2 = -7.3728206E-04;
-		q3 = 1.6679731E-05;
-	} 
-	else if (21.840 <= millivolts && millivolts < 45.494)
-	{
-		T0 = 6.4950262E+02;
-		V0 = 3.6040848E+01;
-		p1 = 1.6593395E+01;
-		p2 = 7.3009590E-01;
-		p3 = 2.4157343E-02;
-		p4 = 1.2787077E-03;
-		q1 = 4.9172861E-02;
-		q2 = 1.6813810E-03;
-		q3 = 7.6067922E-05;
-	} 
-	else if (45.494 <= millivolts && millivolts < 57.953)
-	{
-		T0 = 9.2510550E+02;
-		V0 = 5.3433832E+01;
-		p1 = 1.6243326E+01;
-		p2 = 9.2793267E-01;
-		p3 = 6.4644193E-03;
-		p4 = 2.0464414E-03;
-		q1 = 5.2541788E-02;
-		q2 = 1.3682959E-04;
-		q3 = 1.3454746E-04;
-	} 
-	else if (57.953 <= millivolts && millivolts < 69.553)
-	{
-		T0 = 1.0511294E+03;
-		V0 = 6.0956091E+01;
-		p1 = 1.7156001E+01;
-		p2 = -2.5931041E+00;
-		p3 = -5.8339803E-02;
-		p4 = 1.9954137E-02;
-		q1 = -1.5305581E-01;
-		q2 = -2.9523967E-03;
-		q3 = 1.1340164E-03;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeJ::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeJSingleTemplate, typeJProfile, Tcj);
+}
+
+float TypeJ::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeJSingleTemplate, typeJProfile, typeJTable, millivolts);
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+const ThermocoupleSegmentTable *TypeJ::temperatureTable()
+{
+	return &typeJTable;
 }
 
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeJ::profile()
+{
+	return &typeJProfile;
+}
+#endif
 
+#endif
 
 /*********************************************************************************************************
 Type K Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_K
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::K> typeKFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::K>::build();
+static const ThermocoupleSegmentTable typeKTable = typeKFlash.table();
+
+typedef ThermocoupleTableConversion<&typeKTable> TypeKTemplate;
+typedef ThermocoupleTableConversion<&typeKTable, tc_single_t> TypeKSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::K> TypeKTemplate;
+typedef Thermocouple<ThermocoupleType::K, tc_single_t> TypeKSingleTemplate;
+
+static const ThermocoupleSegmentTable typeKTable =
+{
+	TypeKTemplate::Tables::segments,
+	TypeKTemplate::Tables::upperInclusive,
+	TypeKTemplate::Tables::degree,
+	TypeKTemplate::Coefficients::coldJunctionSegments,
+	TypeKTemplate::Tables::breakpoints,
+	TypeKTemplate::Tables::coefficients,
+	TypeKTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeKTemplate::Coefficients::coldJunction,
+	TypeKSingleTemplate::Tables::breakpoints,
+	TypeKSingleTemplate::Tables::coefficients,
+	TypeKSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeKSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeKProfile;
+#endif
+
 double TypeK::computeColdJunctionVoltage(double Tcj)
 {
-	// Type K equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-	const double T0 = 25.0;
-	const double V0 = 1.0003453;
-	const double p1 = 4.0514854E-02;
-	const double p2 = -3.8789638E-05;
-	const double p3 = -2.8608478E-06;
-	const double p4 = -9.5367041E-10;
-	const double q1 = -1.3948675E-03;
-	const double q2 = -6.7976627E-05;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeKTemplate, typeKProfile, Tcj);
 }
 
 double TypeK::computeTemperature(double millivolts)
 {
-	// Type K equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeKTemplate, typeKProfile, typeKTable, millivolts);
+}
 
-	if( (-6.404 < millivolts) && (millivolts <= -3.554) )
-	{
-		T0 = -1.2147164E+02;
-		V0 = -4.1790858E+00;
-		p1 = 3.6069513E+01;
-		p2 = 3.0722076E+01;
-		p3 = 7.7913860E+00;
-		p4 = 5.2593991E-01;
-		q1 = 9.3939547E-01;
-		q2 = 2.7791285E-01;
-		q3 = 2.5163349E-02;
-	}
-	else if( (-3.554 < millivolts) && (millivolts <= 4.096) )
-	{
-		T0 = -8.7935962E+00;
-		V0 = -3.4489914E-01;
-		p1 = 2.5678719E+01;
-		p2 = -4.9887904E-01;
-		p3 = -4.4705222E-01;
-		p4 = -4.4869203E-02;
-		q1 = 2.3893439E-04;
-		q2 = -2.0397750E-02;
-		q3 = -1.8424107E-03;
-	}
-	else if( (4.096 < millivolts) && (millivolts <= 16.397) )
-	{
-		T0 = 3.1018976E+02;
-		V0 = 1.2631386E+01;
-		p1 = 2.4061949E+01;
-		p2 = 4.0158622E+00;
-		p3 = 2.6853917E-01;
-		p4 = -9.7188544E-03;
-		q1 = 1.6995872E-01;
-		q2 = 1.1413069E-02;
-		q3 = -3.9275155E-04;
-	}
-	else if( (16.397 < millivolts) && (millivolts <= 33.275) )
-	{
-		T0 = 6.0572562E+02;
-		V0 = 2.5148718E+01;
-		p1 = 2.3539401E+01;
-		p2 = 4.6547228E-02;
-		p3 = 1.3444400E-02;
-		p4 = 5.9236853E-04;
-		q1 = 8.3445513E-04;
-		q2 = 4.6121445E-04;
-		q3 = 2.5488122E-05;
-	}
-	else if( (33.275 < millivolts) && (millivolts <= 69.553) )
-	{
-		T0 = 1.0184705E+03;
-		V0 = 4.1993851E+01;
-		p1 = 2.5783239E+01;
-		p2 = -1.8363403E+00;
-		p3 = 5.6176662E-02;
-		p4 = 1.8532400E-04;
-		q1 = -7.4803355E-02;
-		q2 = 2.3841860E-03;
-		q3 = 0.0000000E+00;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeK::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeKSingleTemplate, typeKProfile, Tcj);
+}
+
+float TypeK::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeKSingleTemplate, typeKProfile, typeKTable, millivolts);
+}
+
+const ThermocoupleSegmentTable *TypeK::temperatureTable()
+{
+	return &typeKTable;
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeK::profile()
+{
+	return &typeKProfile;
 }
+#endif
 
+#endif
 
 /*********************************************************************************************************
 Type N Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_N
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::N> typeNFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::N>::build();
+static const ThermocoupleSegmentTable typeNTable = typeNFlash.table();
+
+typedef ThermocoupleTableConversion<&typeNTable> TypeNTemplate;
+typedef ThermocoupleTableConversion<&typeNTable, tc_single_t> TypeNSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::N> TypeNTemplate;
+typedef Thermocouple<ThermocoupleType::N, tc_single_t> TypeNSingleTemplate;
+
+static const ThermocoupleSegmentTable typeNTable =
+{
+	TypeNTemplate::Tables::segments,
+	TypeNTemplate::Tables::upperInclusive,
+	TypeNTemplate::Tables::degree,
+	TypeNTemplate::Coefficients::coldJunctionSegments,
+	TypeNTemplate::Tables::breakpoints,
+	TypeNTemplate::Tables::coefficients,
+	TypeNTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeNTemplate::Coefficients::coldJunction,
+	TypeNSingleTemplate::Tables::breakpoints,
+	TypeNSingleTemplate::Tables::coefficients,
+	TypeNSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeNSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeNProfile;
+#endif
+
 double TypeN::computeColdJunctionVoltage(double Tcj)
 {
-	// Type N equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-
-	const double T0 = 7.0000000E+00;
-	const double V0 = 1.8210024E-01;
-	const double p1 = 2.6228256E-02;
-	const double p2 = -1.5485539E-04;
-	const double p3 = 2.1366031E-06;
-	const double p4 = 9.2047105E-10;
-	const double q1 = -6.4070932E-03;
-	const double q2 = 8.2161781E-05;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeNTemplate, typeNProfile, Tcj);
 }
 
 double TypeN::computeTemperature(double millivolts)
 {
-	// Type N equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeNTemplate, typeNProfile, typeNTable, millivolts);
+}
 
-	if (-4.313 <= millivolts && millivolts < 0.0)
-	{
-		T0 = -5.9610511E+01;
-		V0 = -1.5000000E+00;
-		p1 = 4.2021322E+01;
-		p2 = 4.7244037E+00;
-		p3 = -6.1153213E+00;
-		p4 = -9.9980337E-01;
-		q1 = 1.6385664E-01;
-		q2 = -1.4994026E-01;
-		q3 = -3.0810372E-02;
-	}
-	else if (0.0 <= millivolts && millivolts < 20.613)
-	{
-		T0 = 3.1534505E+02;
-		V0 = 9.8870997E+00;
-		p1 = 2.7988676E+01;
-		p2 = 1.5417343E+00;
-		p3 = -1.4689457E-01;
-		p4 = -6.8322712E-03;
-		q1 = 6.2600036E-02;
-		q2 = -5.1489572E-03;	
-		q3 = -2.8835863E-04;
-	}
-	else if (20.613 <= millivolts && millivolts < 47.513)
-	{
-		T0 = 1.0340172E+03;
-		V0 = 3.7565475E+01;
-		p1 = 2.6029492E+01;
-		p2 = -6.0783095E-01;
-		p3 = -9.7742562E-03;
-		p4 = -3.3148813E-06;
-		q1 = -2.5351881E-02;
-		q2 = -3.8746827E-04;	
-		q3 = 1.7088177E-06;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeN::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeNSingleTemplate, typeNProfile, Tcj);
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+float TypeN::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeNSingleTemplate, typeNProfile, typeNTable, millivolts);
 }
 
+const ThermocoupleSegmentTable *TypeN::temperatureTable()
+{
+	return &typeNTable;
+}
+
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeN::profile()
+{
+	return &typeNProfile;
+}
+#endif
+
+#endif
+
 /*********************************************************************************************************
 Type R Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_R
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::R> typeRFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::R>::build();
+static const ThermocoupleSegmentTable typeRTable = typeRFlash.table();
+
+typedef ThermocoupleTableConversion<&typeRTable> TypeRTemplate;
+typedef ThermocoupleTableConversion<&typeRTable, tc_single_t> TypeRSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::R> TypeRTemplate;
+typedef Thermocouple<ThermocoupleType::R, tc_single_t> TypeRSingleTemplate;
+
+static const ThermocoupleSegmentTable typeRTable =
+{
+	TypeRTemplate::Tables::segments,
+	TypeRTemplate::Tables::upperInclusive,
+	TypeRTemplate::Tables::degree,
+	TypeRTemplate::Coefficients::coldJunctionSegments,
+	TypeRTemplate::Tables::breakpoints,
+	TypeRTemplate::Tables::coefficients,
+	TypeRTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeRTemplate::Coefficients::coldJunction,
+	TypeRSingleTemplate::Tables::breakpoints,
+	TypeRSingleTemplate::Tables::coefficients,
+	TypeRSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeRSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeRProfile;
+#endif
+
 double TypeR::computeColdJunctionVoltage(double Tcj)
 {
-	// Type R equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-
-	const double T0 = 2.5000000E+01;
-	const double V0 = 1.4067016E-01;
-	const double p1 = 5.9330356E-03;
-	const double p2 = 2.7736904E-05;
-	const double p3 = -1.0819644E-06;
-	const double p4 = -2.3098349E-09;
-	const double q1 = 2.6146871E-03;
-	const double q2 = -1.8621487E-04;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeRTemplate, typeRProfile, Tcj);
 }
 
 double TypeR::computeTemperature(double millivolts)
 {
-	// Type R equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeRTemplate, typeRProfile, typeRTable, millivolts);
+}
 
-	if (-0.226 <= millivolts && millivolts < 1.469)
-	{
-		T0 = 1.3054315E+02;
-		V0 = 8.8333090E-01;
-		p1 = 1.2557377E+02;
-		p2 = 1.3900275E+02;
-		p3 = 3.3035469E+01;
-		p4 = -8.5195924E-01;
-		q1 = 1.2232896E+00;
-		q2 = 3.5603023E-01;
-		q3 = 0.0;
-	}
-	else if (1.469 <= millivolts && millivolts < 7.461)
-	{
-		T0 = 5.4188181E+02;
-		V0 = 4.9312886E+00;
-		p1 = 9.0208190E+01;
-		p2 = 6.1762254E+00;
-		p3 = -1.2279323E+00;
-		p4 = 1.4873153E-02;
-		q1 = 8.7670455E-02;
-		q2 = -1.2906694E-02;	
-		q3 = 0.0;
-	}
-	else if (7.461 <= millivolts && millivolts < 14.277)
-	{
-		T0 = 1.0382132E+03;
-		V0 = 1.1014763E+01;
-		p1 = 7.4669343E+01;
-		p2 = 3.4090711E+00;
-		p3 = -1.4511205E-01;
-		p4 = 6.3077387E-03;
-		q1 = 5.6880253E-02;
-		q2 = -2.0512736E-03;	
-		q3 = 0.0;
-	}
-	else if (14.277 <= millivolts && millivolts < 21.101)
-	{
-		T0 = 1.5676133E+03;
-		V0 = 1.8397910E+01;
-		p1 = 7.1646299E+01;
-		p2 = -1.0866763E+00;
-		p3 = -2.0968371E+00;
-		p4 = -7.6741168E-01;
-		q1 = -1.9712341E-02;
-		q2 = -2.9903595E-02;	
-		q3 = -1.0766878E-02;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeR::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeRSingleTemplate, typeRProfile, Tcj);
+}
+
+float TypeR::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeRSingleTemplate, typeRProfile, typeRTable, millivolts);
+}
+
+const ThermocoupleSegmentTable *TypeR::temperatureTable()
+{
+	return &typeRTable;
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeR::profile()
+{
+	return &typeRProfile;
 }
+#endif
+
+#endif
 
 /*********************************************************************************************************
 Type S Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_S
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::S> typeSFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::S>::build();
+static const ThermocoupleSegmentTable typeSTable = typeSFlash.table();
+
+typedef ThermocoupleTableConversion<&typeSTable> TypeSTemplate;
+typedef ThermocoupleTableConversion<&typeSTable, tc_single_t> TypeSSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::S> TypeSTemplate;
+typedef Thermocouple<ThermocoupleType::S, tc_single_t> TypeSSingleTemplate;
+
+static const ThermocoupleSegmentTable typeSTable =
+{
+	TypeSTemplate::Tables::segments,
+	TypeSTemplate::Tables::upperInclusive,
+	TypeSTemplate::Tables::degree,
+	TypeSTemplate::Coefficients::coldJunctionSegments,
+	TypeSTemplate::Tables::breakpoints,
+	TypeSTemplate::Tables::coefficients,
+	TypeSTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeSTemplate::Coefficients::coldJunction,
+	TypeSSingleTemplate::Tables::breakpoints,
+	TypeSSingleTemplate::Tables::coefficients,
+	TypeSSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeSSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeSProfile;
+#endif
+
 double TypeS::computeColdJunctionVoltage(double Tcj)
 {
-	// Type S equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-	const double T0 = 2.5000000E+01;
-	const double V0 = 1.4269163E-01;
-	const double p1 = 5.9829057E-03;
-	const double p2 = 4.5292259E-06;
-	const double p3 = -1.3380281E-06;
-	const double p4 = -2.3742577E-09;
-	const double q1 = -1.0650446E-03;
-	const double q2 = -2.2042420E-04;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeSTemplate, typeSProfile, Tcj);
 }
 
 double TypeS::computeTemperature(double millivolts)
 {
-	// Type T equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
+	return TC_PROFILE_TEMPERATURE(TypeSTemplate, typeSProfile, typeSTable, millivolts);
+}
 
-	if (-0.236 <= millivolts && millivolts < 1.441)
-	{
-		T0 = 1.3792630E+02;
-		V0 = 9.3395024E-01;
-		p1 = 1.2761836E+02;
-		p2 = 1.1089050E+02;
-		p3 = 1.9898457E+01;
-		p4 = 9.6152996E-02;
-		q1 = 9.6545918E-01;
-		q2 = 2.0813850E-01;
-		q3 = 0.0;
-	}
-	else if (1.441 <= millivolts && millivolts < 6.913)
-	{
-		T0 = 4.7673468E+02;
-		V0 = 4.0037367E+00;
-		p1 = 1.0174512E+02;
-		p2 = -8.9306371E+00;
-		p3 = -4.2942435E+00;
-		p4 = 2.0453847E-01;
-		q1 = -7.1227776E-02;
-		q2 = -4.4618306E-02;	
-		q3 = 1.6822887E-03;
-	}
-	else if (6.913 <= millivolts && millivolts < 12.856)
-	{
-		T0 = 9.7946589E+02;
-		V0 = 9.3508283E+00;
-		p1 = 8.7126730E+01;
-		p2 = -2.3139202E+00;
-		p3 = -3.2682118E-02;
-		p4 = 4.6090022E-03;
-		q1 = -1.4299790E-02;
-		q2 = -1.2289882E-03;	
-		q3 = 0.0;
-	}
-	else if (12.856 <= millivolts && millivolts < 18.693)
-	{
-		T0 = 1.6010461E+03;
-		V0 = 1.6789315E+01;
-		p1 = 8.4315871E+01;
-		p2 = -1.0185043E+01;
-		p3 = -4.6283954E+00;
-		p4 = -1.0158749E+00;
-		q1 = -1.2877783E-01;
-		q2 = -5.5802216E-02;	
-		q3 = -1.2146518E-02;
-	}
-	else
-	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
-	}
+float TypeS::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeSSingleTemplate, typeSProfile, Tcj);
+}
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+float TypeS::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeSSingleTemplate, typeSProfile, typeSTable, millivolts);
 }
 
+const ThermocoupleSegmentTable *TypeS::temperatureTable()
+{
+	return &typeSTable;
+}
+
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeS::profile()
+{
+	return &typeSProfile;
+}
+#endif
+
+#endif
+
 /*********************************************************************************************************
 Type T Thermocouple Implementation
 *********************************************************************************************************/
 
+#if TC_TYPE_T
+
+#if defined(TC_FLASH_TABLES)
+// Flash copies, evaluated through the shared kernel
+static const ThermocoupleFlashTables<ThermocoupleType::T> typeTFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::T>::build();
+static const ThermocoupleSegmentTable typeTTable = typeTFlash.table();
+
+typedef ThermocoupleTableConversion<&typeTTable> TypeTTemplate;
+typedef ThermocoupleTableConversion<&typeTTable, tc_single_t> TypeTSingleTemplate;
+#else
+typedef Thermocouple<ThermocoupleType::T> TypeTTemplate;
+typedef Thermocouple<ThermocoupleType::T, tc_single_t> TypeTSingleTemplate;
+
+static const ThermocoupleSegmentTable typeTTable =
+{
+	TypeTTemplate::Tables::segments,
+	TypeTTemplate::Tables::upperInclusive,
+	TypeTTemplate::Tables::degree,
+	TypeTTemplate::Coefficients::coldJunctionSegments,
+	TypeTTemplate::Tables::breakpoints,
+	TypeTTemplate::Tables::coefficients,
+	TypeTTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeTTemplate::Coefficients::coldJunction,
+	TypeTSingleTemplate::Tables::breakpoints,
+	TypeTSingleTemplate::Tables::coefficients,
+	TypeTSingleTemplate::Coefficients::coldJunctionBreakpoints,
+	TypeTSingleTemplate::Coefficients::coldJunction
+};
+#endif
+
+#if defined(TC_PROFILE)
+static ThermocoupleProfile typeTProfile;
+#endif
+
 double TypeT::computeColdJunctionVoltage(double Tcj)
 {
-	// Type T equations
 	// Tcj = temperature in Celsius
 	// Returns equivalent voltage in mV
-	const double T0 = 2.5000000E+01;
-	const double V0 = 9.9198279E-01;
-	const double p1 = 4.0716564E-02;
-	const double p2 = 7.1170297E-04;
-	const double p3 = 6.8782631E-07;
-	const double p4 = 4.3295061E-11;
-	const double q1 = 1.6458102E-02;
-	const double q2 = 0.0;
-
-	return this->computeColdJunction(Tcj, T0, V0, p1, p2, p3, p4, q1, q2);
+	return TC_PROFILE_COLD_JUNCTION(TypeTTemplate, typeTProfile, Tcj);
 }
 
 double TypeT::computeTemperature(double millivolts)
 {
-	// Type T equations
 	// millivolts = voltage in mV
 	// Returns computed temperature in Celsius
-	double T0, V0, p1, p2, p3, p4, q1, q2, q3;
-	if (-6.18 <= millivolts && millivolts < -4.648)
-	{
-		T0 = -1.9243000E+02;
-		V0 = -5.4798963E+00;
-		p1 = 5.9572141E+01;
-		p2 = 1.9675733E+00;
-		p3 = -7.8176011E+01;
-		p4 = -1.0963280E+01;
-		q1 = 2.7498092E-01;
-		q2 = -1.3768944E+00;
-		q3 = -4.5209805E-01;
-	}
-	else if (-4.648 <= millivolts && millivolts < 0.0)
-	{
-		T0 = -6.0000000E+01;
-		V0 = -2.1528350E+00;
-		p1 = 3.0449332E+01;
-		p2 = -1.2946560E+00;
-		p3 = -3.0500735E+00;
-		p4 = -1.9226856E-01;
-		q1 = 6.9877863E-03;
-		q2 = -1.0596207E-01;  
-		q3 = -1.0774995E-02;
-	}
-	else if (0.0 <= millivolts && millivolts < 9.288)
-	{
-		T0 = 1.3500000E+02;
-		V0 = 5.9588600E+00;
-		p1 = 2.0325591E+01;
-		p2 = 3.3013079E+00;
-		p3 = 1.2638462E-01;
-		p4 = -8.2883695E-04;
-		q1 = 1.7595577E-01;
-		q2 = 7.9740521E-03; 
-		q3 = 0.0;
-	}
-	else if (9.288 <= millivolts && millivolts < 20.872)
+	return TC_PROFILE_TEMPERATURE(TypeTTemplate, typeTProfile, typeTTable, millivolts);
+}
+
+float TypeT::computeColdJunctionVoltage(float Tcj)
+{
+	return TC_PROFILE_COLD_JUNCTION(TypeTSingleTemplate, typeTProfile, Tcj);
+}
+
+float TypeT::computeTemperature(float millivolts)
+{
+	return TC_PROFILE_TEMPERATURE(TypeTSingleTemplate, typeTProfile, typeTTable, millivolts);
+}
+
+const ThermocoupleSegmentTable *TypeT::temperatureTable()
+{
+	return &typeTTable;
+}
+
+#if defined(TC_PROFILE)
+ThermocoupleProfile *TypeT::profile()
+{
+	return &typeTProfile;
+}
+#endif
+
+#endif
+
+/*********************************************************************************************************
+Profiling
+*********************************************************************************************************/
+
+#if defined(TC_PROFILE)
+
+// A type's counters, or NULL if it isn't built
+static ThermocoupleProfile *tcProfileOf(ThermocoupleType type)
+{
+	switch (type)
 	{
-		T0 = 3.0000000E+02;
-		V0 = 1.4861780E+01;
-		p1 = 1.7214707E+01;
-		p2 = -9.3862713E-01;
-		p3 = -7.3509066E-02;
-		p4 = 2.9576140E-04;
-		q1 = -4.8095795E-02;
-		q2 = -4.7352054E-03;  
-		q3 = -1.2146518E-02;
+#if TC_TYPE_B
+		case ThermocoupleType::B:
+			return &typeBProfile;
+#endif
+#if TC_TYPE_E
+		case ThermocoupleType::E:
+			return &typeEProfile;
+#endif
+#if TC_TYPE_J
+		case ThermocoupleType::J:
+			return &typeJProfile;
+#endif
+#if TC_TYPE_K
+		case ThermocoupleType::K:
+			return &typeKProfile;
+#endif
+#if TC_TYPE_N
+		case ThermocoupleType::N:
+			return &typeNProfile;
+#endif
+#if TC_TYPE_R
+		case ThermocoupleType::R:
+			return &typeRProfile;
+#endif
+#if TC_TYPE_S
+		case ThermocoupleType::S:
+			return &typeSProfile;
+#endif
+#if TC_TYPE_T
+		case ThermocoupleType::T:
+			return &typeTProfile;
+#endif
+		default:
+			return NULL;
 	}
-	else
+}
+
+void tcProfileReset()
+{
+	for (uint8_t t = (uint8_t)ThermocoupleType::B; t <= (uint8_t)ThermocoupleType::T; t++)
 	{
-		return (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE);
+		ThermocoupleProfile *profile = tcProfileOf((ThermocoupleType)t);
+		if (profile)
+			memset(profile, 0, sizeof(*profile));
 	}
+#if defined(TC_PROFILE_DWT_CYCCNT)
+	TC_PROFILE_DEMCR |= 0x01000000;     // TRCENA
+	TC_PROFILE_DWT_CYCCNT = 0;
+	TC_PROFILE_DWT_CTRL |= 0x00000001;  // CYCCNTENA
+#endif
+}
+
+bool tcProfileSnapshot(ThermocoupleType type, ThermocoupleProfile *profile)
+{
+	const ThermocoupleProfile *counters = tcProfileOf(type);
 
-	return this->computeTemperatureInternal(millivolts, T0, V0, p1, p2, p3, p4, q1, q2, q3);
+	if (NULL == counters)
+		return false;
+	memcpy(profile, counters, sizeof(*profile));
+	return true;
 }
+
+static uint8_t *tcProfilePut(uint8_t *buffer, uint32_t value)
+{
+	for (uint8_t i = 0; i < 4; i++)
+		*buffer++ = (uint8_t)(value >> (8 * i));
+	return buffer;
+}
+
+static uint8_t *tcProfilePut(uint8_t *buffer, const ThermocoupleProfileTimes &times)
+{
+	buffer = tcProfilePut(buffer, times.calls);
+	for (uint8_t i = 0; i < TC_PROFILE_BUCKETS; i++)
+		buffer = tcProfilePut(buffer, times.histogram[i]);
+	return buffer;
+}
+
+size_t tcProfileExport(ThermocoupleType type, const ThermocoupleProfile &profile, uint8_t *buffer)
+{
+	uint8_t *p = buffer;
+	uint16_t crc;
+
+	*p++ = TC_PROFILE_VERSION;
+	*p++ = (uint8_t)type;
+	*p++ = TC_PROFILE_CLOCK;
+	*p++ = TC_PROFILE_BUCKETS;
+	*p++ = TC_MAX_SEGMENTS;
+	p = tcProfilePut(p, profile.conversion);
+	p = tcProfilePut(p, profile.temperature);
+	p = tcProfilePut(p, profile.coldJunction);
+	for (uint8_t i = 0; i < TC_MAX_SEGMENTS; i++)
+		p = tcProfilePut(p, profile.segmentCalls[i]);
+	p = tcProfilePut(p, profile.underRange);
+	p = tcProfilePut(p, profile.overRange);
+	crc = tcCalibrationCrc(buffer, p - buffer);
+	*p++ = (uint8_t)crc;
+	*p++ = (uint8_t)(crc >> 8);
+	return p - buffer;
+}
+
+#endif
@@ -31,68 +31,373 @@ LICENSE:
 #ifndef _THERMOCOUPLE_H_
 #define _THERMOCOUPLE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include "ThermocoupleTemplate.h"
+#include "ThermocoupleProfile.h"
+
 #define TC_OUT_OF_RANGE (AbstractThermocouple::TCOUPLE_OUT_OF_RANGE)
 
+// Type the single precision (float) path evaluates in.  Where double is
+// already 32 bits (AVR) the float path shares the double tables and code.
+#if defined(__SIZEOF_DOUBLE__) && (__SIZEOF_DOUBLE__ == __SIZEOF_FLOAT__)
+typedef double tc_single_t;
+#else
+typedef float tc_single_t;
+#endif
+
+// Run-time view of one type's ThermocoupleCoefficients<Type, ...> arrays, used
+// where the type isn't known at compile time (the batch kernels).  degree is
+// 0 for rational coefficients, or the degree of polynomial ones (see
+// ThermocoupleTemperatureTables).  The forward (temperature-to-millivolt)
+// tables use the same layout, rational, with upperInclusive unused.
+struct ThermocoupleSegmentTable
+{
+	uint8_t segments;
+	bool upperInclusive;
+	uint8_t degree;
+	uint8_t coldJunctionSegments;
+	const double *breakpoints;
+	const double *coefficients;
+	const double *coldJunctionBreakpoints;
+	const double *coldJunction;
+	const tc_single_t *breakpointsSingle;
+	const tc_single_t *coefficientsSingle;
+	const tc_single_t *coldJunctionBreakpointsSingle;
+	const tc_single_t *coldJunctionSingle;
+};
+
+// Cold junction context - a cold junction temperature and its equivalent
+// voltage for one type, from AbstractThermocouple::getColdJunction()
+template<typename T> struct ThermocoupleColdJunction
+{
+	T Tcj;            // C
+	T millivolts;     // mV
+	uint8_t status;   // TC_STATUS_COLD_JUNCTION_RANGE or TC_STATUS_OK
+};
+
+// How one ADC channel's codes map to thermocouple millivolts:
+//   millivolts = (code - offset) * referenceMillivolts / (gain * fullScale)
+// referenceMillivolts and gain must be positive.  For the LTC2499 (24 bits
+// plus sign, full scale at half the reference) on a 4.096V reference with
+// no front end gain: { 2048.0, 1.0, 0, 16777216 }
+struct ThermocoupleAdcScale
+{
+	double referenceMillivolts;   // input (mV) that reads fullScale at unity gain
+	double gain;                  // gain ahead of the ADC
+	int32_t offset;               // code read with the input shorted
+	int32_t fullScale;            // code at referenceMillivolts
+};
+
+// Codes are only converted within +/-2^30
+#define TC_ADC_CODE_LIMIT 1073741824L
+
+// One channel's scale and cold junction folded into a type's segments, from
+// AbstractThermocouple::getAdcChannel().  Segment i covers codes in
+// (threshold[i], threshold[i + 1]], and its rational or polynomial is evaluated at
+//   x = (code - origin[i]) * millivoltsPerCode - fraction[i]
+// which is the compensated voltage's distance from the segment's V0 - so
+// conversion starts from the integer code, with no millivolt value formed.
+template<typename T> struct ThermocoupleAdcChannel
+{
+	T Tcj;                                  // C
+	T millivoltsPerCode;
+	int32_t threshold[TC_MAX_SEGMENTS + 1];
+	int32_t origin[TC_MAX_SEGMENTS];        // segment V0 in codes, rounded down
+	T fraction[TC_MAX_SEGMENTS];            // and the rest of it in mV
+	uint8_t status;                         // TC_STATUS_COLD_JUNCTION_RANGE or TC_STATUS_OK
+};
+
+// A temperature with its sensitivity to the thermocouple voltage, from
+// AbstractThermocouple::getSensitivity()
+template<typename T> struct ThermocoupleSensitivity
+{
+	T temperature;   // C, or TC_OUT_OF_RANGE_TEMPERATURE
+	T slope;         // dT/dV at the reading in C/mV - the inverse of the local Seebeck coefficient
+	T uncertainty;   // standard uncertainty in C from the given sigmas
+};
+
+// Per-sensor calibration, applied inside the conversion:
+//   corrected = raw * gain + offset                        (mV, before cold junction compensation)
+//   t = conversion of corrected + cold junction voltage
+//   result = t + deviation[0] + deviation[1] t + deviation[2] t^2 + deviation[3] t^3
+// The deviation function is in the form of the ITS-90 reference function
+// deviations - fit it to the probe's calibration points in C.  An out of
+// range result is left at TC_OUT_OF_RANGE_TEMPERATURE.  No correction is
+// { 0, 1, { 0, 0, 0, 0 } }.
+#define TC_DEVIATION_TERMS 4
+
+template<typename T> struct ThermocoupleCalibration
+{
+	T offset;                           // mV
+	T gain;
+	T deviation[TC_DEVIATION_TERMS];    // C, C/C, C/C^2, C/C^3
+};
+
+// Stored form of a calibration, for EEPROM or flash: a version byte, the
+// number of deviation terms, offset, gain and the deviation terms as
+// little-endian IEEE single precision, and a CRC-16 (CCITT) of all of it.
+#define TC_CALIBRATION_VERSION 1
+#define TC_CALIBRATION_SIZE (2 + 4 * (2 + TC_DEVIATION_TERMS) + 2)
+
+// Write a calibration to buffer (TC_CALIBRATION_SIZE bytes) and return the
+// number of bytes written
+size_t tcCalibrationSave(const ThermocoupleCalibration<float> &calibration, uint8_t *buffer);
+size_t tcCalibrationSave(const ThermocoupleCalibration<double> &calibration, uint8_t *buffer);
+// Read one back.  Returns false, leaving *calibration alone, if size is too
+// small or the version or CRC doesn't match.
+bool tcCalibrationLoad(ThermocoupleCalibration<float> *calibration, const uint8_t *buffer, size_t size);
+bool tcCalibrationLoad(ThermocoupleCalibration<double> *calibration, const uint8_t *buffer, size_t size);
+
 class AbstractThermocouple {
 	public:
 		float getTemperature(float millivolts, float Tcj);
 		double getTemperature(double millivolts, double Tcj);
-		const double TCOUPLE_OUT_OF_RANGE = -1000.0;
+		// Multi-channel scans - compute the cold junction voltage once per scan
+		// with getColdJunction(), then convert() every channel of this type
+		// against it.  Results are identical to getTemperature(millivolts, Tcj).
+		ThermocoupleColdJunction<float> getColdJunction(float Tcj);
+		ThermocoupleColdJunction<double> getColdJunction(double Tcj);
+		float convert(const ThermocoupleColdJunction<float> &coldJunction, float millivolts);
+		double convert(const ThermocoupleColdJunction<double> &coldJunction, double millivolts);
+		void convert(const ThermocoupleColdJunction<float> &coldJunction, const float *millivolts, float *temperatures, size_t count);
+		void convert(const ThermocoupleColdJunction<double> &coldJunction, const double *millivolts, double *temperatures, size_t count);
+		// Batch forms - convert count samples at once.  Results are identical
+		// to calling getTemperature() on each sample in turn.
+		void getTemperatures(const float *millivolts, const float *Tcj, float *temperatures, size_t count);
+		void getTemperatures(const double *millivolts, const double *Tcj, double *temperatures, size_t count);
+		// Status forms - the same temperatures along with TC_STATUS_* bits, so
+		// results can be checked without comparing against TC_OUT_OF_RANGE.
+		// The array forms fill status (one byte per sample, or skip it if NULL)
+		// and return every sample's bits ORed together - 0 if the whole frame
+		// is good.
+		ThermocoupleResult<float> getResult(float millivolts, float Tcj);
+		ThermocoupleResult<double> getResult(double millivolts, double Tcj);
+		ThermocoupleResult<float> getResult(const ThermocoupleColdJunction<float> &coldJunction, float millivolts);
+		ThermocoupleResult<double> getResult(const ThermocoupleColdJunction<double> &coldJunction, double millivolts);
+		uint8_t getTemperatures(const float *millivolts, const float *Tcj, float *temperatures, uint8_t *status, size_t count);
+		uint8_t getTemperatures(const double *millivolts, const double *Tcj, double *temperatures, uint8_t *status, size_t count);
+		uint8_t convert(const ThermocoupleColdJunction<float> &coldJunction, const float *millivolts, float *temperatures, uint8_t *status, size_t count);
+		uint8_t convert(const ThermocoupleColdJunction<double> &coldJunction, const double *millivolts, double *temperatures, uint8_t *status, size_t count);
+		// Raw ADC codes - fold a channel's scale and cold junction temperature
+		// into the type's segments with getAdcChannel() (again whenever Tcj
+		// changes), then convert() codes against it.  Per-sample and batch
+		// results are identical.
+		ThermocoupleAdcChannel<float> getAdcChannel(const ThermocoupleAdcScale &scale, float Tcj);
+		ThermocoupleAdcChannel<double> getAdcChannel(const ThermocoupleAdcScale &scale, double Tcj);
+		float convert(const ThermocoupleAdcChannel<float> &channel, int32_t code);
+		double convert(const ThermocoupleAdcChannel<double> &channel, int32_t code);
+		void convert(const ThermocoupleAdcChannel<float> &channel, const int32_t *codes, float *temperatures, size_t count);
+		void convert(const ThermocoupleAdcChannel<double> &channel, const int32_t *codes, double *temperatures, size_t count);
+		// Calibrated forms - the same conversions with a probe's calibration
+		// applied in the same pass (see ThermocoupleCalibration).  Per-sample
+		// and batch results are identical.
+		float getTemperature(const ThermocoupleCalibration<float> &calibration, float millivolts, float Tcj);
+		double getTemperature(const ThermocoupleCalibration<double> &calibration, double millivolts, double Tcj);
+		void getTemperatures(const ThermocoupleCalibration<float> &calibration, const float *millivolts, const float *Tcj, float *temperatures, size_t count);
+		void getTemperatures(const ThermocoupleCalibration<double> &calibration, const double *millivolts, const double *Tcj, double *temperatures, size_t count);
+		float convert(const ThermocoupleColdJunction<float> &coldJunction, const ThermocoupleCalibration<float> &calibration, float millivolts);
+		double convert(const ThermocoupleColdJunction<double> &coldJunction, const ThermocoupleCalibration<double> &calibration, double millivolts);
+		void convert(const ThermocoupleColdJunction<float> &coldJunction, const ThermocoupleCalibration<float> &calibration, const float *millivolts, float *temperatures, size_t count);
+		void convert(const ThermocoupleColdJunction<double> &coldJunction, const ThermocoupleCalibration<double> &calibration, const double *millivolts, double *temperatures, size_t count);
+		// Sensitivity forms - the temperature with dT/dV, from the same rational
+		// or polynomial evaluation rather than finite differences, and the standard
+		// uncertainty that reading noise sigmaMillivolts (mV) and cold junction
+		// uncertainty sigmaTcj (C) give it.  slope and uncertainty are 0 out of
+		// range.  The array forms fill slopes and uncertainties if not NULL.
+		// Temperatures are identical to getTemperature(), and per-sample and
+		// batch results are identical.  The fits were made for temperature:
+		// the slope, and so the uncertainty, strays from NIST (up to 40% for
+		// E) below -230C for E, -215C for K and N and -210C for T, above
+		// 1760C for R and S, and within a degree of -150C for T - see the
+		// README for the usable ranges.
+		ThermocoupleSensitivity<float> getSensitivity(float millivolts, float Tcj, float sigmaMillivolts = 0.0f, float sigmaTcj = 0.0f);
+		ThermocoupleSensitivity<double> getSensitivity(double millivolts, double Tcj, double sigmaMillivolts = 0.0, double sigmaTcj = 0.0);
+		void getSensitivities(const float *millivolts, const float *Tcj, float sigmaMillivolts, float sigmaTcj, float *temperatures, float *slopes, float *uncertainties, size_t count);
+		void getSensitivities(const double *millivolts, const double *Tcj, double sigmaMillivolts, double sigmaTcj, double *temperatures, double *slopes, double *uncertainties, size_t count);
+		static constexpr double TCOUPLE_OUT_OF_RANGE = TC_OUT_OF_RANGE_TEMPERATURE;
 	protected:
-		double computeColdJunction(double Tcj, const double T0, const double V0, const double p1, const double p2, const double p3, const double p4, const double q1, const double q2);
-		double computeTemperatureInternal(double millivolts, const double T0, const double V0, const double p1, const double p2, const double p3, const double p4, const double q1, const double q2, const double q3);
+		virtual const ThermocoupleSegmentTable *temperatureTable() = 0;
+		double computeColdJunction(double Tcj, const ThermocoupleSegmentTable *table);
+		double computeTemperatureInternal(double millivolts, const ThermocoupleSegmentTable *table);
 		virtual double computeTemperature(double millivolts) = 0;
 		virtual double computeColdJunctionVoltage(double Tcj) = 0;
+		virtual float computeTemperature(float millivolts) = 0;
+		virtual float computeColdJunctionVoltage(float Tcj) = 0;
+#if defined(TC_PROFILE)
+		// The type's counters (see ThermocoupleProfile.h)
+		virtual ThermocoupleProfile *profile() = 0;
+#endif
+};
+
+#if defined(__AVX2__)
+// Batch temperature-to-millivolt conversion on a forward table (internal - use
+// TypedThermocouple::getVoltages)
+void tcGetVoltages(const ThermocoupleSegmentTable *table, const float *temperatures, const float *Tcj, float *millivolts, size_t count);
+void tcGetVoltages(const ThermocoupleSegmentTable *table, const double *temperatures, const double *Tcj, double *millivolts, size_t count);
+#endif
+
+// Adds the temperature-to-millivolt (forward) conversions.  These aren't
+// virtual, so the forward tables are only linked in by sketches that use them.
+template<ThermocoupleType Type>
+class TypedThermocouple : public AbstractThermocouple {
+	public:
+		// Voltage (mV) the thermocouple reads at temperature (C) with its cold junction at Tcj (C)
+		float getVoltage(float temperature, float Tcj) { return Thermocouple<Type, tc_single_t>::getVoltage(temperature, Tcj); }
+		double getVoltage(double temperature, double Tcj) { return Thermocouple<Type>::getVoltage(temperature, Tcj); }
+		// Voltage (mV) referenced to 0C
+		float getVoltage(float temperature) { return Thermocouple<Type, tc_single_t>::computeVoltage(temperature); }
+		double getVoltage(double temperature) { return Thermocouple<Type>::computeVoltage(temperature); }
+		// Batch forms.  Tcj may be NULL for voltages referenced to 0C.  Results
+		// are identical to calling getVoltage() on each sample in turn.
+		void getVoltages(const float *temperatures, const float *Tcj, float *millivolts, size_t count) { voltages(temperatures, Tcj, millivolts, count); }
+		void getVoltages(const double *temperatures, const double *Tcj, double *millivolts, size_t count) { voltages(temperatures, Tcj, millivolts, count); }
+	private:
+#if defined(__AVX2__)
+		static const ThermocoupleSegmentTable forwardTable;
+
+		template<typename T> void voltages(const T *temperatures, const T *Tcj, T *millivolts, size_t count)
+		{
+			tcGetVoltages(&forwardTable, temperatures, Tcj, millivolts, count);
+		}
+#else
+		// Without a vector kernel the inlined templates beat a table-driven loop
+		template<typename T> void voltages(const T *temperatures, const T *Tcj, T *millivolts, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+				millivolts[i] = Tcj ? getVoltage(temperatures[i], Tcj[i]) : getVoltage(temperatures[i]);
+		}
+#endif
+};
+
+#if defined(__AVX2__)
+template<ThermocoupleType Type> const ThermocoupleSegmentTable TypedThermocouple<Type>::forwardTable =
+{
+	ThermocoupleCoefficients<Type, double>::forwardSegments, false, 0,
+	ThermocoupleCoefficients<Type, double>::coldJunctionSegments,
+	ThermocoupleCoefficients<Type, double>::forwardBreakpoints,
+	ThermocoupleCoefficients<Type, double>::forwardCoefficients,
+	ThermocoupleCoefficients<Type, double>::coldJunctionBreakpoints,
+	ThermocoupleCoefficients<Type, double>::coldJunction,
+	ThermocoupleCoefficients<Type, tc_single_t>::forwardBreakpoints,
+	ThermocoupleCoefficients<Type, tc_single_t>::forwardCoefficients,
+	ThermocoupleCoefficients<Type, tc_single_t>::coldJunctionBreakpoints,
+	ThermocoupleCoefficients<Type, tc_single_t>::coldJunction
 };
+#endif
 
-class TypeB : public AbstractThermocouple {
+#if TC_TYPE_B
+class TypeB : public TypedThermocouple<ThermocoupleType::B> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeE : public AbstractThermocouple {
+#if TC_TYPE_E
+class TypeE : public TypedThermocouple<ThermocoupleType::E> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeJ : public AbstractThermocouple {
+#if TC_TYPE_J
+class TypeJ : public TypedThermocouple<ThermocoupleType::J> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeK : public AbstractThermocouple {
+#if TC_TYPE_K
+class TypeK : public TypedThermocouple<ThermocoupleType::K> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeN : public AbstractThermocouple {
+#if TC_TYPE_N
+class TypeN : public TypedThermocouple<ThermocoupleType::N> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeR : public AbstractThermocouple {
+#if TC_TYPE_R
+class TypeR : public TypedThermocouple<ThermocoupleType::R> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeS : public AbstractThermocouple {
+#if TC_TYPE_S
+class TypeS : public TypedThermocouple<ThermocoupleType::S> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
-class TypeT : public AbstractThermocouple {
+#if TC_TYPE_T
+class TypeT : public TypedThermocouple<ThermocoupleType::T> {
 	protected:
 		double computeTemperature(double millivolts);
 		double computeColdJunctionVoltage(double Tcj);
+		float computeTemperature(float millivolts);
+		float computeColdJunctionVoltage(float Tcj);
+		const ThermocoupleSegmentTable *temperatureTable();
+#if defined(TC_PROFILE)
+		ThermocoupleProfile *profile();
+#endif
 };
+#endif
 
 
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleAlarm.h
+License:  GNU General Public License v3
+
+ABOUT:
+    High and low alarms checked on the raw readings, without converting
+    them to temperature.  Every type's curve rises with temperature, so a
+    limit in C is the same test as a limit on the voltage at that
+    temperature.  tcAlarmLimits() turns a channel's limits into voltages
+    referenced to 0C once (at compile time, for constant limits).  Each
+    scan, setColdJunction() subtracts each type's cold junction voltage,
+    leaving thresholds on the raw millivolts - or on the raw ADC codes -
+    so check() is a few compares per channel, with hysteresis and
+    debounce.  Only the readings that are logged or displayed then need a
+    full conversion.
+
+    Nothing is allocated - the channel count is a template parameter and
+    all working storage is part of the object.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_ALARM_H_
+#define _THERMOCOUPLE_ALARM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "Thermocouple.h"
+
+// Alarm state bits for a channel - 0 is no alarm
+enum
+{
+	TC_ALARM_NONE = 0,
+	TC_ALARM_HIGH = 0x01,   // above the high limit, and not yet back below it less the hysteresis
+	TC_ALARM_LOW = 0x02     // below the low limit, and not yet back above it plus the hysteresis
+};
+
+// A limit past the end of a type's range never trips - these turn one side off
+#define TC_ALARM_NO_LOW TC_OUT_OF_RANGE_TEMPERATURE
+#define TC_ALARM_NO_HIGH 10000.0
+
+// One channel's limits as thermocouple voltages referenced to 0C (mV), from
+// tcAlarmLimits().  The high alarm trips above high and clears below
+// highClear; the low alarm trips below low and clears above lowClear.
+struct ThermocoupleAlarmLimits
+{
+	double high;
+	double highClear;
+	double low;
+	double lowClear;
+};
+
+// Voltage at a trip point - out past the end of the range if the
+// temperature is, so it never trips
+template<ThermocoupleType Type> static constexpr double tcAlarmTrip(double temperature)
+{
+	return (temperature < ThermocoupleCoefficients<Type, double>::forwardBreakpoints[0]) ? -(double)INFINITY
+		: ((temperature > ThermocoupleCoefficients<Type, double>::forwardBreakpoints[ThermocoupleCoefficients<Type, double>::forwardSegments]) ? (double)INFINITY
+		: Thermocouple<Type>::computeVoltage(temperature));
+}
+
+// Voltage at a clear point, clamped to the range so a tripped alarm can
+// always clear
+template<ThermocoupleType Type> static constexpr double tcAlarmClear(double temperature)
+{
+	return Thermocouple<Type>::computeVoltage(
+		(temperature < ThermocoupleCoefficients<Type, double>::forwardBreakpoints[0]) ? ThermocoupleCoefficients<Type, double>::forwardBreakpoints[0]
+		: ((temperature > ThermocoupleCoefficients<Type, double>::forwardBreakpoints[ThermocoupleCoefficients<Type, double>::forwardSegments]) ? ThermocoupleCoefficients<Type, double>::forwardBreakpoints[ThermocoupleCoefficients<Type, double>::forwardSegments]
+		: temperature));
+}
+
+// low and high = alarm limits in Celsius (TC_ALARM_NO_LOW / TC_ALARM_NO_HIGH
+// for none), hysteresis = how far (C) back inside a limit a reading has to
+// come to clear its alarm.  constexpr, so constant limits cost nothing at
+// run time:
+//   static constexpr ThermocoupleAlarmLimits kiln = tcAlarmLimits<ThermocoupleType::K>(TC_ALARM_NO_LOW, 1250.0, 5.0);
+template<ThermocoupleType Type> static constexpr ThermocoupleAlarmLimits tcAlarmLimits(double low, double high, double hysteresis = 0.0)
+{
+	return ThermocoupleAlarmLimits{ tcAlarmTrip<Type>(high), tcAlarmClear<Type>(high - hysteresis), tcAlarmTrip<Type>(low), tcAlarmClear<Type>(low + hysteresis) };
+}
+
+// A raw threshold (mV) in the units check() is given - millivolts as they
+// are, or ADC codes through scale.  Codes are rounded so that comparing
+// codes gives the same answer as comparing their millivolts: down for
+// thresholds tested with >, up for those tested with <.
+static inline void tcAlarmThreshold(double millivolts, const ThermocoupleAdcScale &, bool, float *threshold)
+{
+	*threshold = (float)millivolts;
+}
+
+static inline void tcAlarmThreshold(double millivolts, const ThermocoupleAdcScale &, bool, double *threshold)
+{
+	*threshold = millivolts;
+}
+
+static inline void tcAlarmThreshold(double millivolts, const ThermocoupleAdcScale &scale, bool roundUp, int32_t *threshold)
+{
+	double code = (double)scale.offset + millivolts * scale.gain * (double)scale.fullScale / scale.referenceMillivolts;
+
+	code = roundUp ? ceil(code) : floor(code);
+	// An infinite (or far off scale) threshold lands on a code no reading is past
+	if (code >= 2147483647.0)
+		*threshold = (int32_t)2147483647L;
+	else if (code <= -2147483648.0)
+		*threshold = (int32_t)(-2147483647L - 1);
+	else
+		*threshold = (int32_t)code;
+}
+
+// Counts readings that disagree with the alarm's state, and flips it after
+// samples of them in a row.  Written as arithmetic on compare results, as
+// readings near a limit make branches on them unpredictable.
+static inline uint8_t tcAlarmDebounce(uint8_t state, uint8_t bit, bool active, uint8_t *count, uint8_t samples)
+{
+	uint8_t n = (uint8_t)((*count + 1) * (active != (0 != (state & bit))));
+	uint8_t flip = (n >= samples);
+
+	*count = (uint8_t)(n * !flip);
+	return (uint8_t)(state ^ (bit * flip));
+}
+
+// Channels = number of inputs (up to 255).  T = what check() is given: float
+// or double readings in mV, or int32_t ADC codes (see setScale()).
+template<uint8_t Channels, typename T = float>
+class ThermocoupleAlarm
+{
+	public:
+		// debounce = readings in a row past a threshold before an alarm trips or clears
+		ThermocoupleAlarm(uint8_t debounce = 1) : debounce(debounce ? debounce : 1), Tcj(TC_OUT_OF_RANGE_TEMPERATURE)
+		{
+			ThermocoupleAdcScale unity = { 1.0, 1.0, 0, 1 };
+
+			scale = unity;
+			for (uint8_t ch = 0; ch < Channels; ch++)
+			{
+				channel[ch] = NULL;
+				coldJunction[ch] = 0.0;
+				state[ch] = highCount[ch] = lowCount[ch] = 0;
+				thresholds(ch);
+			}
+		}
+
+		// tc = the channel's thermocouple object (NULL if unused), limits from
+		// tcAlarmLimits() for that type.  Resets the channel's alarm state.
+		void setChannel(uint8_t ch, AbstractThermocouple *tc, const ThermocoupleAlarmLimits &channelLimits)
+		{
+			if (ch >= Channels)
+				return;
+			channel[ch] = tc;
+			limits[ch] = channelLimits;
+			coldJunction[ch] = (NULL != tc && TC_OUT_OF_RANGE_TEMPERATURE != Tcj) ? tc->getColdJunction(Tcj).millivolts : 0.0;
+			state[ch] = highCount[ch] = lowCount[ch] = 0;
+			thresholds(ch);
+		}
+
+		// Change a channel's limits, keeping its alarm state
+		void setLimits(uint8_t ch, const ThermocoupleAlarmLimits &channelLimits)
+		{
+			if (ch >= Channels)
+				return;
+			limits[ch] = channelLimits;
+			thresholds(ch);
+		}
+
+		// How ADC codes map to millivolts, for int32_t readings - one scale for
+		// every channel, as for a single multiplexed ADC
+		void setScale(const ThermocoupleAdcScale &adcScale)
+		{
+			scale = adcScale;
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				thresholds(ch);
+		}
+
+		void setDebounce(uint8_t samples)
+		{
+			debounce = samples ? samples : 1;
+		}
+
+		// Tcj = cold junction temperature in Celsius.  Call before the first
+		// check() and whenever Tcj changes - the thresholds are only moved when
+		// it does, with the cold junction voltage worked out once per
+		// thermocouple object.
+		void setColdJunction(double coldJunctionTemperature)
+		{
+			uint8_t ch, other;
+
+			if (coldJunctionTemperature == Tcj)
+				return;
+			Tcj = coldJunctionTemperature;
+			for (ch = 0; ch < Channels; ch++)
+			{
+				if (NULL == channel[ch])
+					continue;
+				for (other = 0; other < ch && channel[other] != channel[ch]; other++);
+				coldJunction[ch] = (other < ch) ? coldJunction[other] : channel[ch]->getColdJunction(Tcj).millivolts;
+				thresholds(ch);
+			}
+		}
+
+		// Clear every alarm and pending debounce count
+		void reset()
+		{
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				state[ch] = highCount[ch] = lowCount[ch] = 0;
+		}
+
+		// input = channel ch's raw reading (mV, or an ADC code)
+		// Returns its TC_ALARM_* bits.  A NaN reading leaves the state as it was.
+		uint8_t check(uint8_t ch, T input)
+		{
+			return (ch < Channels) ? step(ch, input) : (uint8_t)TC_ALARM_NONE;
+		}
+
+		// inputs = one raw reading per channel.  Fills states (if not NULL) with
+		// each channel's TC_ALARM_* bits and returns them ORed together - 0 if
+		// nothing is in alarm.
+		uint8_t check(const T *inputs, uint8_t *states)
+		{
+			uint8_t any = TC_ALARM_NONE;
+
+			for (uint8_t ch = 0; ch < Channels; ch++)
+			{
+				uint8_t s = step(ch, inputs[ch]);
+				if (NULL != states)
+					states[ch] = s;
+				any |= s;
+			}
+			return any;
+		}
+
+		uint8_t getState(uint8_t ch) const
+		{
+			return (ch < Channels) ? state[ch] : (uint8_t)TC_ALARM_NONE;
+		}
+
+	private:
+		uint8_t step(uint8_t ch, T input)
+		{
+			// Past the clear threshold while tripped, past the trip threshold
+			// otherwise - without branches, as for tcAlarmDebounce()
+			bool high = ((0 != (state[ch] & TC_ALARM_HIGH)) & !(input < highClear[ch])) | (input > highTrip[ch]);
+			bool low = ((0 != (state[ch] & TC_ALARM_LOW)) & !(input > lowClear[ch])) | (input < lowTrip[ch]);
+
+			state[ch] = tcAlarmDebounce(state[ch], TC_ALARM_HIGH, high, &highCount[ch], debounce);
+			state[ch] = tcAlarmDebounce(state[ch], TC_ALARM_LOW, low, &lowCount[ch], debounce);
+			return state[ch];
+		}
+
+		// Channel ch's limits less its cold junction voltage, in input units.
+		// An unused channel's are past any reading, so step() needn't check for one.
+		void thresholds(uint8_t ch)
+		{
+			const ThermocoupleAlarmLimits never = { (double)INFINITY, (double)INFINITY, -(double)INFINITY, -(double)INFINITY };
+			const ThermocoupleAlarmLimits &l = (NULL != channel[ch]) ? limits[ch] : never;
+
+			tcAlarmThreshold(l.high - coldJunction[ch], scale, false, &highTrip[ch]);
+			tcAlarmThreshold(l.highClear - coldJunction[ch], scale, true, &highClear[ch]);
+			tcAlarmThreshold(l.low - coldJunction[ch], scale, true, &lowTrip[ch]);
+			tcAlarmThreshold(l.lowClear - coldJunction[ch], scale, false, &lowClear[ch]);
+		}
+
+		uint8_t debounce;
+		double Tcj;                            // cold junction temperature the thresholds are for
+		ThermocoupleAdcScale scale;
+		AbstractThermocouple *channel[Channels];
+		ThermocoupleAlarmLimits limits[Channels];
+		double coldJunction[Channels];         // each channel's cold junction voltage in mV
+		T highTrip[Channels];                  // raw thresholds
+		T highClear[Channels];
+		T lowTrip[Channels];
+		T lowClear[Channels];
+		uint8_t state[Channels];               // TC_ALARM_* bits
+		uint8_t highCount[Channels];           // readings in a row disagreeing with each bit
+		uint8_t lowCount[Channels];
+};
+
+#endif
@@ -0,0 +1,1241 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleBatch.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Batch conversion kernels.  Each sample goes through exactly the same
+    sequence of IEEE operations as AbstractThermocouple::getTemperature(),
+    just several lanes at a time, so the results are bit-identical to the
+    per-sample path.  Lanes that fall into different segments pick up their
+    coefficients from the type's ThermocoupleSegmentTable with a gather
+    (AVX2) or per-lane loads (SSE2, NEON).  Types built with polynomial
+    tables run a Horner loop of the table's degree in place of the rational,
+    with no divide.  With AVX2, tcGetVoltages()
+    runs the forward (temperature-to-millivolt) tables through the same
+    kernels, matching TypedThermocouple::getVoltage().
+
+    The vector kernel is chosen at compile time from the target flags:
+      AVX2    - build with -mavx2 (4 double or 8 float lanes, gathered
+                coefficients)
+      SSE2    - any x86-64 build (2 double lanes)
+      NEON    - AArch64 builds (2 double lanes)
+      scalar  - everything else, including AVR, and float on SSE2/NEON
+
+    convert() runs the same kernels with one cold junction voltage broadcast
+    to every lane in place of a per-sample cold junction evaluation.
+
+    The status forms compute the TC_STATUS_* bits in the same loop from the
+    same compares, without branches: the AVX2 kernels turn each compare
+    mask into one bit per lane with movemask and spread those into one
+    status byte per lane.
+
+    getSensitivities() evaluates each segment's derivative alongside it,
+    with AVX2 or the scalar loop, matching getSensitivity().
+
+    The float forms evaluate in single precision with the float tables,
+    matching the float overload of getTemperature().
+
+    Bit-identical results assume the compiler is not allowed to contract
+    a*b+c into a fused multiply-add (-ffp-contract=off, which is also what
+    GCC does by default in the strict -std=c++NN modes).
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#include <string.h>
+#include "Thermocouple.h"
+#include "ThermocoupleKernel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TC_BATCH_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define TC_BATCH_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TC_BATCH_NEON
+#endif
+
+/*********************************************************************************************************
+Scalar kernel
+*********************************************************************************************************/
+
+// With Status, also fills status (if not NULL) and returns the ORed status
+// bits.  With Calibrated, applies *calibration.
+template<bool Status, bool Calibrated, typename T> static uint8_t tcBatchScalar(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<T> *calibration, const T *millivolts, const T *Tcj, T *temperatures, uint8_t *status, size_t count)
+{
+	uint8_t summary = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		// raw is kept - temperatures may be millivolts
+		T raw = millivolts[i];
+		T compensated = (Calibrated ? tcCalibratedMillivolts<T>(*calibration, raw) : raw) + tcColdJunctionScalar(table, Tcj[i]);
+		T temperature = tcTemperatureScalar(table, compensated);
+		temperatures[i] = Calibrated ? tcDeviation<T>(*calibration, temperature) : temperature;
+		if (Status)
+		{
+			uint8_t bits = tcStatusScalar(table, raw, compensated) | tcColdJunctionStatus(table, Tcj[i]);
+			summary |= bits;
+			if (status)
+				status[i] = bits;
+		}
+	}
+	return summary;
+}
+
+// Every sample against one cold junction voltage, with coldJunctionStatus
+// added to every sample's status
+template<bool Status, bool Calibrated, typename T> static uint8_t tcConvertScalar(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<T> *calibration, const T *millivolts, T Vcj, uint8_t coldJunctionStatus, T *temperatures, uint8_t *status, size_t count)
+{
+	uint8_t summary = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		T raw = millivolts[i];
+		T compensated = (Calibrated ? tcCalibratedMillivolts<T>(*calibration, raw) : raw) + Vcj;
+		T temperature = tcTemperatureScalar(table, compensated);
+		temperatures[i] = Calibrated ? tcDeviation<T>(*calibration, temperature) : temperature;
+		if (Status)
+		{
+			uint8_t bits = tcStatusScalar(table, raw, compensated) | coldJunctionStatus;
+			summary |= bits;
+			if (status)
+				status[i] = bits;
+		}
+	}
+	return summary;
+}
+
+// See tcSensitivityScalar()
+template<typename T> static void tcSensitivityBatchScalar(const ThermocoupleSegmentTable *table, const T *millivolts, const T *Tcj, T sigmaMillivolts, T sigmaTcj, T *temperatures, T *slopes, T *uncertainties, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		T slope, uncertainty;
+		temperatures[i] = tcSensitivityScalar(table, millivolts[i], Tcj[i], sigmaMillivolts, sigmaTcj, &slope, &uncertainty);
+		if (slopes)
+			slopes[i] = slope;
+		if (uncertainties)
+			uncertainties[i] = uncertainty;
+	}
+}
+
+template<typename T> static void tcVoltageBatchScalar(const ThermocoupleSegmentTable *table, const T *temperatures, const T *Tcj, T *millivolts, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		T millivolt = tcVoltageScalar(table, temperatures[i]);
+		if (Tcj && millivolt != T(TC_OUT_OF_RANGE_TEMPERATURE))
+			millivolt = millivolt - tcColdJunctionScalar(table, Tcj[i]);
+		millivolts[i] = millivolt;
+	}
+}
+
+/*********************************************************************************************************
+AVX2 kernels - coefficients gathered by segment index
+*********************************************************************************************************/
+
+#if defined(TC_BATCH_AVX2)
+
+static_assert(TC_MAX_CJ_SEGMENTS <= 3, "the cold junction kernels blend at most three segments");
+
+// column[seg] per lane, where above1 and above2 are set in lanes at or past
+// breakpoints 1 and 2
+static inline __m256d tcColdJunctionSelectAVX2(const double *column, int n, __m256d above1, __m256d above2)
+{
+	__m256d c = _mm256_set1_pd(column[0]);
+	if (n > 1)
+		c = _mm256_blendv_pd(c, _mm256_set1_pd(column[1]), above1);
+	if (n > 2)
+		c = _mm256_blendv_pd(c, _mm256_set1_pd(column[2]), above2);
+	return c;
+}
+
+// Cold junction voltage per lane - see tcColdJunctionScalar().  There are
+// only a few cold junction segments, so the coefficients are picked by
+// blending broadcasts on the breakpoint compares rather than gathered.
+static inline __m256d tcColdJunctionAVX2(const ThermocoupleSegmentTable *table, __m256d Tcj)
+{
+	const int n = table->coldJunctionSegments;
+	const double *bp = table->coldJunctionBreakpoints;
+	const double *cj = table->coldJunction;
+	__m256d above1 = _mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[1]), _CMP_GE_OQ);
+	__m256d above2 = _mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[(n > 2) ? 2 : 1]), _CMP_GE_OQ);
+
+#define TC_CJ(col) tcColdJunctionSelectAVX2(cj + (col) * n, n, above1, above2)
+	__m256d t = _mm256_sub_pd(Tcj, TC_CJ(TC_CJ_COEFF_T0));
+	__m256d numerator = _mm256_mul_pd(TC_CJ(TC_CJ_COEFF_P4), t);
+	numerator = _mm256_add_pd(TC_CJ(TC_CJ_COEFF_P3), numerator);
+	numerator = _mm256_add_pd(TC_CJ(TC_CJ_COEFF_P2), _mm256_mul_pd(t, numerator));
+	numerator = _mm256_add_pd(TC_CJ(TC_CJ_COEFF_P1), _mm256_mul_pd(t, numerator));
+	numerator = _mm256_mul_pd(t, numerator);
+	__m256d denominator = _mm256_add_pd(TC_CJ(TC_CJ_COEFF_Q1), _mm256_mul_pd(TC_CJ(TC_CJ_COEFF_Q2), t));
+	denominator = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(t, denominator));
+	return _mm256_add_pd(TC_CJ(TC_CJ_COEFF_V0), _mm256_div_pd(numerator, denominator));
+#undef TC_CJ
+}
+
+// tcColdJunctionAVX2() with dV/dTcj per lane in *slope - see
+// tcColdJunctionSlopeScalar()
+static inline __m256d tcColdJunctionSlopeAVX2(const ThermocoupleSegmentTable *table, __m256d Tcj, __m256d *slope)
+{
+	const int n = table->coldJunctionSegments;
+	const double *bp = table->coldJunctionBreakpoints;
+	const double *cj = table->coldJunction;
+	__m256d above1 = _mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[1]), _CMP_GE_OQ);
+	__m256d above2 = _mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[(n > 2) ? 2 : 1]), _CMP_GE_OQ);
+
+#define TC_CJ(col) tcColdJunctionSelectAVX2(cj + (col) * n, n, above1, above2)
+	__m256d p1 = TC_CJ(TC_CJ_COEFF_P1), p2 = TC_CJ(TC_CJ_COEFF_P2), p3 = TC_CJ(TC_CJ_COEFF_P3), p4 = TC_CJ(TC_CJ_COEFF_P4);
+	__m256d q1 = TC_CJ(TC_CJ_COEFF_Q1), q2 = TC_CJ(TC_CJ_COEFF_Q2);
+	__m256d t = _mm256_sub_pd(Tcj, TC_CJ(TC_CJ_COEFF_T0));
+	__m256d numerator = _mm256_mul_pd(t, _mm256_add_pd(p1, _mm256_mul_pd(t, _mm256_add_pd(p2, _mm256_mul_pd(t, _mm256_add_pd(p3, _mm256_mul_pd(p4, t)))))));
+	__m256d denominator = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(t, _mm256_add_pd(q1, _mm256_mul_pd(q2, t))));
+	__m256d ratio = _mm256_div_pd(numerator, denominator);
+	__m256d dN = _mm256_add_pd(p1, _mm256_mul_pd(t, _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), p2),
+		_mm256_mul_pd(t, _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(3.0), p3), _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(4.0), p4), t))))));
+	__m256d dD = _mm256_add_pd(q1, _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), q2), t));
+	*slope = _mm256_div_pd(_mm256_sub_pd(dN, _mm256_mul_pd(dD, ratio)), denominator);
+	return _mm256_add_pd(TC_CJ(TC_CJ_COEFF_V0), ratio);
+#undef TC_CJ
+}
+
+// One rational segment per lane - see tcRationalSegment()
+static inline __m256d tcRationalAVX2(const double *c, int n, __m256i seg, __m256d x, int out)
+{
+#define TC_GATHER(col) _mm256_i64gather_pd(c + (col) * n, seg, 8)
+	__m256d numerator = _mm256_mul_pd(TC_GATHER(TC_COEFF_P4), x);
+	numerator = _mm256_add_pd(TC_GATHER(TC_COEFF_P3), numerator);
+	numerator = _mm256_add_pd(TC_GATHER(TC_COEFF_P2), _mm256_mul_pd(x, numerator));
+	numerator = _mm256_add_pd(TC_GATHER(TC_COEFF_P1), _mm256_mul_pd(x, numerator));
+	numerator = _mm256_mul_pd(x, numerator);
+	__m256d denominator = _mm256_mul_pd(TC_GATHER(TC_COEFF_Q3), x);
+	denominator = _mm256_add_pd(TC_GATHER(TC_COEFF_Q2), denominator);
+	denominator = _mm256_add_pd(TC_GATHER(TC_COEFF_Q1), _mm256_mul_pd(x, denominator));
+	denominator = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(x, denominator));
+	return _mm256_add_pd(TC_GATHER(out), _mm256_div_pd(numerator, denominator));
+#undef TC_GATHER
+}
+
+// tcRationalAVX2() with its derivative per lane in *slope - see
+// tcRationalSlopeSegment()
+static inline __m256d tcRationalSlopeAVX2(const double *c, int n, __m256i seg, __m256d x, int out, __m256d *slope)
+{
+#define TC_GATHER(col) _mm256_i64gather_pd(c + (col) * n, seg, 8)
+	__m256d p1 = TC_GATHER(TC_COEFF_P1), p2 = TC_GATHER(TC_COEFF_P2), p3 = TC_GATHER(TC_COEFF_P3), p4 = TC_GATHER(TC_COEFF_P4);
+	__m256d q1 = TC_GATHER(TC_COEFF_Q1), q2 = TC_GATHER(TC_COEFF_Q2), q3 = TC_GATHER(TC_COEFF_Q3);
+	__m256d numerator = _mm256_mul_pd(x, _mm256_add_pd(p1, _mm256_mul_pd(x, _mm256_add_pd(p2, _mm256_mul_pd(x, _mm256_add_pd(p3, _mm256_mul_pd(p4, x)))))));
+	__m256d denominator = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(x, _mm256_add_pd(q1, _mm256_mul_pd(x, _mm256_add_pd(q2, _mm256_mul_pd(q3, x))))));
+	__m256d ratio = _mm256_div_pd(numerator, denominator);
+	__m256d dN = _mm256_add_pd(p1, _mm256_mul_pd(x, _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), p2),
+		_mm256_mul_pd(x, _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(3.0), p3), _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(4.0), p4), x))))));
+	__m256d dD = _mm256_add_pd(q1, _mm256_mul_pd(x, _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), q2), _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(3.0), q3), x))));
+	*slope = _mm256_div_pd(_mm256_sub_pd(dN, _mm256_mul_pd(dD, ratio)), denominator);
+	return _mm256_add_pd(TC_GATHER(out), ratio);
+#undef TC_GATHER
+}
+
+// One polynomial segment per lane - see tcPolynomialSegment()
+static inline __m256d tcPolynomialAVX2(const double *c, int n, int degree, __m256i seg, __m256d x)
+{
+#define TC_GATHER(col) _mm256_i64gather_pd(c + (col) * n, seg, 8)
+	__m256d r = TC_GATHER(TC_POLYNOMIAL_A1 + degree - 1);
+	for (int k = degree - 1; k > 0; k--)
+		r = _mm256_add_pd(TC_GATHER(TC_POLYNOMIAL_A1 + k - 1), _mm256_mul_pd(x, r));
+	return _mm256_add_pd(TC_GATHER(TC_COEFF_T0), _mm256_mul_pd(x, r));
+#undef TC_GATHER
+}
+
+// tcPolynomialAVX2() with its derivative per lane in *slope - see
+// tcPolynomialSlopeSegment()
+static inline __m256d tcPolynomialSlopeAVX2(const double *c, int n, int degree, __m256i seg, __m256d x, __m256d *slope)
+{
+#define TC_GATHER(col) _mm256_i64gather_pd(c + (col) * n, seg, 8)
+	__m256d r = TC_GATHER(TC_POLYNOMIAL_A1 + degree - 1);
+	__m256d dr = _mm256_setzero_pd();
+	for (int k = degree - 1; k > 0; k--)
+	{
+		dr = _mm256_add_pd(r, _mm256_mul_pd(x, dr));
+		r = _mm256_add_pd(TC_GATHER(TC_POLYNOMIAL_A1 + k - 1), _mm256_mul_pd(x, r));
+	}
+	*slope = _mm256_add_pd(r, _mm256_mul_pd(x, dr));
+	return _mm256_add_pd(TC_GATHER(TC_COEFF_T0), _mm256_mul_pd(x, r));
+#undef TC_GATHER
+}
+
+// See tcInverseSegment() and tcInverseSlopeSegment()
+static inline __m256d tcInverseAVX2(const double *c, int n, int degree, __m256i seg, __m256d x)
+{
+	return degree ? tcPolynomialAVX2(c, n, degree, seg, x) : tcRationalAVX2(c, n, seg, x, TC_COEFF_T0);
+}
+
+static inline __m256d tcInverseSlopeAVX2(const double *c, int n, int degree, __m256i seg, __m256d x, __m256d *slope)
+{
+	return degree ? tcPolynomialSlopeAVX2(c, n, degree, seg, x, slope) : tcRationalSlopeAVX2(c, n, seg, x, TC_COEFF_T0, slope);
+}
+
+// See tcEvaluateSegment()
+static inline __m256d tcEvaluateAVX2(const double *c, int n, __m256i seg, __m256d input, int in, int out)
+{
+	return tcRationalAVX2(c, n, seg, _mm256_sub_pd(input, _mm256_i64gather_pd(c + in * n, seg, 8)), out);
+}
+
+// Segment index per lane, with lanes in range flagged in *inRange
+static inline __m256i tcSegmentAVX2(const ThermocoupleSegmentTable *table, __m256d mv, __m256d *inRange)
+{
+	const int n = table->segments;
+	const double *bp = table->breakpoints;
+	__m256i seg = _mm256_setzero_si256();
+
+	// Count the interior breakpoints below each lane - comparison masks are
+	// all ones (-1), so subtracting them increments the segment index
+	if (table->upperInclusive)
+	{
+		*inRange = _mm256_and_pd(_mm256_cmp_pd(mv, _mm256_set1_pd(bp[0]), _CMP_GT_OQ), _mm256_cmp_pd(mv, _mm256_set1_pd(bp[n]), _CMP_LE_OQ));
+		for (int i = 1; i < n; i++)
+			seg = _mm256_sub_epi64(seg, _mm256_castpd_si256(_mm256_cmp_pd(mv, _mm256_set1_pd(bp[i]), _CMP_GT_OQ)));
+	}
+	else
+	{
+		*inRange = _mm256_and_pd(_mm256_cmp_pd(mv, _mm256_set1_pd(bp[0]), _CMP_GE_OQ), _mm256_cmp_pd(mv, _mm256_set1_pd(bp[n]), _CMP_LT_OQ));
+		for (int i = 1; i < n; i++)
+			seg = _mm256_sub_epi64(seg, _mm256_castpd_si256(_mm256_cmp_pd(mv, _mm256_set1_pd(bp[i]), _CMP_GE_OQ)));
+	}
+	return seg;
+}
+
+static inline __m256d tcTemperatureAVX2(const ThermocoupleSegmentTable *table, __m256d mv)
+{
+	__m256d inRange;
+	__m256i seg = tcSegmentAVX2(table, mv, &inRange);
+	__m256d x = _mm256_sub_pd(mv, _mm256_i64gather_pd(table->coefficients + TC_COEFF_V0 * table->segments, seg, 8));
+	__m256d temperature = tcInverseAVX2(table->coefficients, table->segments, table->degree, seg, x);
+	return _mm256_blendv_pd(_mm256_set1_pd(TC_OUT_OF_RANGE_TEMPERATURE), temperature, inRange);
+}
+
+// Temperature per lane with dT/dV and the propagated uncertainty - see
+// tcSensitivityScalar()
+static inline __m256d tcSensitivityAVX2(const ThermocoupleSegmentTable *table, __m256d raw, __m256d Tcj, __m256d sigmaMillivolts, __m256d sigmaTcj, __m256d *slope, __m256d *uncertainty)
+{
+	const int n = table->segments;
+	__m256d coldJunctionSlope, inRange;
+	__m256d mv = _mm256_add_pd(raw, tcColdJunctionSlopeAVX2(table, Tcj, &coldJunctionSlope));
+	__m256i seg = tcSegmentAVX2(table, mv, &inRange);
+	__m256d x = _mm256_sub_pd(mv, _mm256_i64gather_pd(table->coefficients + TC_COEFF_V0 * n, seg, 8));
+	__m256d temperature = tcInverseSlopeAVX2(table->coefficients, n, table->degree, seg, x, slope);
+	__m256d sigmaColdJunction = _mm256_mul_pd(coldJunctionSlope, sigmaTcj);
+	__m256d variance = _mm256_add_pd(_mm256_mul_pd(sigmaMillivolts, sigmaMillivolts), _mm256_mul_pd(sigmaColdJunction, sigmaColdJunction));
+	*uncertainty = _mm256_and_pd(inRange, _mm256_mul_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), *slope), _mm256_sqrt_pd(variance)));
+	*slope = _mm256_and_pd(inRange, *slope);
+	return _mm256_blendv_pd(_mm256_set1_pd(TC_OUT_OF_RANGE_TEMPERATURE), temperature, inRange);
+}
+
+// Four raw ADC codes - see tcAdcTemperatureScalar().  The segment search and
+// range check are integer compares on the codes.
+static inline __m256d tcAdcTemperatureAVX2(const ThermocoupleSegmentTable *table, const ThermocoupleAdcChannel<double> &channel, __m128i code)
+{
+	const int n = table->segments;
+	const int32_t *k = channel.threshold;
+	__m128i inRange = _mm_andnot_si128(_mm_cmpgt_epi32(code, _mm_set1_epi32(k[n])), _mm_cmpgt_epi32(code, _mm_set1_epi32(k[0])));
+	__m128i seg = _mm_setzero_si128();
+
+	for (int i = 1; i < n; i++)
+		seg = _mm_sub_epi32(seg, _mm_cmpgt_epi32(code, _mm_set1_epi32(k[i])));
+
+	__m256i seg64 = _mm256_cvtepi32_epi64(seg);
+	__m128i offset = _mm_sub_epi32(code, _mm_i32gather_epi32((const int *)channel.origin, seg, 4));
+	__m256d x = _mm256_sub_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(offset), _mm256_set1_pd(channel.millivoltsPerCode)), _mm256_i64gather_pd(channel.fraction, seg64, 8));
+	__m256d temperature = tcInverseAVX2(table->coefficients, n, table->degree, seg64, x);
+	return _mm256_blendv_pd(_mm256_set1_pd(TC_OUT_OF_RANGE_TEMPERATURE), temperature, _mm256_castsi256_pd(_mm256_cvtepi32_epi64(inRange)));
+}
+
+// Forward table - voltage referenced to 0C, with lanes outside the (closed)
+// range flagged in inRange
+static inline __m256d tcVoltageAVX2(const ThermocoupleSegmentTable *table, __m256d temperature, __m256d *inRange)
+{
+	const int n = table->segments;
+	const double *bp = table->breakpoints;
+	__m256i seg = _mm256_setzero_si256();
+
+	*inRange = _mm256_and_pd(_mm256_cmp_pd(temperature, _mm256_set1_pd(bp[0]), _CMP_GE_OQ), _mm256_cmp_pd(temperature, _mm256_set1_pd(bp[n]), _CMP_LE_OQ));
+	for (int i = 1; i < n; i++)
+		seg = _mm256_sub_epi64(seg, _mm256_castpd_si256(_mm256_cmp_pd(temperature, _mm256_set1_pd(bp[i]), _CMP_GE_OQ)));
+
+	return tcEvaluateAVX2(table->coefficients, n, seg, temperature, TC_COEFF_T0, TC_COEFF_V0);
+}
+
+// Spread the low 4 bits of a movemask into one 0 or 1 byte per lane, lane 0
+// in the lowest byte (x86 is little endian, so the bytes store in lane order)
+static inline uint32_t tcSpreadMask(int mask)
+{
+	return ((uint32_t)mask * 0x00204081u) & 0x01010101u;
+}
+
+static inline uint64_t tcSpreadMask8(int mask)
+{
+	return tcSpreadMask(mask & 15) | ((uint64_t)tcSpreadMask(mask >> 4) << 32);
+}
+
+// OR together the status bytes packed in bits
+static inline uint8_t tcFoldStatus(uint64_t bits)
+{
+	bits |= bits >> 32;
+	bits |= bits >> 16;
+	bits |= bits >> 8;
+	return (uint8_t)bits;
+}
+
+// One status byte per lane - see tcStatusScalar().  The not-compares
+// (NGT, NLE, ...) are true for NaN, as the scalar ! of a compare is.
+static inline uint32_t tcStatusAVX2(const ThermocoupleSegmentTable *table, __m256d raw, __m256d mv)
+{
+	const int n = table->segments;
+	const double *bp = table->breakpoints;
+	__m256d under, over;
+
+	if (table->upperInclusive)
+	{
+		under = _mm256_cmp_pd(mv, _mm256_set1_pd(bp[0]), _CMP_NGT_UQ);
+		over = _mm256_cmp_pd(mv, _mm256_set1_pd(bp[n]), _CMP_NLE_UQ);
+	}
+	else
+	{
+		under = _mm256_cmp_pd(mv, _mm256_set1_pd(bp[0]), _CMP_NGE_UQ);
+		over = _mm256_cmp_pd(mv, _mm256_set1_pd(bp[n]), _CMP_NLT_UQ);
+	}
+	__m256d open = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), raw), _mm256_set1_pd(TC_OPEN_CIRCUIT_MILLIVOLTS), _CMP_NLT_UQ);
+
+	return tcSpreadMask(_mm256_movemask_pd(under)) * TC_STATUS_UNDER_RANGE
+		| tcSpreadMask(_mm256_movemask_pd(over)) * TC_STATUS_OVER_RANGE
+		| tcSpreadMask(_mm256_movemask_pd(open)) * TC_STATUS_OPEN_CIRCUIT;
+}
+
+static inline uint32_t tcColdJunctionStatusAVX2(const ThermocoupleSegmentTable *table, __m256d Tcj)
+{
+	const double *bp = table->coldJunctionBreakpoints;
+	__m256d outside = _mm256_or_pd(_mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[0]), _CMP_NGE_UQ), _mm256_cmp_pd(Tcj, _mm256_set1_pd(bp[table->coldJunctionSegments]), _CMP_NLE_UQ));
+	return tcSpreadMask(_mm256_movemask_pd(outside)) * TC_STATUS_COLD_JUNCTION_RANGE;
+}
+
+// Calibration - see tcCalibratedMillivolts() and tcDeviation()
+static inline __m256d tcCalibratedMillivoltsAVX2(const ThermocoupleCalibration<double> *calibration, __m256d raw)
+{
+	return _mm256_add_pd(_mm256_mul_pd(raw, _mm256_set1_pd(calibration->gain)), _mm256_set1_pd(calibration->offset));
+}
+
+static inline __m256d tcDeviationAVX2(const ThermocoupleCalibration<double> *calibration, __m256d t)
+{
+	const double *d = calibration->deviation;
+	__m256d deviation = _mm256_add_pd(_mm256_set1_pd(d[2]), _mm256_mul_pd(t, _mm256_set1_pd(d[3])));
+	deviation = _mm256_add_pd(_mm256_set1_pd(d[1]), _mm256_mul_pd(t, deviation));
+	deviation = _mm256_add_pd(_mm256_set1_pd(d[0]), _mm256_mul_pd(t, deviation));
+	__m256d inRange = _mm256_cmp_pd(t, _mm256_set1_pd(TC_OUT_OF_RANGE_TEMPERATURE), _CMP_NEQ_UQ);
+	return _mm256_blendv_pd(t, _mm256_add_pd(t, deviation), inRange);
+}
+
+// With Status, also fills status (if not NULL) and ORs the status bits into
+// *summary.  With Calibrated, applies *calibration.
+template<bool Status, bool Calibrated> static size_t tcBatchVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const double *millivolts, const double *Tcj, double *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	uint32_t bits = 0;
+	size_t i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256d raw = _mm256_loadu_pd(millivolts + i);
+		__m256d tcj = _mm256_loadu_pd(Tcj + i);
+		__m256d mv = _mm256_add_pd(Calibrated ? tcCalibratedMillivoltsAVX2(calibration, raw) : raw, tcColdJunctionAVX2(table, tcj));
+		__m256d temperature = tcTemperatureAVX2(table, mv);
+		_mm256_storeu_pd(temperatures + i, Calibrated ? tcDeviationAVX2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint32_t lanes = tcStatusAVX2(table, raw, mv) | tcColdJunctionStatusAVX2(table, tcj);
+			bits |= lanes;
+			if (status)
+				memcpy(status + i, &lanes, 4);
+		}
+	}
+	if (Status)
+		*summary |= tcFoldStatus(bits);
+	return i;
+}
+
+template<bool Status, bool Calibrated> static size_t tcConvertVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const double *millivolts, double Vcj, uint8_t coldJunctionStatus, double *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	const uint32_t cj = coldJunctionStatus * 0x01010101u;
+	uint32_t bits = 0;
+	size_t i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256d raw = _mm256_loadu_pd(millivolts + i);
+		__m256d mv = _mm256_add_pd(Calibrated ? tcCalibratedMillivoltsAVX2(calibration, raw) : raw, _mm256_set1_pd(Vcj));
+		__m256d temperature = tcTemperatureAVX2(table, mv);
+		_mm256_storeu_pd(temperatures + i, Calibrated ? tcDeviationAVX2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint32_t lanes = tcStatusAVX2(table, raw, mv) | cj;
+			bits |= lanes;
+			if (status)
+				memcpy(status + i, &lanes, 4);
+		}
+	}
+	if (Status)
+		*summary |= tcFoldStatus(bits);
+	return i;
+}
+
+static size_t tcSensitivityVector(const ThermocoupleSegmentTable *table, const double *millivolts, const double *Tcj, double sigmaMillivolts, double sigmaTcj, double *temperatures, double *slopes, double *uncertainties, size_t count)
+{
+	size_t i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256d slope, uncertainty;
+		__m256d temperature = tcSensitivityAVX2(table, _mm256_loadu_pd(millivolts + i), _mm256_loadu_pd(Tcj + i), _mm256_set1_pd(sigmaMillivolts), _mm256_set1_pd(sigmaTcj), &slope, &uncertainty);
+		_mm256_storeu_pd(temperatures + i, temperature);
+		if (slopes)
+			_mm256_storeu_pd(slopes + i, slope);
+		if (uncertainties)
+			_mm256_storeu_pd(uncertainties + i, uncertainty);
+	}
+	return i;
+}
+
+static size_t tcVoltageBatchVector(const ThermocoupleSegmentTable *table, const double *temperatures, const double *Tcj, double *millivolts, size_t count)
+{
+	size_t i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256d inRange;
+		__m256d mv = tcVoltageAVX2(table, _mm256_loadu_pd(temperatures + i), &inRange);
+		if (Tcj)
+			mv = _mm256_sub_pd(mv, tcColdJunctionAVX2(table, _mm256_loadu_pd(Tcj + i)));
+		_mm256_storeu_pd(millivolts + i, _mm256_blendv_pd(_mm256_set1_pd(TC_OUT_OF_RANGE_TEMPERATURE), mv, inRange));
+	}
+	return i;
+}
+
+static inline __m256 tcColdJunctionSelectAVX2(const float *column, int n, __m256 above1, __m256 above2)
+{
+	__m256 c = _mm256_set1_ps(column[0]);
+	if (n > 1)
+		c = _mm256_blendv_ps(c, _mm256_set1_ps(column[1]), above1);
+	if (n > 2)
+		c = _mm256_blendv_ps(c, _mm256_set1_ps(column[2]), above2);
+	return c;
+}
+
+static inline __m256 tcColdJunctionAVX2(const ThermocoupleSegmentTable *table, __m256 Tcj)
+{
+	const int n = table->coldJunctionSegments;
+	const float *bp = table->coldJunctionBreakpointsSingle;
+	const float *cj = table->coldJunctionSingle;
+	__m256 above1 = _mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[1]), _CMP_GE_OQ);
+	__m256 above2 = _mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[(n > 2) ? 2 : 1]), _CMP_GE_OQ);
+
+#define TC_CJ(col) tcColdJunctionSelectAVX2(cj + (col) * n, n, above1, above2)
+	__m256 t = _mm256_sub_ps(Tcj, TC_CJ(TC_CJ_COEFF_T0));
+	__m256 numerator = _mm256_mul_ps(TC_CJ(TC_CJ_COEFF_P4), t);
+	numerator = _mm256_add_ps(TC_CJ(TC_CJ_COEFF_P3), numerator);
+	numerator = _mm256_add_ps(TC_CJ(TC_CJ_COEFF_P2), _mm256_mul_ps(t, numerator));
+	numerator = _mm256_add_ps(TC_CJ(TC_CJ_COEFF_P1), _mm256_mul_ps(t, numerator));
+	numerator = _mm256_mul_ps(t, numerator);
+	__m256 denominator = _mm256_add_ps(TC_CJ(TC_CJ_COEFF_Q1), _mm256_mul_ps(TC_CJ(TC_CJ_COEFF_Q2), t));
+	denominator = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(t, denominator));
+	return _mm256_add_ps(TC_CJ(TC_CJ_COEFF_V0), _mm256_div_ps(numerator, denominator));
+#undef TC_CJ
+}
+
+static inline __m256 tcColdJunctionSlopeAVX2(const ThermocoupleSegmentTable *table, __m256 Tcj, __m256 *slope)
+{
+	const int n = table->coldJunctionSegments;
+	const float *bp = table->coldJunctionBreakpointsSingle;
+	const float *cj = table->coldJunctionSingle;
+	__m256 above1 = _mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[1]), _CMP_GE_OQ);
+	__m256 above2 = _mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[(n > 2) ? 2 : 1]), _CMP_GE_OQ);
+
+#define TC_CJ(col) tcColdJunctionSelectAVX2(cj + (col) * n, n, above1, above2)
+	__m256 p1 = TC_CJ(TC_CJ_COEFF_P1), p2 = TC_CJ(TC_CJ_COEFF_P2), p3 = TC_CJ(TC_CJ_COEFF_P3), p4 = TC_CJ(TC_CJ_COEFF_P4);
+	__m256 q1 = TC_CJ(TC_CJ_COEFF_Q1), q2 = TC_CJ(TC_CJ_COEFF_Q2);
+	__m256 t = _mm256_sub_ps(Tcj, TC_CJ(TC_CJ_COEFF_T0));
+	__m256 numerator = _mm256_mul_ps(t, _mm256_add_ps(p1, _mm256_mul_ps(t, _mm256_add_ps(p2, _mm256_mul_ps(t, _mm256_add_ps(p3, _mm256_mul_ps(p4, t)))))));
+	__m256 denominator = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(t, _mm256_add_ps(q1, _mm256_mul_ps(q2, t))));
+	__m256 ratio = _mm256_div_ps(numerator, denominator);
+	__m256 dN = _mm256_add_ps(p1, _mm256_mul_ps(t, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), p2),
+		_mm256_mul_ps(t, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), p3), _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), p4), t))))));
+	__m256 dD = _mm256_add_ps(q1, _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), q2), t));
+	*slope = _mm256_div_ps(_mm256_sub_ps(dN, _mm256_mul_ps(dD, ratio)), denominator);
+	return _mm256_add_ps(TC_CJ(TC_CJ_COEFF_V0), ratio);
+#undef TC_CJ
+}
+
+static inline __m256 tcRationalAVX2(const float *c, int n, __m256i seg, __m256 x, int out)
+{
+#define TC_GATHER(col) _mm256_i32gather_ps(c + (col) * n, seg, 4)
+	__m256 numerator = _mm256_mul_ps(TC_GATHER(TC_COEFF_P4), x);
+	numerator = _mm256_add_ps(TC_GATHER(TC_COEFF_P3), numerator);
+	numerator = _mm256_add_ps(TC_GATHER(TC_COEFF_P2), _mm256_mul_ps(x, numerator));
+	numerator = _mm256_add_ps(TC_GATHER(TC_COEFF_P1), _mm256_mul_ps(x, numerator));
+	numerator = _mm256_mul_ps(x, numerator);
+	__m256 denominator = _mm256_mul_ps(TC_GATHER(TC_COEFF_Q3), x);
+	denominator = _mm256_add_ps(TC_GATHER(TC_COEFF_Q2), denominator);
+	denominator = _mm256_add_ps(TC_GATHER(TC_COEFF_Q1), _mm256_mul_ps(x, denominator));
+	denominator = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(x, denominator));
+	return _mm256_add_ps(TC_GATHER(out), _mm256_div_ps(numerator, denominator));
+#undef TC_GATHER
+}
+
+static inline __m256 tcRationalSlopeAVX2(const float *c, int n, __m256i seg, __m256 x, int out, __m256 *slope)
+{
+#define TC_GATHER(col) _mm256_i32gather_ps(c + (col) * n, seg, 4)
+	__m256 p1 = TC_GATHER(TC_COEFF_P1), p2 = TC_GATHER(TC_COEFF_P2), p3 = TC_GATHER(TC_COEFF_P3), p4 = TC_GATHER(TC_COEFF_P4);
+	__m256 q1 = TC_GATHER(TC_COEFF_Q1), q2 = TC_GATHER(TC_COEFF_Q2), q3 = TC_GATHER(TC_COEFF_Q3);
+	__m256 numerator = _mm256_mul_ps(x, _mm256_add_ps(p1, _mm256_mul_ps(x, _mm256_add_ps(p2, _mm256_mul_ps(x, _mm256_add_ps(p3, _mm256_mul_ps(p4, x)))))));
+	__m256 denominator = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(x, _mm256_add_ps(q1, _mm256_mul_ps(x, _mm256_add_ps(q2, _mm256_mul_ps(q3, x))))));
+	__m256 ratio = _mm256_div_ps(numerator, denominator);
+	__m256 dN = _mm256_add_ps(p1, _mm256_mul_ps(x, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), p2),
+		_mm256_mul_ps(x, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), p3), _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), p4), x))))));
+	__m256 dD = _mm256_add_ps(q1, _mm256_mul_ps(x, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), q2), _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), q3), x))));
+	*slope = _mm256_div_ps(_mm256_sub_ps(dN, _mm256_mul_ps(dD, ratio)), denominator);
+	return _mm256_add_ps(TC_GATHER(out), ratio);
+#undef TC_GATHER
+}
+
+static inline __m256 tcPolynomialAVX2(const float *c, int n, int degree, __m256i seg, __m256 x)
+{
+#define TC_GATHER(col) _mm256_i32gather_ps(c + (col) * n, seg, 4)
+	__m256 r = TC_GATHER(TC_POLYNOMIAL_A1 + degree - 1);
+	for (int k = degree - 1; k > 0; k--)
+		r = _mm256_add_ps(TC_GATHER(TC_POLYNOMIAL_A1 + k - 1), _mm256_mul_ps(x, r));
+	return _mm256_add_ps(TC_GATHER(TC_COEFF_T0), _mm256_mul_ps(x, r));
+#undef TC_GATHER
+}
+
+static inline __m256 tcPolynomialSlopeAVX2(const float *c, int n, int degree, __m256i seg, __m256 x, __m256 *slope)
+{
+#define TC_GATHER(col) _mm256_i32gather_ps(c + (col) * n, seg, 4)
+	__m256 r = TC_GATHER(TC_POLYNOMIAL_A1 + degree - 1);
+	__m256 dr = _mm256_setzero_ps();
+	for (int k = degree - 1; k > 0; k--)
+	{
+		dr = _mm256_add_ps(r, _mm256_mul_ps(x, dr));
+		r = _mm256_add_ps(TC_GATHER(TC_POLYNOMIAL_A1 + k - 1), _mm256_mul_ps(x, r));
+	}
+	*slope = _mm256_add_ps(r, _mm256_mul_ps(x, dr));
+	return _mm256_add_ps(TC_GATHER(TC_COEFF_T0), _mm256_mul_ps(x, r));
+#undef TC_GATHER
+}
+
+static inline __m256 tcInverseAVX2(const float *c, int n, int degree, __m256i seg, __m256 x)
+{
+	return degree ? tcPolynomialAVX2(c, n, degree, seg, x) : tcRationalAVX2(c, n, seg, x, TC_COEFF_T0);
+}
+
+static inline __m256 tcInverseSlopeAVX2(const float *c, int n, int degree, __m256i seg, __m256 x, __m256 *slope)
+{
+	return degree ? tcPolynomialSlopeAVX2(c, n, degree, seg, x, slope) : tcRationalSlopeAVX2(c, n, seg, x, TC_COEFF_T0, slope);
+}
+
+static inline __m256 tcEvaluateAVX2(const float *c, int n, __m256i seg, __m256 input, int in, int out)
+{
+	return tcRationalAVX2(c, n, seg, _mm256_sub_ps(input, _mm256_i32gather_ps(c + in * n, seg, 4)), out);
+}
+
+static inline __m256i tcSegmentAVX2(const ThermocoupleSegmentTable *table, __m256 mv, __m256 *inRange)
+{
+	const int n = table->segments;
+	const float *bp = table->breakpointsSingle;
+	__m256i seg = _mm256_setzero_si256();
+
+	if (table->upperInclusive)
+	{
+		*inRange = _mm256_and_ps(_mm256_cmp_ps(mv, _mm256_set1_ps(bp[0]), _CMP_GT_OQ), _mm256_cmp_ps(mv, _mm256_set1_ps(bp[n]), _CMP_LE_OQ));
+		for (int i = 1; i < n; i++)
+			seg = _mm256_sub_epi32(seg, _mm256_castps_si256(_mm256_cmp_ps(mv, _mm256_set1_ps(bp[i]), _CMP_GT_OQ)));
+	}
+	else
+	{
+		*inRange = _mm256_and_ps(_mm256_cmp_ps(mv, _mm256_set1_ps(bp[0]), _CMP_GE_OQ), _mm256_cmp_ps(mv, _mm256_set1_ps(bp[n]), _CMP_LT_OQ));
+		for (int i = 1; i < n; i++)
+			seg = _mm256_sub_epi32(seg, _mm256_castps_si256(_mm256_cmp_ps(mv, _mm256_set1_ps(bp[i]), _CMP_GE_OQ)));
+	}
+	return seg;
+}
+
+static inline __m256 tcTemperatureAVX2(const ThermocoupleSegmentTable *table, __m256 mv)
+{
+	__m256 inRange;
+	__m256i seg = tcSegmentAVX2(table, mv, &inRange);
+	__m256 x = _mm256_sub_ps(mv, _mm256_i32gather_ps(table->coefficientsSingle + TC_COEFF_V0 * table->segments, seg, 4));
+	__m256 temperature = tcInverseAVX2(table->coefficientsSingle, table->segments, table->degree, seg, x);
+	return _mm256_blendv_ps(_mm256_set1_ps(TC_OUT_OF_RANGE_TEMPERATURE), temperature, inRange);
+}
+
+static inline __m256 tcSensitivityAVX2(const ThermocoupleSegmentTable *table, __m256 raw, __m256 Tcj, __m256 sigmaMillivolts, __m256 sigmaTcj, __m256 *slope, __m256 *uncertainty)
+{
+	const int n = table->segments;
+	__m256 coldJunctionSlope, inRange;
+	__m256 mv = _mm256_add_ps(raw, tcColdJunctionSlopeAVX2(table, Tcj, &coldJunctionSlope));
+	__m256i seg = tcSegmentAVX2(table, mv, &inRange);
+	__m256 x = _mm256_sub_ps(mv, _mm256_i32gather_ps(table->coefficientsSingle + TC_COEFF_V0 * n, seg, 4));
+	__m256 temperature = tcInverseSlopeAVX2(table->coefficientsSingle, n, table->degree, seg, x, slope);
+	__m256 sigmaColdJunction = _mm256_mul_ps(coldJunctionSlope, sigmaTcj);
+	__m256 variance = _mm256_add_ps(_mm256_mul_ps(sigmaMillivolts, sigmaMillivolts), _mm256_mul_ps(sigmaColdJunction, sigmaColdJunction));
+	*uncertainty = _mm256_and_ps(inRange, _mm256_mul_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), *slope), _mm256_sqrt_ps(variance)));
+	*slope = _mm256_and_ps(inRange, *slope);
+	return _mm256_blendv_ps(_mm256_set1_ps(TC_OUT_OF_RANGE_TEMPERATURE), temperature, inRange);
+}
+
+static inline __m256 tcAdcTemperatureAVX2(const ThermocoupleSegmentTable *table, const ThermocoupleAdcChannel<float> &channel, __m256i code)
+{
+	const int n = table->segments;
+	const int32_t *k = channel.threshold;
+	__m256i inRange = _mm256_andnot_si256(_mm256_cmpgt_epi32(code, _mm256_set1_epi32(k[n])), _mm256_cmpgt_epi32(code, _mm256_set1_epi32(k[0])));
+	__m256i seg = _mm256_setzero_si256();
+
+	for (int i = 1; i < n; i++)
+		seg = _mm256_sub_epi32(seg, _mm256_cmpgt_epi32(code, _mm256_set1_epi32(k[i])));
+
+	__m256i offset = _mm256_sub_epi32(code, _mm256_i32gather_epi32((const int *)channel.origin, seg, 4));
+	__m256 x = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(offset), _mm256_set1_ps(channel.millivoltsPerCode)), _mm256_i32gather_ps(channel.fraction, seg, 4));
+	__m256 temperature = tcInverseAVX2(table->coefficientsSingle, n, table->degree, seg, x);
+	return _mm256_blendv_ps(_mm256_set1_ps(TC_OUT_OF_RANGE_TEMPERATURE), temperature, _mm256_castsi256_ps(inRange));
+}
+
+static inline __m256 tcVoltageAVX2(const ThermocoupleSegmentTable *table, __m256 temperature, __m256 *inRange)
+{
+	const int n = table->segments;
+	const float *bp = table->breakpointsSingle;
+	__m256i seg = _mm256_setzero_si256();
+
+	*inRange = _mm256_and_ps(_mm256_cmp_ps(temperature, _mm256_set1_ps(bp[0]), _CMP_GE_OQ), _mm256_cmp_ps(temperature, _mm256_set1_ps(bp[n]), _CMP_LE_OQ));
+	for (int i = 1; i < n; i++)
+		seg = _mm256_sub_epi32(seg, _mm256_castps_si256(_mm256_cmp_ps(temperature, _mm256_set1_ps(bp[i]), _CMP_GE_OQ)));
+
+	return tcEvaluateAVX2(table->coefficientsSingle, n, seg, temperature, TC_COEFF_T0, TC_COEFF_V0);
+}
+
+static inline uint64_t tcStatusAVX2(const ThermocoupleSegmentTable *table, __m256 raw, __m256 mv)
+{
+	const int n = table->segments;
+	const float *bp = table->breakpointsSingle;
+	__m256 under, over;
+
+	if (table->upperInclusive)
+	{
+		under = _mm256_cmp_ps(mv, _mm256_set1_ps(bp[0]), _CMP_NGT_UQ);
+		over = _mm256_cmp_ps(mv, _mm256_set1_ps(bp[n]), _CMP_NLE_UQ);
+	}
+	else
+	{
+		under = _mm256_cmp_ps(mv, _mm256_set1_ps(bp[0]), _CMP_NGE_UQ);
+		over = _mm256_cmp_ps(mv, _mm256_set1_ps(bp[n]), _CMP_NLT_UQ);
+	}
+	__m256 open = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), raw), _mm256_set1_ps(TC_OPEN_CIRCUIT_MILLIVOLTS), _CMP_NLT_UQ);
+
+	return tcSpreadMask8(_mm256_movemask_ps(under)) * TC_STATUS_UNDER_RANGE
+		| tcSpreadMask8(_mm256_movemask_ps(over)) * TC_STATUS_OVER_RANGE
+		| tcSpreadMask8(_mm256_movemask_ps(open)) * TC_STATUS_OPEN_CIRCUIT;
+}
+
+static inline uint64_t tcColdJunctionStatusAVX2(const ThermocoupleSegmentTable *table, __m256 Tcj)
+{
+	const float *bp = table->coldJunctionBreakpointsSingle;
+	__m256 outside = _mm256_or_ps(_mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[0]), _CMP_NGE_UQ), _mm256_cmp_ps(Tcj, _mm256_set1_ps(bp[table->coldJunctionSegments]), _CMP_NLE_UQ));
+	return tcSpreadMask8(_mm256_movemask_ps(outside)) * TC_STATUS_COLD_JUNCTION_RANGE;
+}
+
+static inline __m256 tcCalibratedMillivoltsAVX2(const ThermocoupleCalibration<float> *calibration, __m256 raw)
+{
+	return _mm256_add_ps(_mm256_mul_ps(raw, _mm256_set1_ps(calibration->gain)), _mm256_set1_ps(calibration->offset));
+}
+
+static inline __m256 tcDeviationAVX2(const ThermocoupleCalibration<float> *calibration, __m256 t)
+{
+	const float *d = calibration->deviation;
+	__m256 deviation = _mm256_add_ps(_mm256_set1_ps(d[2]), _mm256_mul_ps(t, _mm256_set1_ps(d[3])));
+	deviation = _mm256_add_ps(_mm256_set1_ps(d[1]), _mm256_mul_ps(t, deviation));
+	deviation = _mm256_add_ps(_mm256_set1_ps(d[0]), _mm256_mul_ps(t, deviation));
+	__m256 inRange = _mm256_cmp_ps(t, _mm256_set1_ps(TC_OUT_OF_RANGE_TEMPERATURE), _CMP_NEQ_UQ);
+	return _mm256_blendv_ps(t, _mm256_add_ps(t, deviation), inRange);
+}
+
+template<bool Status, bool Calibrated> static size_t tcBatchVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<float> *calibration, const float *millivolts, const float *Tcj, float *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	uint64_t bits = 0;
+	size_t i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 raw = _mm256_loadu_ps(millivolts + i);
+		__m256 tcj = _mm256_loadu_ps(Tcj + i);
+		__m256 mv = _mm256_add_ps(Calibrated ? tcCalibratedMillivoltsAVX2(calibration, raw) : raw, tcColdJunctionAVX2(table, tcj));
+		__m256 temperature = tcTemperatureAVX2(table, mv);
+		_mm256_storeu_ps(temperatures + i, Calibrated ? tcDeviationAVX2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint64_t lanes = tcStatusAVX2(table, raw, mv) | tcColdJunctionStatusAVX2(table, tcj);
+			bits |= lanes;
+			if (status)
+				memcpy(status + i, &lanes, 8);
+		}
+	}
+	if (Status)
+		*summary |= tcFoldStatus(bits);
+	return i;
+}
+
+template<bool Status, bool Calibrated> static size_t tcConvertVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<float> *calibration, const float *millivolts, float Vcj, uint8_t coldJunctionStatus, float *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	const uint64_t cj = coldJunctionStatus * 0x0101010101010101ull;
+	uint64_t bits = 0;
+	size_t i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 raw = _mm256_loadu_ps(millivolts + i);
+		__m256 mv = _mm256_add_ps(Calibrated ? tcCalibratedMillivoltsAVX2(calibration, raw) : raw, _mm256_set1_ps(Vcj));
+		__m256 temperature = tcTemperatureAVX2(table, mv);
+		_mm256_storeu_ps(temperatures + i, Calibrated ? tcDeviationAVX2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint64_t lanes = tcStatusAVX2(table, raw, mv) | cj;
+			bits |= lanes;
+			if (status)
+				memcpy(status + i, &lanes, 8);
+		}
+	}
+	if (Status)
+		*summary |= tcFoldStatus(bits);
+	return i;
+}
+
+static size_t tcSensitivityVector(const ThermocoupleSegmentTable *table, const float *millivolts, const float *Tcj, float sigmaMillivolts, float sigmaTcj, float *temperatures, float *slopes, float *uncertainties, size_t count)
+{
+	size_t i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 slope, uncertainty;
+		__m256 temperature = tcSensitivityAVX2(table, _mm256_loadu_ps(millivolts + i), _mm256_loadu_ps(Tcj + i), _mm256_set1_ps(sigmaMillivolts), _mm256_set1_ps(sigmaTcj), &slope, &uncertainty);
+		_mm256_storeu_ps(temperatures + i, temperature);
+		if (slopes)
+			_mm256_storeu_ps(slopes + i, slope);
+		if (uncertainties)
+			_mm256_storeu_ps(uncertainties + i, uncertainty);
+	}
+	return i;
+}
+
+static size_t tcVoltageBatchVector(const ThermocoupleSegmentTable *table, const float *temperatures, const float *Tcj, float *millivolts, size_t count)
+{
+	size_t i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 inRange;
+		__m256 mv = tcVoltageAVX2(table, _mm256_loadu_ps(temperatures + i), &inRange);
+		if (Tcj)
+			mv = _mm256_sub_ps(mv, tcColdJunctionAVX2(table, _mm256_loadu_ps(Tcj + i)));
+		_mm256_storeu_ps(millivolts + i, _mm256_blendv_ps(_mm256_set1_ps(TC_OUT_OF_RANGE_TEMPERATURE), mv, inRange));
+	}
+	return i;
+}
+
+#endif
+
+/*********************************************************************************************************
+SSE2 and NEON kernels - 2 double lanes, coefficients loaded per lane
+*********************************************************************************************************/
+
+#if defined(TC_BATCH_SSE2) || defined(TC_BATCH_NEON)
+
+#if defined(TC_BATCH_SSE2)
+typedef __m128d tc_v2d;
+#define TC_V2_SET1(a)      _mm_set1_pd(a)
+#define TC_V2_SET(lo, hi)  _mm_set_pd((hi), (lo))
+#define TC_V2_LOAD(p)      _mm_loadu_pd(p)
+#define TC_V2_STORE(p, v)  _mm_storeu_pd((p), (v))
+#define TC_V2_ADD(a, b)    _mm_add_pd((a), (b))
+#define TC_V2_SUB(a, b)    _mm_sub_pd((a), (b))
+#define TC_V2_MUL(a, b)    _mm_mul_pd((a), (b))
+#define TC_V2_DIV(a, b)    _mm_div_pd((a), (b))
+#define TC_V2_LANE(v, i)   (((const double *)&(v))[i])
+#else
+typedef float64x2_t tc_v2d;
+#define TC_V2_SET1(a)      vdupq_n_f64(a)
+#define TC_V2_SET(lo, hi)  vsetq_lane_f64((hi), vdupq_n_f64(lo), 1)
+#define TC_V2_LOAD(p)      vld1q_f64(p)
+#define TC_V2_STORE(p, v)  vst1q_f64((p), (v))
+#define TC_V2_ADD(a, b)    vaddq_f64((a), (b))
+#define TC_V2_SUB(a, b)    vsubq_f64((a), (b))
+#define TC_V2_MUL(a, b)    vmulq_f64((a), (b))
+#define TC_V2_DIV(a, b)    vdivq_f64((a), (b))
+#define TC_V2_LANE(v, i)   vgetq_lane_f64((v), (i))
+#endif
+
+static inline tc_v2d tcColdJunctionV2(const ThermocoupleSegmentTable *table, tc_v2d Tcj)
+{
+	const uint8_t n = table->coldJunctionSegments;
+	const double *bp = table->coldJunctionBreakpoints;
+	const double *cj = table->coldJunction;
+	double lane[2] = { TC_V2_LANE(Tcj, 0), TC_V2_LANE(Tcj, 1) };
+	uint8_t seg[2] = { 0, 0 };
+
+	for (uint8_t i = 1; i < n; i++)
+	{
+		seg[0] += (lane[0] >= bp[i]);
+		seg[1] += (lane[1] >= bp[i]);
+	}
+#define TC_CJ(col) TC_V2_SET(cj[(col) * n + seg[0]], cj[(col) * n + seg[1]])
+	tc_v2d t = TC_V2_SUB(Tcj, TC_CJ(TC_CJ_COEFF_T0));
+	tc_v2d numerator = TC_V2_MUL(TC_CJ(TC_CJ_COEFF_P4), t);
+	numerator = TC_V2_ADD(TC_CJ(TC_CJ_COEFF_P3), numerator);
+	numerator = TC_V2_ADD(TC_CJ(TC_CJ_COEFF_P2), TC_V2_MUL(t, numerator));
+	numerator = TC_V2_ADD(TC_CJ(TC_CJ_COEFF_P1), TC_V2_MUL(t, numerator));
+	numerator = TC_V2_MUL(t, numerator);
+	tc_v2d denominator = TC_V2_ADD(TC_CJ(TC_CJ_COEFF_Q1), TC_V2_MUL(TC_CJ(TC_CJ_COEFF_Q2), t));
+	denominator = TC_V2_ADD(TC_V2_SET1(1.0), TC_V2_MUL(t, denominator));
+	return TC_V2_ADD(TC_CJ(TC_CJ_COEFF_V0), TC_V2_DIV(numerator, denominator));
+#undef TC_CJ
+}
+
+static inline tc_v2d tcEvaluateV2(const double *c, uint8_t n, const uint8_t *seg, tc_v2d input, int in, int out)
+{
+#define TC_COEFF(col) TC_V2_SET(c[(col) * n + seg[0]], c[(col) * n + seg[1]])
+	tc_v2d x = TC_V2_SUB(input, TC_COEFF(in));
+	tc_v2d numerator = TC_V2_MUL(TC_COEFF(TC_COEFF_P4), x);
+	numerator = TC_V2_ADD(TC_COEFF(TC_COEFF_P3), numerator);
+	numerator = TC_V2_ADD(TC_COEFF(TC_COEFF_P2), TC_V2_MUL(x, numerator));
+	numerator = TC_V2_ADD(TC_COEFF(TC_COEFF_P1), TC_V2_MUL(x, numerator));
+	numerator = TC_V2_MUL(x, numerator);
+	tc_v2d denominator = TC_V2_MUL(TC_COEFF(TC_COEFF_Q3), x);
+	denominator = TC_V2_ADD(TC_COEFF(TC_COEFF_Q2), denominator);
+	denominator = TC_V2_ADD(TC_COEFF(TC_COEFF_Q1), TC_V2_MUL(x, denominator));
+	denominator = TC_V2_ADD(TC_V2_SET1(1.0), TC_V2_MUL(x, denominator));
+	return TC_V2_ADD(TC_COEFF(out), TC_V2_DIV(numerator, denominator));
+#undef TC_COEFF
+}
+
+// See tcPolynomialSegment()
+static inline tc_v2d tcPolynomialV2(const double *c, uint8_t n, uint8_t degree, const uint8_t *seg, tc_v2d input)
+{
+#define TC_COEFF(col) TC_V2_SET(c[(col) * n + seg[0]], c[(col) * n + seg[1]])
+	tc_v2d x = TC_V2_SUB(input, TC_COEFF(TC_COEFF_V0));
+	tc_v2d r = TC_COEFF(TC_POLYNOMIAL_A1 + degree - 1);
+	for (uint8_t k = degree - 1; k > 0; k--)
+		r = TC_V2_ADD(TC_COEFF(TC_POLYNOMIAL_A1 + k - 1), TC_V2_MUL(x, r));
+	return TC_V2_ADD(TC_COEFF(TC_COEFF_T0), TC_V2_MUL(x, r));
+#undef TC_COEFF
+}
+
+static inline tc_v2d tcTemperatureV2(const ThermocoupleSegmentTable *table, tc_v2d mv)
+{
+	const uint8_t n = table->segments;
+	const double *bp = table->breakpoints;
+	double lane[2] = { TC_V2_LANE(mv, 0), TC_V2_LANE(mv, 1) };
+	uint8_t seg[2] = { 0, 0 };
+	bool inRange[2];
+
+	for (uint8_t l = 0; l < 2; l++)
+	{
+		if (table->upperInclusive)
+		{
+			inRange[l] = (bp[0] < lane[l] && lane[l] <= bp[n]);
+			for (uint8_t i = 1; i < n; i++)
+				seg[l] += (lane[l] > bp[i]);
+		}
+		else
+		{
+			inRange[l] = (bp[0] <= lane[l] && lane[l] < bp[n]);
+			for (uint8_t i = 1; i < n; i++)
+				seg[l] += (lane[l] >= bp[i]);
+		}
+	}
+
+	tc_v2d temperature = table->degree
+		? tcPolynomialV2(table->coefficients, n, table->degree, seg, mv)
+		: tcEvaluateV2(table->coefficients, n, seg, mv, TC_COEFF_V0, TC_COEFF_T0);
+	return TC_V2_SET(inRange[0] ? TC_V2_LANE(temperature, 0) : TC_OUT_OF_RANGE_TEMPERATURE, inRange[1] ? TC_V2_LANE(temperature, 1) : TC_OUT_OF_RANGE_TEMPERATURE);
+}
+
+static inline tc_v2d tcCalibratedMillivoltsV2(const ThermocoupleCalibration<double> *calibration, tc_v2d raw)
+{
+	return TC_V2_ADD(TC_V2_MUL(raw, TC_V2_SET1(calibration->gain)), TC_V2_SET1(calibration->offset));
+}
+
+static inline tc_v2d tcDeviationV2(const ThermocoupleCalibration<double> *calibration, tc_v2d t)
+{
+	return TC_V2_SET(tcDeviation<double>(*calibration, TC_V2_LANE(t, 0)), tcDeviation<double>(*calibration, TC_V2_LANE(t, 1)));
+}
+
+// With two lanes the status bits come from the scalar compares on each lane
+template<bool Status, bool Calibrated> static size_t tcBatchVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const double *millivolts, const double *Tcj, double *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	uint8_t bits = 0;
+	size_t i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		tc_v2d raw = TC_V2_LOAD(millivolts + i);
+		tc_v2d tcj = TC_V2_LOAD(Tcj + i);
+		tc_v2d mv = TC_V2_ADD(Calibrated ? tcCalibratedMillivoltsV2(calibration, raw) : raw, tcColdJunctionV2(table, tcj));
+		tc_v2d temperature = tcTemperatureV2(table, mv);
+		TC_V2_STORE(temperatures + i, Calibrated ? tcDeviationV2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint8_t lane0 = tcStatusScalar(table, TC_V2_LANE(raw, 0), TC_V2_LANE(mv, 0)) | tcColdJunctionStatus(table, TC_V2_LANE(tcj, 0));
+			uint8_t lane1 = tcStatusScalar(table, TC_V2_LANE(raw, 1), TC_V2_LANE(mv, 1)) | tcColdJunctionStatus(table, TC_V2_LANE(tcj, 1));
+			bits |= lane0 | lane1;
+			if (status)
+			{
+				status[i] = lane0;
+				status[i + 1] = lane1;
+			}
+		}
+	}
+	if (Status)
+		*summary |= bits;
+	return i;
+}
+
+template<bool Status, bool Calibrated> static size_t tcConvertVector(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const double *millivolts, double Vcj, uint8_t coldJunctionStatus, double *temperatures, uint8_t *status, uint8_t *summary, size_t count)
+{
+	uint8_t bits = 0;
+	size_t i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		tc_v2d raw = TC_V2_LOAD(millivolts + i);
+		tc_v2d mv = TC_V2_ADD(Calibrated ? tcCalibratedMillivoltsV2(calibration, raw) : raw, TC_V2_SET1(Vcj));
+		tc_v2d temperature = tcTemperatureV2(table, mv);
+		TC_V2_STORE(temperatures + i, Calibrated ? tcDeviationV2(calibration, temperature) : temperature);
+		if (Status)
+		{
+			uint8_t lane0 = tcStatusScalar(table, TC_V2_LANE(raw, 0), TC_V2_LANE(mv, 0)) | coldJunctionStatus;
+			uint8_t lane1 = tcStatusScalar(table, TC_V2_LANE(raw, 1), TC_V2_LANE(mv, 1)) | coldJunctionStatus;
+			bits |= lane0 | lane1;
+			if (status)
+			{
+				status[i] = lane0;
+				status[i + 1] = lane1;
+			}
+		}
+	}
+	if (Status)
+		*summary |= bits;
+	return i;
+}
+
+#endif
+
+/*********************************************************************************************************
+Public batch entry points
+*********************************************************************************************************/
+
+// Shared by the plain, status and calibrated forms - Status and Calibrated
+// are compile time constants, so the plain forms carry no status or
+// calibration code
+template<bool Status, bool Calibrated> static uint8_t tcBatch(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const double *millivolts, const double *Tcj, double *temperatures, uint8_t *status, size_t count)
+{
+	uint8_t summary = 0;
+	size_t done = 0;
+
+#if defined(TC_BATCH_AVX2) || defined(TC_BATCH_SSE2) || defined(TC_BATCH_NEON)
+	done = tcBatchVector<Status, Calibrated>(table, calibration, millivolts, Tcj, temperatures, status, &summary, count);
+#endif
+	return summary | tcBatchScalar<Status, Calibrated>(table, calibration, millivolts + done, Tcj + done, temperatures + done, status ? status + done : NULL, count - done);
+}
+
+template<bool Status, bool Calibrated> static uint8_t tcBatch(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<float> *calibration, const float *millivolts, const float *Tcj, float *temperatures, uint8_t *status, size_t count)
+{
+#if defined(__SIZEOF_DOUBLE__) && (__SIZEOF_DOUBLE__ == __SIZEOF_FLOAT__)
+	// double is float here, and the float path shares the double tables
+	return tcBatchScalar<Status, Calibrated, double>(table, (const ThermocoupleCalibration<double> *)calibration, (const double *)millivolts, (const double *)Tcj, (double *)temperatures, status, count);
+#else
+	uint8_t summary = 0;
+	size_t done = 0;
+#if defined(TC_BATCH_AVX2)
+	done = tcBatchVector<Status, Calibrated>(table, calibration, millivolts, Tcj, temperatures, status, &summary, count);
+#endif
+	return summary | tcBatchScalar<Status, Calibrated>(table, calibration, millivolts + done, Tcj + done, temperatures + done, status ? status + done : NULL, count - done);
+#endif
+}
+
+template<bool Status, bool Calibrated> static uint8_t tcConvert(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<double> *calibration, const ThermocoupleColdJunction<double> &coldJunction, const double *millivolts, double *temperatures, uint8_t *status, size_t count)
+{
+	uint8_t summary = 0;
+	size_t done = 0;
+
+#if defined(TC_BATCH_AVX2) || defined(TC_BATCH_SSE2) || defined(TC_BATCH_NEON)
+	done = tcConvertVector<Status, Calibrated>(table, calibration, millivolts, coldJunction.millivolts, coldJunction.status, temperatures, status, &summary, count);
+#endif
+	return summary | tcConvertScalar<Status, Calibrated>(table, calibration, millivolts + done, coldJunction.millivolts, coldJunction.status, temperatures + done, status ? status + done : NULL, count - done);
+}
+
+template<bool Status, bool Calibrated> static uint8_t tcConvert(const ThermocoupleSegmentTable *table, const ThermocoupleCalibration<float> *calibration, const ThermocoupleColdJunction<float> &coldJunction, const float *millivolts, float *temperatures, uint8_t *status, size_t count)
+{
+#if defined(__SIZEOF_DOUBLE__) && (__SIZEOF_DOUBLE__ == __SIZEOF_FLOAT__)
+	return tcConvertScalar<Status, Calibrated, double>(table, (const ThermocoupleCalibration<double> *)calibration, (const double *)millivolts, coldJunction.millivolts, coldJunction.status, (double *)temperatures, status, count);
+#else
+	uint8_t summary = 0;
+	size_t done = 0;
+#if defined(TC_BATCH_AVX2)
+	done = tcConvertVector<Status, Calibrated>(table, calibration, millivolts, coldJunction.millivolts, coldJunction.status, temperatures, status, &summary, count);
+#endif
+	return summary | tcConvertScalar<Status, Calibrated>(table, calibration, millivolts + done, coldJunction.millivolts, coldJunction.status, temperatures + done, status ? status + done : NULL, count - done);
+#endif
+}
+
+// Raw ADC codes - AVX2 only, as the codes need integer vector compares
+static void tcAdcBatch(const ThermocoupleSegmentTable *table, const ThermocoupleAdcChannel<double> &channel, const int32_t *codes, double *temperatures, size_t count)
+{
+	size_t i = 0;
+#if defined(TC_BATCH_AVX2)
+	for (; i + 4 <= count; i += 4)
+		_mm256_storeu_pd(temperatures + i, tcAdcTemperatureAVX2(table, channel, _mm_loadu_si128((const __m128i *)(codes + i))));
+#endif
+	for (; i < count; i++)
+		temperatures[i] = tcAdcTemperatureScalar<double>(table, channel, codes[i]);
+}
+
+static void tcAdcBatch(const ThermocoupleSegmentTable *table, const ThermocoupleAdcChannel<float> &channel, const int32_t *codes, float *temperatures, size_t count)
+{
+	size_t i = 0;
+#if defined(TC_BATCH_AVX2)
+	for (; i + 8 <= count; i += 8)
+		_mm256_storeu_ps(temperatures + i, tcAdcTemperatureAVX2(table, channel, _mm256_loadu_si256((const __m256i *)(codes + i))));
+#endif
+	for (; i < count; i++)
+		temperatures[i] = tcAdcTemperatureScalar<tc_single_t>(table, channel, codes[i]);
+}
+
+// Sensitivity forms - AVX2 only, like the ADC codes: the 2 lane kernels
+// don't beat the scalar loop once the derivative is added
+static void tcSensitivityBatch(const ThermocoupleSegmentTable *table, const double *millivolts, const double *Tcj, double sigmaMillivolts, double sigmaTcj, double *temperatures, double *slopes, double *uncertainties, size_t count)
+{
+	size_t done = 0;
+#if defined(TC_BATCH_AVX2)
+	done = tcSensitivityVector(table, millivolts, Tcj, sigmaMillivolts, sigmaTcj, temperatures, slopes, uncertainties, count);
+#endif
+	tcSensitivityBatchScalar(table, millivolts + done, Tcj + done, sigmaMillivolts, sigmaTcj, temperatures + done, slopes ? slopes + done : NULL, uncertainties ? uncertainties + done : NULL, count - done);
+}
+
+static void tcSensitivityBatch(const ThermocoupleSegmentTable *table, const float *millivolts, const float *Tcj, float sigmaMillivolts, float sigmaTcj, float *temperatures, float *slopes, float *uncertainties, size_t count)
+{
+#if defined(__SIZEOF_DOUBLE__) && (__SIZEOF_DOUBLE__ == __SIZEOF_FLOAT__)
+	tcSensitivityBatchScalar<double>(table, (const double *)millivolts, (const double *)Tcj, sigmaMillivolts, sigmaTcj, (double *)temperatures, (double *)slopes, (double *)uncertainties, count);
+#else
+	size_t done = 0;
+#if defined(TC_BATCH_AVX2)
+	done = tcSensitivityVector(table, millivolts, Tcj, sigmaMillivolts, sigmaTcj, temperatures, slopes, uncertainties, count);
+#endif
+	tcSensitivityBatchScalar(table, millivolts + done, Tcj + done, sigmaMillivolts, sigmaTcj, temperatures + done, slopes ? slopes + done : NULL, uncertainties ? uncertainties + done : NULL, count - done);
+#endif
+}
+
+void AbstractThermocouple::getTemperatures(const double *millivolts, const double *Tcj, double *temperatures, size_t count)
+{
+	tcBatch<false, false>(this->temperatureTable(), NULL, millivolts, Tcj, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::getTemperatures(const float *millivolts, const float *Tcj, float *temperatures, size_t count)
+{
+	tcBatch<false, false>(this->temperatureTable(), NULL, millivolts, Tcj, temperatures, NULL, count);
+}
+
+uint8_t AbstractThermocouple::getTemperatures(const double *millivolts, const double *Tcj, double *temperatures, uint8_t *status, size_t count)
+{
+	return tcBatch<true, false>(this->temperatureTable(), NULL, millivolts, Tcj, temperatures, status, count);
+}
+
+uint8_t AbstractThermocouple::getTemperatures(const float *millivolts, const float *Tcj, float *temperatures, uint8_t *status, size_t count)
+{
+	return tcBatch<true, false>(this->temperatureTable(), NULL, millivolts, Tcj, temperatures, status, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleColdJunction<double> &coldJunction, const double *millivolts, double *temperatures, size_t count)
+{
+	tcConvert<false, false>(this->temperatureTable(), NULL, coldJunction, millivolts, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleColdJunction<float> &coldJunction, const float *millivolts, float *temperatures, size_t count)
+{
+	tcConvert<false, false>(this->temperatureTable(), NULL, coldJunction, millivolts, temperatures, NULL, count);
+}
+
+uint8_t AbstractThermocouple::convert(const ThermocoupleColdJunction<double> &coldJunction, const double *millivolts, double *temperatures, uint8_t *status, size_t count)
+{
+	return tcConvert<true, false>(this->temperatureTable(), NULL, coldJunction, millivolts, temperatures, status, count);
+}
+
+uint8_t AbstractThermocouple::convert(const ThermocoupleColdJunction<float> &coldJunction, const float *millivolts, float *temperatures, uint8_t *status, size_t count)
+{
+	return tcConvert<true, false>(this->temperatureTable(), NULL, coldJunction, millivolts, temperatures, status, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleAdcChannel<double> &channel, const int32_t *codes, double *temperatures, size_t count)
+{
+	tcAdcBatch(this->temperatureTable(), channel, codes, temperatures, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleAdcChannel<float> &channel, const int32_t *codes, float *temperatures, size_t count)
+{
+	tcAdcBatch(this->temperatureTable(), channel, codes, temperatures, count);
+}
+
+void AbstractThermocouple::getTemperatures(const ThermocoupleCalibration<double> &calibration, const double *millivolts, const double *Tcj, double *temperatures, size_t count)
+{
+	tcBatch<false, true>(this->temperatureTable(), &calibration, millivolts, Tcj, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::getTemperatures(const ThermocoupleCalibration<float> &calibration, const float *millivolts, const float *Tcj, float *temperatures, size_t count)
+{
+	tcBatch<false, true>(this->temperatureTable(), &calibration, millivolts, Tcj, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleColdJunction<double> &coldJunction, const ThermocoupleCalibration<double> &calibration, const double *millivolts, double *temperatures, size_t count)
+{
+	tcConvert<false, true>(this->temperatureTable(), &calibration, coldJunction, millivolts, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::convert(const ThermocoupleColdJunction<float> &coldJunction, const ThermocoupleCalibration<float> &calibration, const float *millivolts, float *temperatures, size_t count)
+{
+	tcConvert<false, true>(this->temperatureTable(), &calibration, coldJunction, millivolts, temperatures, NULL, count);
+}
+
+void AbstractThermocouple::getSensitivities(const double *millivolts, const double *Tcj, double sigmaMillivolts, double sigmaTcj, double *temperatures, double *slopes, double *uncertainties, size_t count)
+{
+	tcSensitivityBatch(this->temperatureTable(), millivolts, Tcj, sigmaMillivolts, sigmaTcj, temperatures, slopes, uncertainties, count);
+}
+
+void AbstractThermocouple::getSensitivities(const float *millivolts, const float *Tcj, float sigmaMillivolts, float sigmaTcj, float *temperatures, float *slopes, float *uncertainties, size_t count)
+{
+	tcSensitivityBatch(this->temperatureTable(), millivolts, Tcj, sigmaMillivolts, sigmaTcj, temperatures, slopes, uncertainties, count);
+}
+
+#if defined(TC_BATCH_AVX2)
+
+// The forward tables only go through the AVX2 kernels.  Elsewhere
+// TypedThermocouple::getVoltages() loops over the inlined templates, which
+// beats both a table-driven scalar loop and the 2 lane kernels.
+void tcGetVoltages(const ThermocoupleSegmentTable *table, const double *temperatures, const double *Tcj, double *millivolts, size_t count)
+{
+	size_t done = tcVoltageBatchVector(table, temperatures, Tcj, millivolts, count);
+	tcVoltageBatchScalar(table, temperatures + done, Tcj ? Tcj + done : NULL, millivolts + done, count - done);
+}
+
+void tcGetVoltages(const ThermocoupleSegmentTable *table, const float *temperatures, const float *Tcj, float *millivolts, size_t count)
+{
+	size_t done = tcVoltageBatchVector(table, temperatures, Tcj, millivolts, count);
+	tcVoltageBatchScalar(table, temperatures + done, Tcj ? Tcj + done : NULL, millivolts + done, count - done);
+}
+
+#endif
@@ -0,0 +1,886 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleCoefficients.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Rational function coefficients for every thermocouple type, from the
+    Mosaic Industries fits.  This is the only copy of the coefficients - the
+    TypeX classes, the Thermocouple<> templates and the batch kernels all
+    read them from here.
+
+    Each type is a struct of arrays:
+      breakpoints    - segments+1 ascending millivolt limits
+      coefficients   - TC_COEFF_COUNT columns of `segments` entries each, so
+                       column c of segment s is coefficients[c * segments + s]
+      upperInclusive - segments are (lo, hi] instead of [lo, hi)
+
+    the cold junction temperature-to-millivolt model:
+      coldJunctionBreakpoints - coldJunctionSegments+1 ascending temperature
+                                limits; segments are [lo, hi), and the end
+                                segments are extrapolated past the limits
+      coldJunction            - TC_CJ_COEFF_COUNT columns, laid out as
+                                coefficients (x = Tcj - T0, mV = V0 + N/D)
+
+    and the temperature-to-millivolt (forward) model:
+      forwardBreakpoints  - forwardSegments+1 ascending temperature limits;
+                            segments are [lo, hi) except the last, which
+                            includes its upper limit
+      forwardCoefficients - the same TC_COEFF_* columns, with the roles of
+                            T0 and V0 swapped (x = t - T0, mV = V0 + N/D)
+
+    and a division-free millivolt-to-temperature model, which types built
+    with TC_TYPE_x_POLYNOMIAL convert with instead of the rational one (see
+    ThermocoupleTemperatureTables below):
+      polynomialBreakpoints - polynomialSegments+1 ascending millivolt
+                              limits, split as upperInclusive says
+      polynomial            - the TC_COEFF_* columns, with a1..a7 in place of
+                              p1..q3 (x = mV - V0, t = T0 + x*(a1 + x*...)),
+                              stored only up to a polynomialDegree
+                              (TC_POLYNOMIAL_COLUMNS(polynomialDegree) columns)
+
+    The forward and cold junction tables are fitted to the NIST ITS-90
+    reference functions by extras/tools/fit_forward.cpp, to within 0.001C,
+    and the polynomial tables by extras/tools/fit_polynomial.cpp, to within
+    0.01C.  Each cold junction segment and polynomial table is commented
+    with its worst case.  The polynomial tables stop at the ends of the
+    reference's range, which the rational ones overrun - by a microvolt for
+    most types, up to 69.553mV for K.
+
+    The arrays are templated on the evaluation type so float code gets
+    float constants without any run-time conversion.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_COEFFICIENTS_H_
+#define _THERMOCOUPLE_COEFFICIENTS_H_
+
+#include <stdint.h>
+
+// Temperature returned for inputs outside a type's range
+#define TC_OUT_OF_RANGE_TEMPERATURE (-1000.0)
+
+// Cold junction temperatures (C) the cold junction tables cover.  Type B's
+// start at 0C instead, the bottom of its reference function.
+#define TC_CJ_MIN_TEMPERATURE -50.0
+#define TC_CJ_MAX_TEMPERATURE 150.0
+
+// Most cold junction segments any type has (K)
+#define TC_MAX_CJ_SEGMENTS 3
+
+// Raw thermocouple voltage (mV, either polarity) taken as a likely open
+// circuit - past anything a thermocouple produces, where an open input's
+// bias pulls the ADC.  Define before including the library to change it.
+#ifndef TC_OPEN_CIRCUIT_MILLIVOLTS
+#define TC_OPEN_CIRCUIT_MILLIVOLTS 100.0
+#endif
+
+// Types the TypeX classes are built for - all of them, unless the library is
+// built with TC_SELECT_TYPES, in which case only those with TC_TYPE_x set
+// (e.g. -DTC_SELECT_TYPES -DTC_TYPE_K).  These have to be build flags, as
+// they change what the library's own sources compile.
+#if defined(TC_SELECT_TYPES)
+#define TC_TYPE_DEFAULT 0
+#else
+#define TC_TYPE_DEFAULT 1
+#endif
+#ifndef TC_TYPE_B
+#define TC_TYPE_B TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_E
+#define TC_TYPE_E TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_J
+#define TC_TYPE_J TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_K
+#define TC_TYPE_K TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_N
+#define TC_TYPE_N TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_R
+#define TC_TYPE_R TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_S
+#define TC_TYPE_S TC_TYPE_DEFAULT
+#endif
+#ifndef TC_TYPE_T
+#define TC_TYPE_T TC_TYPE_DEFAULT
+#endif
+
+// Types converted with the division-free polynomial tables instead of the
+// rational ones - none, unless the library is built with
+// TC_POLYNOMIAL_KERNELS (all of them) or TC_TYPE_x_POLYNOMIAL=1 for a type.
+// Build flags as well, e.g. -DTC_TYPE_K_POLYNOMIAL=1.
+#if defined(TC_POLYNOMIAL_KERNELS)
+#define TC_POLYNOMIAL_DEFAULT 1
+#else
+#define TC_POLYNOMIAL_DEFAULT 0
+#endif
+#ifndef TC_TYPE_B_POLYNOMIAL
+#define TC_TYPE_B_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_E_POLYNOMIAL
+#define TC_TYPE_E_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_J_POLYNOMIAL
+#define TC_TYPE_J_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_K_POLYNOMIAL
+#define TC_TYPE_K_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_N_POLYNOMIAL
+#define TC_TYPE_N_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_R_POLYNOMIAL
+#define TC_TYPE_R_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_S_POLYNOMIAL
+#define TC_TYPE_S_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+#ifndef TC_TYPE_T_POLYNOMIAL
+#define TC_TYPE_T_POLYNOMIAL TC_POLYNOMIAL_DEFAULT
+#endif
+
+// Most millivolt-to-temperature segments any type has - 5 (E, J and K) for
+// the rational tables, 8 (E and K) for the polynomial ones
+#if TC_TYPE_B_POLYNOMIAL || TC_TYPE_E_POLYNOMIAL || TC_TYPE_J_POLYNOMIAL || TC_TYPE_K_POLYNOMIAL || \
+	TC_TYPE_N_POLYNOMIAL || TC_TYPE_R_POLYNOMIAL || TC_TYPE_S_POLYNOMIAL || TC_TYPE_T_POLYNOMIAL
+#define TC_MAX_SEGMENTS 8
+#else
+#define TC_MAX_SEGMENTS 5
+#endif
+
+// Conversion status bits - 0 is a good reading.  Under and over range are
+// both set for a NaN reading, which also counts as an open circuit, and
+// for a channel with no thermocouple assigned (scanner and ring converter).
+enum
+{
+	TC_STATUS_OK = 0,
+	TC_STATUS_UNDER_RANGE = 0x01,          // compensated voltage below the type's range
+	TC_STATUS_OVER_RANGE = 0x02,           // compensated voltage above the type's range
+	TC_STATUS_OPEN_CIRCUIT = 0x04,         // raw voltage at or past TC_OPEN_CIRCUIT_MILLIVOLTS
+	TC_STATUS_COLD_JUNCTION_RANGE = 0x08,  // cold junction outside the type's cold junction tables
+	TC_STATUS_UNUSED = 0x10,               // no thermocouple assigned to the channel
+	TC_STATUS_OUT_OF_RANGE = TC_STATUS_UNDER_RANGE | TC_STATUS_OVER_RANGE
+};
+
+// A temperature with its TC_STATUS_* bits.  temperature is
+// TC_OUT_OF_RANGE_TEMPERATURE when a TC_STATUS_OUT_OF_RANGE bit is set.
+template<typename T> struct ThermocoupleResult
+{
+	T temperature;
+	uint8_t status;
+};
+
+enum class ThermocoupleType : uint8_t
+{
+	B,
+	E,
+	J,
+	K,
+	N,
+	R,
+	S,
+	T
+};
+
+// Column order of the millivolt-to-temperature and temperature-to-millivolt coefficients
+enum
+{
+	TC_COEFF_T0 = 0,
+	TC_COEFF_V0,
+	TC_COEFF_P1,
+	TC_COEFF_P2,
+	TC_COEFF_P3,
+	TC_COEFF_P4,
+	TC_COEFF_Q1,
+	TC_COEFF_Q2,
+	TC_COEFF_Q3,
+	TC_COEFF_COUNT
+};
+
+// The polynomial millivolt-to-temperature tables use the same columns, with
+// a1..a7 in place of p1..q3:  t = T0 + x*(a1 + x*(a2 + ... + x*a7)).  A
+// table of a given degree stores only the columns up to its a_degree.
+#define TC_POLYNOMIAL_A1 TC_COEFF_P1
+#define TC_POLYNOMIAL_MAX_DEGREE (TC_COEFF_COUNT - TC_COEFF_P1)
+#define TC_POLYNOMIAL_COLUMNS(degree) (TC_POLYNOMIAL_A1 + (degree))
+
+// Column order of the cold junction temperature-to-millivolt coefficients
+enum
+{
+	TC_CJ_COEFF_T0 = 0,
+	TC_CJ_COEFF_V0,
+	TC_CJ_COEFF_P1,
+	TC_CJ_COEFF_P2,
+	TC_CJ_COEFF_P3,
+	TC_CJ_COEFF_P4,
+	TC_CJ_COEFF_Q1,
+	TC_CJ_COEFF_Q2,
+	TC_CJ_COEFF_COUNT
+};
+
+template<ThermocoupleType Type, typename T> struct ThermocoupleCoefficients;
+
+// Index packs for expanding tables derived from these at compile time
+template<unsigned... I> struct TCIndexList {};
+template<unsigned N, unsigned... I> struct TCMakeIndexList : TCMakeIndexList<N - 1, N - 1, I...> {};
+template<unsigned... I> struct TCMakeIndexList<0, I...> { typedef TCIndexList<I...> type; };
+
+/*********************************************************************************************************
+Type B Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::B, T>
+{
+	static constexpr uint8_t segments = 2;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[3] = { 0.291, 2.431, 13.820 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 2] =
+	{
+		5.0000000E+02, 1.2461474E+03,	// T0
+		1.2417900E+00, 7.2701221E+00,	// V0
+		1.9858097E+02, 9.4321033E+01,	// p1
+		2.4284248E+01, 7.3899296E+00,	// p2
+		-9.7271640E+01, -1.5880987E-01,	// p3
+		-1.5701178E+01, 1.2681877E-02,	// p4
+		3.1009445E-01, 1.0113834E-01,	// q1
+		-5.0880251E-01, -1.6145962E-03,	// q2
+		-1.6163342E-01, -4.1086314E-06,	// q3
+	};
+	// 0C to 150C: within 0.000012C
+	static constexpr uint8_t coldJunctionSegments = 1;
+	static constexpr T coldJunctionBreakpoints[2] = { 0, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 1] =
+	{
+		7.5000000E+01,	// T0
+		1.4208471E-02,	// V0
+		6.1911029E-04,	// p1
+		3.7346497E-06,	// p2
+		-2.1346830E-08,	// p3
+		-2.2557800E-11,	// p4
+		-3.0965666E-03,	// q1
+		-4.6840971E-06,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 4;
+	static constexpr T forwardBreakpoints[5] = { 0, 630.615, 1100, 1717, 1820 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 4] =
+	{
+		3.1500000E+02, 8.6500000E+02, 1.4090000E+03, 1.7690000E+03,	// T0
+		4.7752631E-01, 3.6670204E+00, 9.0578347E+00, 1.3234249E+01,	// V0
+		3.2025919E-03, 8.1513302E-03, 1.1306224E-02, 1.1555280E-02,	// p1
+		7.8401655E-06, 4.8561759E-05, 2.4967271E-05, -1.1183051E-06,	// p2
+		6.3409945E-09, 9.5681442E-08, -2.0975749E-10, -2.8560472E-09,	// p3
+		4.2773338E-12, 4.9037570E-11, 3.3138952E-12, -1.6111339E-13,	// p4
+		8.4079792E-04, 5.4892621E-03, 2.0582655E-03, 0.0000000E+00,	// q1
+		8.2843023E-07, 9.3024470E-06, -1.3731106E-07, 0.0000000E+00,	// q2
+		2.2441867E-10, 2.4023300E-09, 7.9597126E-10, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00999C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 4;
+	static constexpr T polynomialBreakpoints[5] = { 0.291, 1.011, 1.978, 6.509, 13.820 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 4] =
+	{
+		3.6514125E+02, 5.4811635E+02, 9.3361186E+02, 1.5057019E+03,	// T0
+		6.5100000E-01, 1.4950000E+00, 4.2440000E+00, 1.0165000E+01,	// V0
+		2.6932748E+02, 1.8231362E+02, 1.1547828E+02, 8.6428222E+01,	// a1
+		-9.7368007E+01, -2.7908358E+01, -5.4948833E+00, -6.5848624E-01,	// a2
+		7.2394893E+01, 9.5284211E+00, 7.1673918E-01, 1.4839891E-01,	// a3
+		-9.4449176E+01, -4.3542398E+00, -1.3474174E-01, -2.0235768E-03,	// a4
+		1.1597728E+02, 2.1171366E+00, 2.1192110E-02, 4.4398179E-04,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::breakpoints[3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::coefficients[TC_COEFF_COUNT * 2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::coldJunctionBreakpoints[2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::coldJunction[TC_CJ_COEFF_COUNT * 1];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::forwardBreakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::forwardCoefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::polynomialBreakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::B, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 4];
+
+/*********************************************************************************************************
+Type E Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::E, T>
+{
+	static constexpr uint8_t segments = 5;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[6] = { -9.835, -5.237, 0.591, 24.964, 53.112, 76.373 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 5] =
+	{
+		-1.1721668E+02, -5.0000000E+01, 2.5014600E+02, 6.0139890E+02, 8.0435911E+02,	// T0
+		-5.9901698E+00, -2.7871777E+00, 1.7191713E+01, 4.5206167E+01, 6.1359178E+01,	// V0
+		2.3647275E+01, 1.9022736E+01, 1.3115522E+01, 1.2399357E+01, 1.2759508E+01,	// p1
+		1.2807377E+01, -1.7042725E+00, 1.1780364E+00, 4.3399963E-01, -1.1116072E+00,	// p2
+		2.0665069E+00, -3.5195189E-01, 3.6422433E-02, 9.1967085E-03, 3.5332536E-02,	// p3
+		8.6513472E-02, 4.7766102E-03, 3.9584261E-04, 1.6901585E-04, 3.3080380E-05,	// p4
+		5.8995860E-01, -6.5379760E-02, 9.3112756E-02, 3.4424680E-02, -8.8196889E-02,	// q1
+		1.0960713E-01, -2.1732833E-02, 2.9804232E-03, 6.9741215E-04, 2.8497415E-03,	// q2
+		6.1769588E-03, 0.0, 3.3263032E-05, 1.2946992E-05, 0.0,	// q3
+	};
+	// -50C to 0C: within 0.000156C
+	// 0C to 150C: within 0.000003C
+	static constexpr uint8_t coldJunctionSegments = 2;
+	static constexpr T coldJunctionBreakpoints[3] = { -50, 0, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 2] =
+	{
+		-2.5000000E+01, 7.5000000E+01,	// T0
+		-1.4320961E+00, 4.6564502E+00,	// V0
+		5.5788185E-02, 6.5449143E-02,	// p1
+		-4.8709501E-04, 2.0630785E-04,	// p2
+		-2.1151274E-05, 3.8355144E-07,	// p3
+		-2.2499452E-08, -2.4924237E-12,	// p4
+		-9.8415283E-03, 2.4955012E-03,	// q1
+		-3.6729689E-04, 4.7783415E-06,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 6;
+	static constexpr T forwardBreakpoints[7] = { -270, -208, -58, 0, 344, 744, 1000 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 6] =
+	{
+		-2.3900000E+02, -1.3300000E+02, -2.9000000E+01, 1.7200000E+02, 5.4400000E+02, 8.7200000E+02,	// T0
+		-9.5905636E+00, -6.6356126E+00, -1.6542544E+00, 1.1369279E+01, 4.0567251E+01, 6.6627742E+01,	// V0
+		1.3547452E-02, 3.9465040E-02, 5.5290357E-02, 7.2506069E-02, 8.0938574E-02, 7.7357838E-02,	// p1
+		6.5863057E-04, 1.4597783E-04, -1.7065518E-03, 1.4840155E-04, 3.0209106E-04, -5.6743824E-04,	// p2
+		1.3170407E-05, -2.0635937E-07, 1.4580703E-05, 9.4205163E-08, 4.3321878E-07, 2.0076308E-06,	// p3
+		9.8663392E-08, -4.3027512E-10, 5.2100793E-08, -2.9287457E-10, 8.9940026E-10, -1.3623337E-10,	// p4
+		3.5949852E-02, 1.3677917E-03, -3.1995905E-02, 1.6437148E-03, 3.7463110E-03, -7.2226714E-03,	// q1
+		5.4182871E-04, -5.3815664E-06, 3.0083919E-04, 1.3109372E-06, 5.6236308E-06, 2.5321459E-05,	// q2
+		1.5128396E-06, 0.0000000E+00, 5.6586755E-07, -3.8117877E-09, 1.1794170E-08, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00997C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 8;
+	static constexpr T polynomialBreakpoints[9] = { -9.834, -9.797, -9.534, -8.243, -2.944, 0.000, 36.601, 74.567, 76.372 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 8] =
+	{
+		-2.6353431E+02, -2.4504295E+02, -2.0256528E+02, -1.0802425E+02, -2.5715727E+01, 2.6463445E+02, 7.3110315E+02, 9.8799078E+02,	// T0
+		-9.8150000E+00, -9.6660000E+00, -8.8880000E+00, -5.5940000E+00, -1.4720000E+00, 1.8301000E+01, 5.5584000E+01, 7.5470000E+01,	// V0
+		2.2453591E+02, 8.7672741E+01, 4.0911090E+01, 2.2815603E+01, 1.7953747E+01, 1.3023367E+01, 1.2610022E+01, 1.3295226E+01,	// a1
+		-2.0132304E+03, -1.1087533E+02, -8.4730111E+00, -9.7332833E-01, -3.5981558E-01, -3.8399428E-02, 1.1971682E-02, 1.0032288E-02,	// a2
+		1.1395316E+04, 2.4754781E+02, 3.9684248E+00, 1.0491316E-01, 1.8896234E-02, 1.2143642E-03, 1.0975180E-04, -2.7758033E-03,	// a3
+		-3.0047879E+06, -2.1276054E+03, -5.0362304E+00, -2.3058813E-02, -3.0350446E-04, -3.7941150E-05, 7.0782930E-07, -2.8370029E-04,	// a4
+		1.7582600E+08, 1.1608913E+04, 4.7717122E+00, 4.5862000E-03, 1.2270985E-03, 8.3977330E-07, 1.4977866E-07, -1.2942317E-05,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::breakpoints[6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::coefficients[TC_COEFF_COUNT * 5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::coldJunctionBreakpoints[3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::coldJunction[TC_CJ_COEFF_COUNT * 2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::forwardBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::forwardCoefficients[TC_COEFF_COUNT * 6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::polynomialBreakpoints[9];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::E, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 8];
+
+/*********************************************************************************************************
+Type J Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::J, T>
+{
+	static constexpr uint8_t segments = 5;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[6] = { -8.095, 0, 21.840, 45.494, 57.953, 69.553 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 5] =
+	{
+		-6.4936529E+01, 2.5066947E+02, 6.4950262E+02, 9.2510550E+02, 1.0511294E+03,	// T0
+		-3.1169773E+00, 1.3592329E+01, 3.6040848E+01, 5.3433832E+01, 6.0956091E+01,	// V0
+		2.2133797E+01, 1.8014787E+01, 1.6593395E+01, 1.6243326E+01, 1.7156001E+01,	// p1
+		2.0476437E+00, -6.5218881E-02, 7.3009590E-01, 9.2793267E-01, -2.5931041E+00,	// p2
+		-4.6867532E-01, -1.2179108E-02, 2.4157343E-02, 6.4644193E-03, -5.8339803E-02,	// p3
+		-3.6673992E-02, 2.0061707E-04, 1.2787077E-03, 2.0464414E-03, 1.9954137E-02,	// p4
+		1.1746348E-01, -3.9494552E-03, 4.9172861E-02, 5.2541788E-02, -1.5305581E-01,	// q1
+		-2.0903413E-02, -7.3728206E-04, 1.6813810E-03, 1.3682959E-04, -2.9523967E-03,	// q2
+		-2.1823704E-03, 1.6679731E-05, 7.6067922E-05, 1.3454746E-04, 1.1340164E-03,	// q3
+	};
+	// -50C to 150C: within 0.000003C
+	static constexpr uint8_t coldJunctionSegments = 1;
+	static constexpr T coldJunctionBreakpoints[2] = { -50, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 1] =
+	{
+		5.0000000E+01,	// T0
+		2.5853155E+00,	// V0
+		5.2847363E-02,	// p1
+		3.8164506E-05,	// p2
+		-1.2181171E-07,	// p3
+		5.0519782E-11,	// p4
+		3.5481500E-04,	// q1
+		-1.2432324E-06,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 5;
+	static constexpr T forwardBreakpoints[6] = { -210, 214, 628, 760, 1076, 1200 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 5] =
+	{
+		2.0000000E+00, 4.2100000E+02, 6.9400000E+02, 9.1800000E+02, 1.1380000E+03,	// T0
+		1.0088360E-01, 2.3006769E+01, 3.8759571E+01, 5.2995542E+01, 6.5987036E+01,	// V0
+		5.0502694E-02, 5.5208042E-02, 6.1933327E-02, 6.1808573E-02, 5.7686978E-02,	// p1
+		1.1135495E-04, 1.8890999E-06, -2.0714039E-04, 1.1770052E-04, -1.0480737E-04,	// p2
+		-6.4444285E-09, 1.7177055E-07, 3.6273643E-07, 2.1878017E-07, -1.3720873E-10,	// p3
+		1.2732273E-11, 4.3127525E-11, -6.0854722E-10, 9.4492268E-11, -1.6552112E-10,	// p4
+		1.6118023E-03, -2.1635744E-06, -3.6395848E-03, 2.1873859E-03, -1.7860966E-03,	// q1
+		5.9489257E-07, 2.7220745E-06, 7.1965044E-06, 4.1232073E-06, 0.0000000E+00,	// q2
+		0.0000000E+00, 0.0000000E+00, -1.0331693E-08, 0.0000000E+00, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00997C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 6;
+	static constexpr T polynomialBreakpoints[7] = { -8.095, -5.946, 2.216, 32.577, 42.919, 66.448, 69.553 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6] =
+	{
+		-1.6651733E+02, -3.7998456E+01, 3.1934348E+02, 6.7758632E+02, 9.4552160E+02, 1.1729393E+03,	// T0
+		-7.0200000E+00, -1.8650000E+00, 1.7397000E+01, 3.7748000E+01, 5.4683000E+01, 6.8000000E+01,	// V0
+		3.3554817E+01, 2.0987296E+01, 1.8092844E+01, 1.6307118E+01, 1.6432528E+01, 1.7385514E+01,	// a1
+		-3.8719923E+00, -3.7424271E-01, 1.0221340E-02, -8.1687834E-02, 7.2771793E-02, 1.8521979E-02,	// a2
+		1.1141567E+00, 3.2520345E-02, -4.5230104E-04, 1.2905821E-03, -7.0310524E-04, 2.9095840E-03,	// a3
+		-7.2581480E-01, -4.5319276E-03, -8.8587839E-05, 1.3720443E-04, -1.3638099E-04, 3.7919356E-04,	// a4
+		3.8566035E-01, 5.5833296E-04, 1.1446598E-06, 7.8285944E-07, 3.6276897E-06, 1.2511442E-05,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::breakpoints[6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::coefficients[TC_COEFF_COUNT * 5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::coldJunctionBreakpoints[2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::coldJunction[TC_CJ_COEFF_COUNT * 1];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::forwardBreakpoints[6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::forwardCoefficients[TC_COEFF_COUNT * 5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::polynomialBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::J, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6];
+
+/*********************************************************************************************************
+Type K Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::K, T>
+{
+	static constexpr uint8_t segments = 5;
+	static constexpr bool upperInclusive = true;
+	static constexpr T breakpoints[6] = { -6.404, -3.554, 4.096, 16.397, 33.275, 69.553 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 5] =
+	{
+		-1.2147164E+02, -8.7935962E+00, 3.1018976E+02, 6.0572562E+02, 1.0184705E+03,	// T0
+		-4.1790858E+00, -3.4489914E-01, 1.2631386E+01, 2.5148718E+01, 4.1993851E+01,	// V0
+		3.6069513E+01, 2.5678719E+01, 2.4061949E+01, 2.3539401E+01, 2.5783239E+01,	// p1
+		3.0722076E+01, -4.9887904E-01, 4.0158622E+00, 4.6547228E-02, -1.8363403E+00,	// p2
+		7.7913860E+00, -4.4705222E-01, 2.6853917E-01, 1.3444400E-02, 5.6176662E-02,	// p3
+		5.2593991E-01, -4.4869203E-02, -9.7188544E-03, 5.9236853E-04, 1.8532400E-04,	// p4
+		9.3939547E-01, 2.3893439E-04, 1.6995872E-01, 8.3445513E-04, -7.4803355E-02,	// q1
+		2.7791285E-01, -2.0397750E-02, 1.1413069E-02, 4.6121445E-04, 2.3841860E-03,	// q2
+		2.5163349E-02, -1.8424107E-03, -3.9275155E-04, 2.5488122E-05, 0.0000000E+00,	// q3
+	};
+	// -50C to 0C: within 0.000050C
+	// 0C to 118C: within 0.000849C
+	// 118C to 150C: within 0.000002C
+	static constexpr uint8_t coldJunctionSegments = 3;
+	static constexpr T coldJunctionBreakpoints[4] = { -50, 0, 118, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 3] =
+	{
+		-2.5000000E+01, 5.9000000E+01, 1.3400000E+02,	// T0
+		-9.6776786E-01, 2.3950576E+00, 5.4911258E+00,	// V0
+		3.7861766E-02, 4.1406189E-02, 4.0634686E-02,	// p1
+		-1.7917832E-04, -3.7965224E-04, 6.2748997E-05,	// p2
+		-3.9341807E-06, 8.6890358E-07, -4.7373666E-09,	// p3
+		-3.4660935E-09, 1.1391974E-09, 8.9023950E-10,	// p4
+		-5.7179217E-03, -9.3456676E-03, 1.8385999E-03,	// q1
+		-9.5386743E-05, 2.5608763E-05, 0.0000000E+00,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 7;
+	static constexpr T forwardBreakpoints[8] = { -270, -171, -15, 0, 225, 427, 1077, 1372 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 7] =
+	{
+		-2.2000000E+02, -9.3000000E+01, -7.0000000E+00, 1.1300000E+02, 3.2600000E+02, 7.5200000E+02, 1.2250000E+03,	// T0
+		-6.1584240E+00, -3.3372123E+00, -2.7489161E-01, 4.6325355E+00, 1.3289715E+01, 3.1296379E+01, 4.9745871E+01,	// V0
+		1.1378798E-02, 3.1335121E-02, 3.9077204E-02, 4.1127689E-02, 4.1708055E-02, 4.1452917E-02, 3.6114718E-02,	// p1
+		2.6609511E-04, 5.6043408E-05, -5.7096439E-04, 1.2387895E-05, 6.6412789E-04, -1.7285867E-06, -2.7808246E-05,	// p2
+		2.1094269E-06, 3.8323260E-07, -6.6781429E-07, 1.5513329E-06, 5.0682950E-06, 4.6352111E-08, 1.4692133E-09,	// p3
+		4.8586890E-09, 1.6146164E-09, 3.5291892E-10, 3.8669865E-09, 8.0338041E-09, -1.0285549E-10, 1.5670504E-10,	// p4
+		1.4419332E-02, -9.3160107E-05, -1.5360155E-02, 5.6124180E-04, 1.5815985E-02, 6.8054047E-05, -5.5660522E-04,	// q1
+		7.1489895E-05, 1.5803570E-05, 0.0000000E+00, 3.9286667E-05, 1.2009757E-04, 1.1941866E-06, 6.4186326E-09,	// q2
+		0.0000000E+00, 2.3332193E-08, 0.0000000E+00, 8.4595912E-08, 1.8259745E-07, -2.5533196E-09, 3.9923224E-09,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00995C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 8;
+	static constexpr T polynomialBreakpoints[9] = { -6.404, -6.135, -4.913, -0.157, 0.000, 8.539, 26.433, 52.200, 54.886 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 8] =
+	{
+		-2.3078582E+02, -1.7861528E+02, -6.8487832E+01, -1.9795891E+00, 1.0420990E+02, 4.2572368E+02, 9.5008275E+02, 1.3326633E+03,	// T0
+		-6.2690000E+00, -5.5240000E+00, -2.5350000E+00, -7.8000000E-02, 4.2700000E+00, 1.7486000E+01, 3.9317000E+01, 5.3543000E+01,	// V0
+		1.0990905E+02, 5.2587392E+01, 2.9397956E+01, 2.5411095E+01, 2.4224910E+01, 2.3595482E+01, 2.5313709E+01, 2.9044065E+01,	// a1
+		-1.3491780E+02, -1.1890103E+01, -1.2681493E+00, -4.1778719E-01, 1.1838045E-01, -2.9967590E-02, 8.3326020E-02, 1.8198777E-01,	// a2
+		3.1151582E+02, 5.7497163E+00, 1.8114223E-01, 1.3533591E-01, 2.5834653E-02, 2.0013267E-03, 9.8976473E-04, -2.3106059E-03,	// a3
+		-2.2034165E+03, -6.6831713E+00, -4.1658186E-02, 3.5615100E-02, -4.0920849E-03, -4.8748902E-05, 4.0166386E-05, -8.1603320E-04,	// a4
+		1.0948895E+04, 6.3462130E+00, 8.7726219E-03, 1.4318577E-02, -3.0584907E-04, 8.0445137E-06, 2.1041054E-06, -5.4890681E-05,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::breakpoints[6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::coefficients[TC_COEFF_COUNT * 5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::coldJunctionBreakpoints[4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::coldJunction[TC_CJ_COEFF_COUNT * 3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::forwardBreakpoints[8];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::forwardCoefficients[TC_COEFF_COUNT * 7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::polynomialBreakpoints[9];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::K, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 8];
+
+/*********************************************************************************************************
+Type N Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::N, T>
+{
+	static constexpr uint8_t segments = 3;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[4] = { -4.313, 0.0, 20.613, 47.513 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 3] =
+	{
+		-5.9610511E+01, 3.1534505E+02, 1.0340172E+03,	// T0
+		-1.5000000E+00, 9.8870997E+00, 3.7565475E+01,	// V0
+		4.2021322E+01, 2.7988676E+01, 2.6029492E+01,	// p1
+		4.7244037E+00, 1.5417343E+00, -6.0783095E-01,	// p2
+		-6.1153213E+00, -1.4689457E-01, -9.7742562E-03,	// p3
+		-9.9980337E-01, -6.8322712E-03, -3.3148813E-06,	// p4
+		1.6385664E-01, 6.2600036E-02, -2.5351881E-02,	// q1
+		-1.4994026E-01, -5.1489572E-03, -3.8746827E-04,	// q2
+		-3.0810372E-02, -2.8835863E-04, 1.7088177E-06,	// q3
+	};
+	// -50C to 0C: within 0.000026C
+	// 0C to 150C: within 0.000005C
+	static constexpr uint8_t coldJunctionSegments = 2;
+	static constexpr T coldJunctionBreakpoints[3] = { -50, 0, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 2] =
+	{
+		-2.5000000E+01, 7.5000000E+01,	// T0
+		-6.4566048E-01, 2.0449300E+00,	// V0
+		2.5434250E-02, 2.8687784E-02,	// p1
+		1.8118071E-05, 1.1625956E-04,	// p2
+		-9.9648036E-08, 2.0236433E-07,	// p3
+		9.6250379E-11, 7.3578297E-13,	// p4
+		0.0000000E+00, 3.3788629E-03,	// q1
+		0.0000000E+00, 4.8908687E-06,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 6;
+	static constexpr T forwardBreakpoints[7] = { -270, -147, 0, 368, 818, 1203, 1300 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 6] =
+	{
+		-2.0800000E+02, -7.3000000E+01, 1.8400000E+02, 5.9300000E+02, 1.0110000E+03, 1.2520000E+03,	// T0
+		-4.0655101E+00, -1.8132447E+00, 5.3893085E+00, 2.0340516E+01, 3.6679927E+01, 4.5767282E+01,	// V0
+		8.8485220E-03, 2.2967159E-02, 3.2518158E-02, 3.8924205E-02, 3.8550099E-02, 3.6672955E-02,	// p1
+		2.1069602E-04, 1.0992200E-04, 1.9547573E-04, -8.6487408E-06, 7.6399140E-05, -1.3343630E-04,	// p2
+		1.7572582E-06, 3.5118054E-07, 4.3743206E-07, -6.2712764E-09, 4.5230805E-08, 7.2458617E-09,	// p3
+		5.1073999E-09, 8.2002426E-10, 3.4278721E-10, 5.5263728E-12, -9.1468395E-12, -1.5383704E-11,	// p4
+		1.6079690E-02, 3.3263998E-03, 5.5451836E-03, -2.8683852E-04, 2.0540455E-03, -3.4840462E-03,	// q1
+		8.1458157E-05, 1.5174747E-05, 1.1365809E-05, 2.5944429E-08, 1.4069376E-06, 0.0000000E+00,	// q2
+		9.5810241E-08, 3.1308104E-08, 7.9512699E-09, 0.0000000E+00, 0.0000000E+00, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00998C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 7;
+	static constexpr T polynomialBreakpoints[8] = { -4.313, -4.154, -3.431, -0.646, 0.000, 9.875, 42.877, 47.512 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 7] =
+	{
+		-2.3115532E+02, -1.8213710E+02, -8.2943110E+01, -1.2418976E+01, 1.7003655E+02, 7.4707720E+02, 1.2364313E+03,	// T0
+		-4.2330000E+00, -3.7920000E+00, -2.0380000E+00, -3.2300000E-01, 4.9380000E+00, 2.6376000E+01, 4.5195000E+01,	// V0
+		1.7900981E+02, 8.1743498E+01, 4.4926086E+01, 3.8694291E+01, 3.1159058E+01, 2.5450368E+01, 2.7143596E+01,	// a1
+		-3.8807336E+02, -3.3113897E+01, -3.2517915E+00, -8.3736644E-01, -4.8465794E-01, -4.1250712E-04, 1.0309660E-01,	// a2
+		1.4988615E+03, 2.8187188E+01, 8.6210747E-01, 2.4872357E-01, 3.1984783E-02, 1.8021198E-03, 5.7849495E-03,	// a3
+		-1.7244264E+04, -5.6014548E+01, -3.2889827E-01, -3.0926105E-02, -1.1956955E-03, -3.2981938E-05, 8.2636985E-04,	// a4
+		1.4419615E+05, 8.9603922E+01, 1.1727612E-01, 1.0543841E-02, -6.7048607E-05, 1.1842923E-06, 9.4158710E-05,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::breakpoints[4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::coefficients[TC_COEFF_COUNT * 3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::coldJunctionBreakpoints[3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::coldJunction[TC_CJ_COEFF_COUNT * 2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::forwardBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::forwardCoefficients[TC_COEFF_COUNT * 6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::polynomialBreakpoints[8];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::N, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 7];
+
+/*********************************************************************************************************
+Type R Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::R, T>
+{
+	static constexpr uint8_t segments = 4;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[5] = { -0.226, 1.469, 7.461, 14.277, 21.101 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 4] =
+	{
+		1.3054315E+02, 5.4188181E+02, 1.0382132E+03, 1.5676133E+03,	// T0
+		8.8333090E-01, 4.9312886E+00, 1.1014763E+01, 1.8397910E+01,	// V0
+		1.2557377E+02, 9.0208190E+01, 7.4669343E+01, 7.1646299E+01,	// p1
+		1.3900275E+02, 6.1762254E+00, 3.4090711E+00, -1.0866763E+00,	// p2
+		3.3035469E+01, -1.2279323E+00, -1.4511205E-01, -2.0968371E+00,	// p3
+		-8.5195924E-01, 1.4873153E-02, 6.3077387E-03, -7.6741168E-01,	// p4
+		1.2232896E+00, 8.7670455E-02, 5.6880253E-02, -1.9712341E-02,	// q1
+		3.5603023E-01, -1.2906694E-02, -2.0512736E-03, -2.9903595E-02,	// q2
+		0.0, 0.0, 0.0, -1.0766878E-02,	// q3
+	};
+	// -50C to 150C: within 0.000004C
+	static constexpr uint8_t coldJunctionSegments = 1;
+	static constexpr T coldJunctionBreakpoints[2] = { -50, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 1] =
+	{
+		5.0000000E+01,	// T0
+		2.9649619E-01,	// V0
+		6.5186327E-03,	// p1
+		2.5304668E-05,	// p2
+		1.5243300E-08,	// p3
+		1.2409936E-12,	// p4
+		2.2226772E-03,	// q1
+		1.3790420E-06,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 4;
+	static constexpr T forwardBreakpoints[5] = { -50, 703, 1064.18, 1664.5, 1768.1 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 4] =
+	{
+		3.2700000E+02, 8.8400000E+02, 1.3640000E+03, 1.7160000E+03,	// T0
+		2.6660981E+00, 9.0008935E+00, 1.5531499E+01, 2.0435525E+01,	// V0
+		9.9287290E-03, 1.2710985E-02, 1.4124241E-02, 1.3261965E-02,	// p1
+		9.4769404E-06, 9.6578750E-06, -3.1046038E-08, -6.9510206E-06,	// p2
+		2.6569801E-09, 1.1874789E-08, -4.0451936E-09, -3.4654234E-08,	// p3
+		1.3816779E-11, 1.0617446E-12, 5.3203727E-14, -3.5675905E-13,	// p4
+		6.1448068E-04, 5.7639438E-04, -1.3781240E-05, 0.0000000E+00,	// q1
+		4.1364065E-07, 8.6224795E-07, -1.5189619E-07, 0.0000000E+00,	// q2
+		8.5865361E-10, 0.0000000E+00, 0.0000000E+00, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00993C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 6;
+	static constexpr T polynomialBreakpoints[7] = { -0.226, 0.323, 2.265, 8.135, 11.364, 19.739, 21.101 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6] =
+	{
+		9.0429450E+00, 1.7999668E+02, 5.6598794E+02, 9.4231728E+02, 1.3654513E+03, 1.7148301E+03,	// T0
+		4.9000000E-02, 1.2940000E+00, 5.2000000E+00, 9.7500000E+00, 1.5552000E+01, 2.0420000E+01,	// V0
+		1.8075132E+02, 1.1608362E+02, 8.9313140E+01, 7.7053420E+01, 7.0798413E+01, 7.5312215E+01,	// a1
+		-7.6454611E+01, -9.0869529E+00, -1.6504187E+00, -1.0263655E+00, -5.4887526E-02, 2.9145579E+00,	// a2
+		8.3589751E+01, 2.8439832E+00, 6.2083549E-02, 4.7287418E-02, 4.7566152E-02, 1.3385551E+00,	// a3
+		-1.9108243E+02, -1.5716648E+00, -1.6989970E-02, -9.1344784E-04, -3.1210238E-04, 2.5535496E-01,	// a4
+		3.7377949E+02, 7.6723800E-01, 3.6332364E-03, -1.4193589E-04, 1.5179009E-04, 9.5297671E-02,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::breakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::coefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::coldJunctionBreakpoints[2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::coldJunction[TC_CJ_COEFF_COUNT * 1];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::forwardBreakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::forwardCoefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::polynomialBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::R, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6];
+
+/*********************************************************************************************************
+Type S Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::S, T>
+{
+	static constexpr uint8_t segments = 4;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[5] = { -0.236, 1.441, 6.913, 12.856, 18.693 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 4] =
+	{
+		1.3792630E+02, 4.7673468E+02, 9.7946589E+02, 1.6010461E+03,	// T0
+		9.3395024E-01, 4.0037367E+00, 9.3508283E+00, 1.6789315E+01,	// V0
+		1.2761836E+02, 1.0174512E+02, 8.7126730E+01, 8.4315871E+01,	// p1
+		1.1089050E+02, -8.9306371E+00, -2.3139202E+00, -1.0185043E+01,	// p2
+		1.9898457E+01, -4.2942435E+00, -3.2682118E-02, -4.6283954E+00,	// p3
+		9.6152996E-02, 2.0453847E-01, 4.6090022E-03, -1.0158749E+00,	// p4
+		9.6545918E-01, -7.1227776E-02, -1.4299790E-02, -1.2877783E-01,	// q1
+		2.0813850E-01, -4.4618306E-02, -1.2289882E-03, -5.5802216E-02,	// q2
+		0.0, 1.6822887E-03, 0.0, -1.2146518E-02,	// q3
+	};
+	// -50C to 150C: within 0.000002C
+	static constexpr uint8_t coldJunctionSegments = 1;
+	static constexpr T coldJunctionBreakpoints[2] = { -50, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 1] =
+	{
+		5.0000000E+01,	// T0
+		2.9892555E-01,	// V0
+		6.5032297E-03,	// p1
+		2.0765931E-05,	// p2
+		5.0771372E-09,	// p3
+		3.5886908E-12,	// p4
+		1.7246422E-03,	// q1
+		9.5047111E-07,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 4;
+	static constexpr T forwardBreakpoints[5] = { -50, 685, 1064.18, 1664.5, 1768.1 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 4] =
+	{
+		3.1800000E+02, 8.7500000E+02, 1.3640000E+03, 1.7160000E+03,	// T0
+		2.4882423E+00, 8.1699520E+00, 1.3935746E+01, 1.8129114E+01,	// V0
+		9.2227597E-03, 1.1129053E-02, 1.2138697E-02, 1.1266389E-02,	// p1
+		1.3436395E-05, -2.5119365E-05, -5.2710056E-08, -6.5831368E-06,	// p2
+		4.0073797E-09, 4.2765676E-08, -1.5776399E-09, -3.3108622E-08,	// p3
+		5.0365020E-12, -1.2292798E-11, 1.2437678E-14, 6.0147474E-15,	// p4
+		1.1921553E-03, -2.4108101E-03, 0.0000000E+00, 0.0000000E+00,	// q1
+		4.7990110E-07, 4.2390513E-06, 0.0000000E+00, 0.0000000E+00,	// q2
+		1.7783456E-10, -1.7286518E-09, 0.0000000E+00, 0.0000000E+00,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.01000C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 6;
+	static constexpr T polynomialBreakpoints[7] = { -0.235, 0.412, 2.655, 8.923, 10.334, 17.536, 18.693 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6] =
+	{
+		1.5891197E+01, 2.1083365E+02, 6.5346524E+02, 1.0035429E+03, 1.3639385E+03, 1.7147483E+03,	// T0
+		8.9000000E-02, 1.5330000E+00, 5.7890000E+00, 9.6280000E+00, 1.3935000E+01, 1.8115000E+01,	// V0
+		1.7290895E+02, 1.1698808E+02, 9.6381960E+01, 8.6576318E+01, 8.2381323E+01, 8.8631456E+01,	// a1
+		-5.8150431E+01, -6.3221627E+00, -1.4199830E+00, -1.0230735E+00, 2.9309492E-02, 4.4905686E+00,	// a2
+		5.4816853E+01, 1.8736858E+00, 6.0997388E-03, 3.0427507E-02, 7.2566526E-02, 2.4935759E+00,	// a3
+		-1.0384550E+02, -9.1551812E-01, -5.3626453E-03, -1.3556890E-02, 8.6094879E-05, 6.2507862E-01,	// a4
+		1.6952237E+02, 3.8022563E-01, 2.4638661E-03, -3.2736571E-03, 2.0953144E-04, 2.8860057E-01,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::breakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::coefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::coldJunctionBreakpoints[2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::coldJunction[TC_CJ_COEFF_COUNT * 1];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::forwardBreakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::forwardCoefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::polynomialBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::S, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 6];
+
+/*********************************************************************************************************
+Type T Thermocouple Coefficients
+*********************************************************************************************************/
+
+template<typename T> struct ThermocoupleCoefficients<ThermocoupleType::T, T>
+{
+	static constexpr uint8_t segments = 4;
+	static constexpr bool upperInclusive = false;
+	static constexpr T breakpoints[5] = { -6.18, -4.648, 0.0, 9.288, 20.872 };
+	static constexpr T coefficients[TC_COEFF_COUNT * 4] =
+	{
+		-1.9243000E+02, -6.0000000E+01, 1.3500000E+02, 3.0000000E+02,	// T0
+		-5.4798963E+00, -2.1528350E+00, 5.9588600E+00, 1.4861780E+01,	// V0
+		5.9572141E+01, 3.0449332E+01, 2.0325591E+01, 1.7214707E+01,	// p1
+		1.9675733E+00, -1.2946560E+00, 3.3013079E+00, -9.3862713E-01,	// p2
+		-7.8176011E+01, -3.0500735E+00, 1.2638462E-01, -7.3509066E-02,	// p3
+		-1.0963280E+01, -1.9226856E-01, -8.2883695E-04, 2.9576140E-04,	// p4
+		2.7498092E-01, 6.9877863E-03, 1.7595577E-01, -4.8095795E-02,	// q1
+		-1.3768944E+00, -1.0596207E-01, 7.9740521E-03, -4.7352054E-03,	// q2
+		-4.5209805E-01, -1.0774995E-02, 0.0, 0.0,	// q3
+	};
+	// -50C to 0C: within 0.000518C
+	// 0C to 150C: within 0.000097C
+	static constexpr uint8_t coldJunctionSegments = 2;
+	static constexpr T coldJunctionBreakpoints[3] = { -50, 0, 150 };
+	static constexpr T coldJunction[TC_CJ_COEFF_COUNT * 2] =
+	{
+		-2.5000000E+01, 7.5000000E+01,	// T0
+		-9.4008828E-01, 3.1323142E+00,	// V0
+		3.6406736E-02, 4.4883268E-02,	// p1
+		4.9312279E-05, 4.0270742E-04,	// p2
+		-4.0550606E-08, 1.6756692E-06,	// p3
+		-6.3132904E-10, 8.2882358E-10,	// p4
+		0.0000000E+00, 8.0873816E-03,	// q1
+		0.0000000E+00, 3.1177133E-05,	// q2
+	};
+	static constexpr uint8_t forwardSegments = 6;
+	static constexpr T forwardBreakpoints[7] = { -270, -220, -144, -50, 0, 212, 400 };
+	static constexpr T forwardCoefficients[TC_COEFF_COUNT * 6] =
+	{
+		-2.4500000E+02, -1.8200000E+02, -9.7000000E+01, -2.5000000E+01, 1.0600000E+02, 3.0600000E+02,	// T0
+		-6.1456852E+00, -5.2974036E+00, -3.2928785E+00, -9.4008828E-01, 4.5605291E+00, 1.5211224E+01,	// V0
+		7.5527105E-03, 1.8191575E-02, 2.8740686E-02, 3.6403723E-02, 4.7215936E-02, 5.8345089E-02,	// p1
+		4.3100666E-04, 6.9067948E-04, 6.3809557E-04, -1.3127621E-03, 5.7973472E-04, -8.2025506E-04,	// p2
+		1.0619570E-05, 9.1828813E-06, 1.2044595E-05, 4.6041348E-05, 3.0039627E-06, 3.9897298E-06,	// p3
+		1.0635076E-07, 2.9012762E-08, 2.7404982E-08, 1.1092356E-07, 3.0282290E-09, 7.1026329E-09,	// p4
+		4.1235314E-02, 3.4302339E-02, 2.0202017E-02, -3.7416000E-02, 1.1523660E-02, -1.4422452E-02,	// q1
+		7.8400654E-04, 3.8157876E-04, 3.8019865E-04, 1.3158004E-03, 5.5739510E-05, 7.3853508E-05,	// q2
+		4.3000045E-06, 2.7659689E-07, 2.1858039E-07, 1.2599522E-06, 2.9376273E-08, 9.0299391E-08,	// q3
+	};
+	// Polynomial kernel: degree 5, within 0.00996C
+	static constexpr uint8_t polynomialDegree = 5;
+	static constexpr uint8_t polynomialSegments = 5;
+	static constexpr T polynomialBreakpoints[6] = { -6.180, -5.782, -3.791, 0.000, 10.634, 20.871 };
+	static constexpr T polynomial[TC_POLYNOMIAL_COLUMNS(5) * 5] =
+	{
+		-2.2769432E+02, -1.5627965E+02, -5.2249262E+01, 1.2184031E+02, 3.1525603E+02,	// T0
+		-5.9810000E+00, -4.7860000E+00, -1.8950000E+00, 5.3170000E+00, 1.5753000E+01,	// V0
+		8.8415929E+01, 4.6475512E+01, 2.9714966E+01, 2.0687111E+01, 1.7026077E+01,	// a1
+		-6.2615878E+01, -6.2115234E+00, -1.3655800E+00, -3.0364789E-01, -1.0419209E-01,	// a2
+		1.0792210E+02, 1.7011949E+00, 1.5627532E-01, 1.6695662E-02, 1.9717453E-03,	// a3
+		-5.0941778E+02, -1.0568189E+00, -2.4882341E-02, -9.6051393E-04, -4.1329125E-05,	// a4
+		1.6156158E+03, 5.8251142E-01, 4.1690495E-03, -1.0935880E-06, 2.3027702E-05,	// a5
+	};
+};
+
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::breakpoints[5];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::coefficients[TC_COEFF_COUNT * 4];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::coldJunctionBreakpoints[3];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::coldJunction[TC_CJ_COEFF_COUNT * 2];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::forwardBreakpoints[7];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::forwardCoefficients[TC_COEFF_COUNT * 6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::polynomialBreakpoints[6];
+template<typename T> constexpr T ThermocoupleCoefficients<ThermocoupleType::T, T>::polynomial[TC_POLYNOMIAL_COLUMNS(5) * 5];
+
+// Whether a type converts with its polynomial tables (TC_TYPE_x_POLYNOMIAL)
+template<ThermocoupleType Type> struct ThermocouplePolynomial;
+template<> struct ThermocouplePolynomial<ThermocoupleType::B> { static constexpr bool enabled = TC_TYPE_B_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::E> { static constexpr bool enabled = TC_TYPE_E_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::J> { static constexpr bool enabled = TC_TYPE_J_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::K> { static constexpr bool enabled = TC_TYPE_K_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::N> { static constexpr bool enabled = TC_TYPE_N_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::R> { static constexpr bool enabled = TC_TYPE_R_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::S> { static constexpr bool enabled = TC_TYPE_S_POLYNOMIAL; };
+template<> struct ThermocouplePolynomial<ThermocoupleType::T> { static constexpr bool enabled = TC_TYPE_T_POLYNOMIAL; };
+
+// The millivolt-to-temperature tables a type converts with - the rational
+// ones, or the polynomial ones if Polynomial is set.  degree is 0 for the
+// rational tables, otherwise the polynomial's degree, and columns the
+// number of coefficient columns stored.
+template<ThermocoupleType Type, typename T, bool Polynomial = ThermocouplePolynomial<Type>::enabled>
+struct ThermocoupleTemperatureTables
+{
+	static constexpr uint8_t degree = 0;
+	static constexpr uint8_t columns = TC_COEFF_COUNT;
+	static constexpr uint8_t segments = ThermocoupleCoefficients<Type, T>::segments;
+	static constexpr bool upperInclusive = ThermocoupleCoefficients<Type, T>::upperInclusive;
+	static constexpr const T *breakpoints = ThermocoupleCoefficients<Type, T>::breakpoints;
+	static constexpr const T *coefficients = ThermocoupleCoefficients<Type, T>::coefficients;
+};
+
+template<ThermocoupleType Type, typename T>
+struct ThermocoupleTemperatureTables<Type, T, true>
+{
+	static constexpr uint8_t degree = ThermocoupleCoefficients<Type, T>::polynomialDegree;
+	static constexpr uint8_t columns = TC_POLYNOMIAL_COLUMNS(degree);
+	static constexpr uint8_t segments = ThermocoupleCoefficients<Type, T>::polynomialSegments;
+	static constexpr bool upperInclusive = ThermocoupleCoefficients<Type, T>::upperInclusive;
+	static constexpr const T *breakpoints = ThermocoupleCoefficients<Type, T>::polynomialBreakpoints;
+	static constexpr const T *coefficients = ThermocoupleCoefficients<Type, T>::polynomial;
+};
+
+template<ThermocoupleType Type, typename T, bool Polynomial> constexpr const T *ThermocoupleTemperatureTables<Type, T, Polynomial>::breakpoints;
+template<ThermocoupleType Type, typename T, bool Polynomial> constexpr const T *ThermocoupleTemperatureTables<Type, T, Polynomial>::coefficients;
+template<ThermocoupleType Type, typename T> constexpr const T *ThermocoupleTemperatureTables<Type, T, true>::breakpoints;
+template<ThermocoupleType Type, typename T> constexpr const T *ThermocoupleTemperatureTables<Type, T, true>::coefficients;
+
+#endif
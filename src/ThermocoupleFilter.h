@@ -0,0 +1,266 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleFilter.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Streaming filters for thermocouple voltages, run on the millivolt
+    readings before they are converted so that only the filtered (and, with
+    a decimator, fewer) samples go through getTemperature().  The
+    conversion is nearly linear over the span of a few noisy readings, so
+    filtering before converting gives the same answer as converting every
+    reading and filtering the temperatures.
+
+    Every stage keeps its state in the object, sized by template
+    parameters - nothing is allocated.  Each has:
+      bool push(T in, T *out)   - feed one sample; true when *out holds a
+                                  new output
+      void reset()              - forget all history
+    Stages chain with ThermocoupleFilterChain, and tcFilterBlock() runs a
+    stage (or chain) over an array for batch use.  A NaN input is held off
+    by the median and exponential filters.  A moving average's output stays
+    NaN for at most 2N samples after one.
+
+      ThermocoupleMovingAverage<N>     - mean of the last N samples
+      ThermocoupleDecimator<R, Order>  - CIC-style sinc^Order lowpass, one
+                                         output per R inputs
+      ThermocoupleRunningMedian<N>     - median of the last N samples (N odd)
+      ThermocoupleExponentialFilter    - first-order IIR, y += a(x - y)
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_FILTER_H_
+#define _THERMOCOUPLE_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Mean of the last N samples - outputs every sample, averaging over fewer
+// until N have arrived.  The running sum is rebuilt from the window each
+// time it wraps, so float rounding can't build up over a long run.
+template<uint8_t N, typename T = float>
+class ThermocoupleMovingAverage
+{
+	static_assert(N > 0, "window must hold at least one sample");
+
+	public:
+		ThermocoupleMovingAverage() { reset(); }
+
+		void reset()
+		{
+			sum = T(0);
+			next = 0;
+			count = 0;
+		}
+
+		bool push(T in, T *out)
+		{
+			if (count == N)
+				sum -= window[next];
+			else
+				count++;
+			window[next] = in;
+			sum += in;
+
+			if (++next == N)
+			{
+				next = 0;
+				sum = T(0);
+				for (uint8_t i = 0; i < count; i++)
+					sum += window[i];
+			}
+			*out = sum / T(count);
+			return true;
+		}
+
+	private:
+		T window[N];
+		T sum;
+		uint8_t next;
+		uint8_t count;
+};
+
+// CIC-style decimator - Order cascaded length R moving averages, keeping
+// one output in R: the sinc^Order response of an Order stage CIC filter
+// with unity gain.  Built from moving sums rather than a CIC's unbounded
+// integrators, which would lose precision in floating point.  The first
+// output comes after R inputs.
+template<uint8_t R, uint8_t Order = 1, typename T = float>
+class ThermocoupleDecimator
+{
+	static_assert(R > 0 && Order > 0, "rate and order must be at least 1");
+
+	public:
+		ThermocoupleDecimator() { reset(); }
+
+		void reset()
+		{
+			for (uint8_t s = 0; s < Order; s++)
+				stage[s].reset();
+			phase = 0;
+		}
+
+		bool push(T in, T *out)
+		{
+			T value = in;
+			for (uint8_t s = 0; s < Order; s++)
+				stage[s].push(value, &value);
+			if (++phase < R)
+				return false;
+			phase = 0;
+			*out = value;
+			return true;
+		}
+
+	private:
+		ThermocoupleMovingAverage<R, T> stage[Order];
+		uint8_t phase;
+};
+
+// Median of the last N samples - rejects isolated spikes that an average
+// would smear.  Outputs every sample, over fewer until N have arrived.
+// Each sample costs one pass over the sorted window, so keep N small.  A
+// NaN input (an open circuit, say) never enters the window, which it would
+// leave unsorted - the last output is repeated instead.
+template<uint8_t N, typename T = float>
+class ThermocoupleRunningMedian
+{
+	static_assert(N > 0 && (N & 1), "window must be odd");
+
+	public:
+		ThermocoupleRunningMedian() { reset(); }
+
+		void reset()
+		{
+			next = 0;
+			count = 0;
+		}
+
+		bool push(T in, T *out)
+		{
+			uint8_t i, n = count;
+
+			if (in != in)
+			{
+				*out = (0 == count) ? in : median();
+				return true;
+			}
+
+			// Take the oldest sample out of the sorted window...
+			if (count == N)
+			{
+				for (i = 0; i < n - 1 && sorted[i] != window[next]; i++);
+				for (n--; i < n; i++)
+					sorted[i] = sorted[i + 1];
+			}
+			else
+				count++;
+			window[next] = in;
+			if (++next == N)
+				next = 0;
+
+			// ...and slide the new one into place
+			for (i = n; i > 0 && sorted[i - 1] > in; i--)
+				sorted[i] = sorted[i - 1];
+			sorted[i] = in;
+
+			*out = median();
+			return true;
+		}
+
+	private:
+		T median() const
+		{
+			return (count & 1) ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / T(2);
+		}
+
+		T window[N];   // arrival order
+		T sorted[N];
+		uint8_t next;
+		uint8_t count;
+};
+
+// First-order IIR lowpass, out += alpha * (in - out).  alpha = 1 passes the
+// input through; smaller is smoother (time constant about 1/alpha samples).
+// Starts at the first input rather than zero.  A NaN input would stay in
+// the state for good, so it leaves the state as it was.
+template<typename T = float>
+class ThermocoupleExponentialFilter
+{
+	public:
+		ThermocoupleExponentialFilter(T alpha) : alpha(alpha) { reset(); }
+
+		void reset()
+		{
+			primed = false;
+		}
+
+		bool push(T in, T *out)
+		{
+			if (in != in)
+			{
+				*out = primed ? state : in;
+				return true;
+			}
+			state = primed ? state + alpha * (in - state) : in;
+			primed = true;
+			*out = state;
+			return true;
+		}
+
+	private:
+		T alpha;
+		T state;
+		bool primed;
+};
+
+// Two stages in series - First's outputs feed Second.  Nest for more.
+template<class First, class Second, typename T = float>
+class ThermocoupleFilterChain
+{
+	public:
+		ThermocoupleFilterChain() {}
+		ThermocoupleFilterChain(const First &first, const Second &second) : first(first), second(second) {}
+
+		void reset()
+		{
+			first.reset();
+			second.reset();
+		}
+
+		bool push(T in, T *out)
+		{
+			T middle;
+			return first.push(in, &middle) && second.push(middle, out);
+		}
+
+		First first;
+		Second second;
+};
+
+// Run count samples through filter, writing its outputs to out (which may
+// be in).  Returns the number of outputs.
+template<class Filter, typename T> size_t tcFilterBlock(Filter &filter, const T *in, size_t count, T *out)
+{
+	size_t outputs = 0;
+	for (size_t i = 0; i < count; i++)
+		outputs += filter.push(in[i], &out[outputs]);
+	return outputs;
+}
+
+#endif
@@ -0,0 +1,358 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleFixed.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Integer-only conversions for parts without an FPU.
+
+      int32_t ThermocoupleFixed<Type>::getTemperature(int32_t microvolts, int32_t TcjMilli)
+
+    takes the thermocouple voltage in microvolts and the cold junction
+    temperature in thousandths of a degree C, and returns the temperature
+    in thousandths of a degree C (or TC_FIXED_OUT_OF_RANGE).  Any int32_t
+    input is safe - readings beyond the table, like a full scale ADC code,
+    come back out of range rather than overflowing.
+
+    The Q-format tables are generated by the compiler from the same Mosaic
+    coefficients the floating point paths use (ThermocoupleCoefficients.h),
+    so there is no second set of numbers to keep in sync.  Each segment is
+    evaluated as
+
+      u = (v - V0) scaled to a Q31 fraction of the segment's half width
+      N = u*(A1 + u*(A2 + u*(A3 + u*A4)))      A_k in Q(F+k)
+      D = 1 + u*(B1 + u*(B2 + u*B3))            B_k in Q(G+k)
+      T = T0 + N/D
+
+    and the division is done with a Newton-Raphson reciprocal, so nothing
+    needs a divide.  Every multiply is 32x32 bits with a 64 bit product -
+    15 of them per segment evaluation, plus 64 bit adds and shifts.  Most
+    32 bit parts do that in one or two instructions, but on AVR and
+    Cortex-M0 each is a libgcc call, which is where the time goes there.
+    Voltages inside the engine carry 8 fractional bits (1/256 uV), so the
+    cold junction voltage doesn't get rounded to a whole microvolt before
+    it's added.
+
+    Worst case error versus the double path is under 0.005C for every
+    type, checked at every 1/256 uV step of its range (see the README).
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_FIXED_H_
+#define _THERMOCOUPLE_FIXED_H_
+
+#include <stdint.h>
+#include "ThermocoupleCoefficients.h"
+
+// Returned (in milli-degrees C) for inputs outside a type's range
+#define TC_FIXED_OUT_OF_RANGE ((int32_t)(TC_OUT_OF_RANGE_TEMPERATURE * 1000))
+
+// Fractional bits carried on voltages inside the engine (1/256 uV)
+#define TC_FIXED_VOLTAGE_SHIFT 8
+
+// Cold junction inputs are clamped to within 2^17 milli-degrees (131C) of
+// their cold junction segment's center
+#define TC_FIXED_CJ_RANGE_BITS 17
+
+// One rational segment in Q format
+struct ThermocoupleFixedSegment
+{
+	int32_t x0;       // input offset (V0 or T0) in input units
+	int32_t y0;       // output offset (T0 or V0) in output units
+	int32_t a[4];     // numerator, a[k-1] is A_k in Q(F+k) output units
+	int32_t b[3];     // denominator, b[k-1] is B_k in Q(G+k)
+	uint8_t uShift;   // (input - x0) << uShift is u in Q31
+	uint8_t F;
+	uint8_t G;
+};
+
+/*********************************************************************************************************
+Compile-time table generation
+*********************************************************************************************************/
+
+static constexpr double tcPow2(int e)
+{
+	return (0 == e) ? 1.0 : ((e > 0) ? 2.0 * tcPow2(e - 1) : 0.5 * tcPow2(e + 1));
+}
+
+static constexpr double tcAbs(double v)
+{
+	return (v < 0) ? -v : v;
+}
+
+static constexpr double tcMax(double a, double b)
+{
+	return (a > b) ? a : b;
+}
+
+static constexpr int32_t tcRound(double v)
+{
+	return (int32_t)((v < 0) ? (v - 0.5) : (v + 0.5));
+}
+
+// Smallest m with 2^m > v
+static constexpr uint8_t tcBitsAbove(double v, uint8_t m = 0)
+{
+	return (tcPow2(m) > v) ? m : tcBitsAbove(v, m + 1);
+}
+
+// Largest f <= limit such that every Horner partial sum fits in 30 bits:
+// (|c1| + |c2| + |c3| + |c4|) * 2^(f+1), (|c2| + |c3| + |c4|) * 2^(f+2), ...
+static constexpr bool tcFits(double c1, double c2, double c3, double c4, int f)
+{
+	return ((tcAbs(c1) + tcAbs(c2) + tcAbs(c3) + tcAbs(c4)) * tcPow2(f + 1) < tcPow2(30))
+		&& ((tcAbs(c2) + tcAbs(c3) + tcAbs(c4)) * tcPow2(f + 2) < tcPow2(30))
+		&& ((tcAbs(c3) + tcAbs(c4)) * tcPow2(f + 3) < tcPow2(30))
+		&& (tcAbs(c4) * tcPow2(f + 4) < tcPow2(30));
+}
+
+static constexpr uint8_t tcFractionBits(double c1, double c2, double c3, double c4, int limit)
+{
+	return (limit <= 0 || tcFits(c1, c2, c3, c4, limit)) ? (uint8_t)limit : tcFractionBits(c1, c2, c3, c4, limit - 1);
+}
+
+// Build a segment from a rational in floating point units.
+//   x0, y0         - input and output offsets (already scaled to fixed units)
+//   halfWidth      - largest |input - x0| in fixed input units
+//   inputScale     - fixed input units per floating point input unit
+//   outputScale    - fixed output units per floating point output unit
+static constexpr ThermocoupleFixedSegment tcFixedSegmentScaled(int32_t x0, int32_t y0, uint8_t m, double X, double outputScale, double p1, double p2, double p3, double p4, double q1, double q2, double q3, uint8_t F, uint8_t G)
+{
+	return ThermocoupleFixedSegment
+	{
+		x0, y0,
+		{ tcRound(p1 * X * outputScale * tcPow2(F + 1)), tcRound(p2 * X * X * outputScale * tcPow2(F + 2)), tcRound(p3 * X * X * X * outputScale * tcPow2(F + 3)), tcRound(p4 * X * X * X * X * outputScale * tcPow2(F + 4)) },
+		{ tcRound(q1 * X * tcPow2(G + 1)), tcRound(q2 * X * X * tcPow2(G + 2)), tcRound(q3 * X * X * X * tcPow2(G + 3)) },
+		(uint8_t)(31 - m), F, G
+	};
+}
+
+// X is the segment half width in floating point input units
+static constexpr ThermocoupleFixedSegment tcFixedSegmentX(int32_t x0, int32_t y0, uint8_t m, double X, double outputScale, double p1, double p2, double p3, double p4, double q1, double q2, double q3)
+{
+	return tcFixedSegmentScaled(x0, y0, m, X, outputScale, p1, p2, p3, p4, q1, q2, q3,
+		tcFractionBits(p1 * X * outputScale, p2 * X * X * outputScale, p3 * X * X * X * outputScale, p4 * X * X * X * X * outputScale, 24),
+		tcFractionBits(q1 * X, q2 * X * X, q3 * X * X * X, 0.0, 28));
+}
+
+static constexpr ThermocoupleFixedSegment tcFixedSegment(double inputOffset, double outputOffset, double halfWidth, double inputScale, double outputScale, double p1, double p2, double p3, double p4, double q1, double q2, double q3)
+{
+	return tcFixedSegmentX(tcRound(inputOffset * inputScale), tcRound(outputOffset * outputScale), tcBitsAbove(halfWidth * inputScale + 1.0),
+		tcPow2(tcBitsAbove(halfWidth * inputScale + 1.0)) / inputScale, outputScale, p1, p2, p3, p4, q1, q2, q3);
+}
+
+/*********************************************************************************************************
+Run-time evaluation
+*********************************************************************************************************/
+
+// Top 32 bits of a 32x32 bit product
+static inline int32_t tcMulHigh(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b) >> 32);
+}
+
+// Evaluate one segment.  Returns false if the denominator isn't positive,
+// which only happens outside a fit's usable range.
+static inline bool tcFixedEvaluate(const ThermocoupleFixedSegment *s, int32_t input, int32_t *output)
+{
+	int32_t u = (int32_t)((uint32_t)(input - s->x0) << s->uShift);
+
+	int32_t n = s->a[3];
+	n = s->a[2] + tcMulHigh(n, u);
+	n = s->a[1] + tcMulHigh(n, u);
+	n = s->a[0] + tcMulHigh(n, u);
+	n = tcMulHigh(n, u);
+
+	int32_t d = s->b[2];
+	d = s->b[1] + tcMulHigh(d, u);
+	d = s->b[0] + tcMulHigh(d, u);
+	d = ((int32_t)1 << s->G) + tcMulHigh(d, u);
+
+	if (d <= 0)
+		return false;
+
+	// Normalize d into [2^30, 2^31) and take its reciprocal y (Q30) with
+	// Newton-Raphson, starting from the usual 48/17 - 32/17*d estimate.
+	// y stays in (2^30, 2^31] and the error term e under 2^26, so every
+	// product below is a 32x32 bit one.
+#if defined(__GNUC__) && !defined(__AVR__)
+	uint8_t k = (uint8_t)(__builtin_clzl((unsigned long)(uint32_t)d) - (8 * sizeof(unsigned long) - 32) - 1);
+	uint32_t dn = (uint32_t)d << k;
+#else
+	uint8_t k = 0;
+	uint32_t dn = (uint32_t)d;
+	while (!(dn & 0x40000000UL))
+	{
+		dn <<= 1;
+		k++;
+	}
+#endif
+
+	uint32_t y = 3031741621UL - (uint32_t)(((uint64_t)dn * 4042322160UL) >> 32);
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		int32_t e = ((int32_t)1 << 30) - (int32_t)(((uint64_t)dn * y) >> 31);
+		y += (int32_t)(((int64_t)e * y) >> 30);
+	}
+
+	uint8_t shift = s->F + 61 - s->G - k;
+	*output = s->y0 + (int32_t)(((int64_t)n * y + ((int64_t)1 << (shift - 1))) >> shift);
+	return true;
+}
+
+// mV to 1/256 uV, and C to 0.001C
+#define TC_FIXED_VOLTAGE_SCALE (1000.0 * (1 << TC_FIXED_VOLTAGE_SHIFT))
+#define TC_FIXED_TEMPERATURE_SCALE 1000.0
+
+template<ThermocoupleType Type> static constexpr double tcFixedCoefficient(uint8_t column, uint8_t seg)
+{
+	return ThermocoupleCoefficients<Type, double>::coefficients[column * ThermocoupleCoefficients<Type, double>::segments + seg];
+}
+
+template<ThermocoupleType Type> static constexpr ThermocoupleFixedSegment tcFixedTemperatureSegment(uint8_t seg)
+{
+	return tcFixedSegment(tcFixedCoefficient<Type>(TC_COEFF_V0, seg), tcFixedCoefficient<Type>(TC_COEFF_T0, seg),
+		tcMax(tcAbs(ThermocoupleCoefficients<Type, double>::breakpoints[seg] - tcFixedCoefficient<Type>(TC_COEFF_V0, seg)),
+			tcAbs(ThermocoupleCoefficients<Type, double>::breakpoints[seg + 1] - tcFixedCoefficient<Type>(TC_COEFF_V0, seg))),
+		TC_FIXED_VOLTAGE_SCALE, TC_FIXED_TEMPERATURE_SCALE,
+		tcFixedCoefficient<Type>(TC_COEFF_P1, seg), tcFixedCoefficient<Type>(TC_COEFF_P2, seg), tcFixedCoefficient<Type>(TC_COEFF_P3, seg), tcFixedCoefficient<Type>(TC_COEFF_P4, seg),
+		tcFixedCoefficient<Type>(TC_COEFF_Q1, seg), tcFixedCoefficient<Type>(TC_COEFF_Q2, seg), tcFixedCoefficient<Type>(TC_COEFF_Q3, seg));
+}
+
+template<ThermocoupleType Type> static constexpr double tcFixedColdJunctionCoefficient(uint8_t column, uint8_t seg)
+{
+	return ThermocoupleCoefficients<Type, double>::coldJunction[column * ThermocoupleCoefficients<Type, double>::coldJunctionSegments + seg];
+}
+
+template<ThermocoupleType Type> static constexpr ThermocoupleFixedSegment tcFixedColdJunctionSegment(uint8_t seg)
+{
+	return tcFixedSegment(tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_T0, seg), tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_V0, seg),
+		(tcPow2(TC_FIXED_CJ_RANGE_BITS) - 2.0) / TC_FIXED_TEMPERATURE_SCALE,
+		TC_FIXED_TEMPERATURE_SCALE, TC_FIXED_VOLTAGE_SCALE,
+		tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_P1, seg), tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_P2, seg),
+		tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_P3, seg), tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_P4, seg),
+		tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_Q1, seg), tcFixedColdJunctionCoefficient<Type>(TC_CJ_COEFF_Q2, seg), 0.0);
+}
+
+template<ThermocoupleType Type> static constexpr int32_t tcFixedColdJunctionBreakpoint(uint8_t i)
+{
+	return tcRound(ThermocoupleCoefficients<Type, double>::coldJunctionBreakpoints[i] * TC_FIXED_TEMPERATURE_SCALE);
+}
+
+template<ThermocoupleType Type> static constexpr int32_t tcFixedBreakpoint(uint8_t i)
+{
+	return tcRound(ThermocoupleCoefficients<Type, double>::breakpoints[i] * TC_FIXED_VOLTAGE_SCALE);
+}
+
+// The generated tables for one type, expanded over its segment indices
+template<ThermocoupleType Type, typename Indices = typename TCMakeIndexList<ThermocoupleCoefficients<Type, double>::segments>::type> struct ThermocoupleFixedTables;
+
+template<ThermocoupleType Type, unsigned... I> struct ThermocoupleFixedTables<Type, TCIndexList<I...> >
+{
+	static constexpr ThermocoupleFixedSegment segments[sizeof...(I)] = { tcFixedTemperatureSegment<Type>(I)... };
+	static constexpr int32_t breakpoints[sizeof...(I) + 1] = { tcFixedBreakpoint<Type>(I)..., tcFixedBreakpoint<Type>(sizeof...(I)) };
+};
+
+template<ThermocoupleType Type, unsigned... I> constexpr ThermocoupleFixedSegment ThermocoupleFixedTables<Type, TCIndexList<I...> >::segments[sizeof...(I)];
+template<ThermocoupleType Type, unsigned... I> constexpr int32_t ThermocoupleFixedTables<Type, TCIndexList<I...> >::breakpoints[sizeof...(I) + 1];
+
+// And its cold junction tables, expanded over the cold junction segment indices
+template<ThermocoupleType Type, typename Indices = typename TCMakeIndexList<ThermocoupleCoefficients<Type, double>::coldJunctionSegments>::type> struct ThermocoupleFixedColdJunctionTables;
+
+template<ThermocoupleType Type, unsigned... I> struct ThermocoupleFixedColdJunctionTables<Type, TCIndexList<I...> >
+{
+	static constexpr ThermocoupleFixedSegment segments[sizeof...(I)] = { tcFixedColdJunctionSegment<Type>(I)... };
+	static constexpr int32_t breakpoints[sizeof...(I) + 1] = { tcFixedColdJunctionBreakpoint<Type>(I)..., tcFixedColdJunctionBreakpoint<Type>(sizeof...(I)) };
+};
+
+template<ThermocoupleType Type, unsigned... I> constexpr ThermocoupleFixedSegment ThermocoupleFixedColdJunctionTables<Type, TCIndexList<I...> >::segments[sizeof...(I)];
+template<ThermocoupleType Type, unsigned... I> constexpr int32_t ThermocoupleFixedColdJunctionTables<Type, TCIndexList<I...> >::breakpoints[sizeof...(I) + 1];
+
+template<ThermocoupleType Type>
+class ThermocoupleFixed
+{
+	public:
+		typedef ThermocoupleFixedTables<Type> Tables;
+		typedef ThermocoupleFixedColdJunctionTables<Type> ColdJunctionTables;
+
+		// microvolts = thermocouple voltage in uV, TcjMilli = cold junction temperature in 0.001C
+		// Returns thermocouple temperature in 0.001C, or TC_FIXED_OUT_OF_RANGE
+		static int32_t getTemperature(int32_t microvolts, int32_t TcjMilli)
+		{
+			const uint8_t n = ThermocoupleCoefficients<Type, double>::segments;
+			int32_t coldJunction = computeColdJunctionVoltage(TcjMilli);
+
+			// Anything more than a microvolt past the table is out of range, and
+			// scaling a full scale reading to 1/256 uV would overflow
+			if (microvolts < ((Tables::breakpoints[0] - coldJunction) >> TC_FIXED_VOLTAGE_SHIFT) - 1
+				|| microvolts > ((Tables::breakpoints[n] - coldJunction) >> TC_FIXED_VOLTAGE_SHIFT) + 1)
+				return TC_FIXED_OUT_OF_RANGE;
+			return computeTemperature(microvolts * ((int32_t)1 << TC_FIXED_VOLTAGE_SHIFT) + coldJunction);
+		}
+
+		// voltage = cold junction compensated voltage in 1/256 uV
+		// Returns temperature in 0.001C, or TC_FIXED_OUT_OF_RANGE
+		static int32_t computeTemperature(int32_t voltage)
+		{
+			const uint8_t n = ThermocoupleCoefficients<Type, double>::segments;
+			const int32_t *bp = Tables::breakpoints;
+			uint8_t seg = 0;
+			int32_t temperature;
+
+			if (ThermocoupleCoefficients<Type, double>::upperInclusive)
+			{
+				if (!(bp[0] < voltage && voltage <= bp[n]))
+					return TC_FIXED_OUT_OF_RANGE;
+				for (uint8_t i = 1; i < n; i++)
+					seg += (voltage > bp[i]);
+			}
+			else
+			{
+				if (!(bp[0] <= voltage && voltage < bp[n]))
+					return TC_FIXED_OUT_OF_RANGE;
+				for (uint8_t i = 1; i < n; i++)
+					seg += (voltage >= bp[i]);
+			}
+
+			if (!tcFixedEvaluate(&Tables::segments[seg], voltage, &temperature))
+				return TC_FIXED_OUT_OF_RANGE;
+			return temperature;
+		}
+
+		// TcjMilli = cold junction temperature in 0.001C
+		// Returns equivalent voltage in 1/256 uV
+		static int32_t computeColdJunctionVoltage(int32_t TcjMilli)
+		{
+			const uint8_t n = ThermocoupleCoefficients<Type, double>::coldJunctionSegments;
+			const int32_t limit = ((int32_t)1 << TC_FIXED_CJ_RANGE_BITS) - 2;
+			uint8_t seg = 0;
+
+			for (uint8_t i = 1; i < n; i++)
+				seg += (TcjMilli >= ColdJunctionTables::breakpoints[i]);
+
+			// Clamped before taking the center off, so no TcjMilli overflows
+			const ThermocoupleFixedSegment *s = &ColdJunctionTables::segments[seg];
+			int32_t t = (TcjMilli > s->x0 + limit) ? s->x0 + limit : ((TcjMilli < s->x0 - limit) ? s->x0 - limit : TcjMilli);
+			int32_t voltage = s->y0;
+
+			tcFixedEvaluate(s, t, &voltage);
+			return voltage;
+		}
+};
+
+#endif
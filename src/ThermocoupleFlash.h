@@ -0,0 +1,264 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleFlash.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Flash-resident copies of the millivolt-to-temperature and cold junction
+    tables, for the TypeX classes on parts where constant data would
+    otherwise be copied into RAM (AVR).  Internal to the library.
+
+    With TC_FLASH_TABLES (always on for AVR) the TypeX classes stop
+    inlining each type's Thermocouple<> template, whose coefficient arrays
+    AVR keeps in RAM, and instead evaluate these copies through the shared
+    kernel in ThermocoupleKernel.h, reading them a value at a time with
+    tcTableRead().  The copies are built by the compiler from
+    ThermocoupleCoefficients, so there's still only one set of numbers, and
+    Thermocouple.cpp holds one per type.
+
+    A type's copy can also be cut down to the segments covering a range of
+    hot junction temperatures, set in C with TC_TYPE_x_MIN and TC_TYPE_x_MAX
+    (e.g. -DTC_TYPE_K_MIN=0 -DTC_TYPE_K_MAX=500).  Readings outside the
+    segments kept are out of range.  The segments are those of the tables
+    the type converts with (rational or polynomial), so the range kept is
+    usually somewhat wider than the one asked for.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_FLASH_H_
+#define _THERMOCOUPLE_FLASH_H_
+
+#include <stdint.h>
+#include "ThermocoupleKernel.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define TC_FLASH PROGMEM
+#if !defined(TC_FLASH_TABLES)
+#define TC_FLASH_TABLES
+#endif
+#else
+#define TC_FLASH
+#endif
+
+// Hot junction temperatures (C) each type's flash tables cover - by
+// default everything
+#ifndef TC_TYPE_B_MIN
+#define TC_TYPE_B_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_B_MAX
+#define TC_TYPE_B_MAX 10000.0
+#endif
+#ifndef TC_TYPE_E_MIN
+#define TC_TYPE_E_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_E_MAX
+#define TC_TYPE_E_MAX 10000.0
+#endif
+#ifndef TC_TYPE_J_MIN
+#define TC_TYPE_J_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_J_MAX
+#define TC_TYPE_J_MAX 10000.0
+#endif
+#ifndef TC_TYPE_K_MIN
+#define TC_TYPE_K_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_K_MAX
+#define TC_TYPE_K_MAX 10000.0
+#endif
+#ifndef TC_TYPE_N_MIN
+#define TC_TYPE_N_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_N_MAX
+#define TC_TYPE_N_MAX 10000.0
+#endif
+#ifndef TC_TYPE_R_MIN
+#define TC_TYPE_R_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_R_MAX
+#define TC_TYPE_R_MAX 10000.0
+#endif
+#ifndef TC_TYPE_S_MIN
+#define TC_TYPE_S_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_S_MAX
+#define TC_TYPE_S_MAX 10000.0
+#endif
+#ifndef TC_TYPE_T_MIN
+#define TC_TYPE_T_MIN TC_OUT_OF_RANGE_TEMPERATURE
+#endif
+#ifndef TC_TYPE_T_MAX
+#define TC_TYPE_T_MAX 10000.0
+#endif
+
+template<ThermocoupleType Type> struct ThermocoupleFlashRange;
+
+template<> struct ThermocoupleFlashRange<ThermocoupleType::B> { static constexpr double minimum = TC_TYPE_B_MIN, maximum = TC_TYPE_B_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::E> { static constexpr double minimum = TC_TYPE_E_MIN, maximum = TC_TYPE_E_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::J> { static constexpr double minimum = TC_TYPE_J_MIN, maximum = TC_TYPE_J_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::K> { static constexpr double minimum = TC_TYPE_K_MIN, maximum = TC_TYPE_K_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::N> { static constexpr double minimum = TC_TYPE_N_MIN, maximum = TC_TYPE_N_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::R> { static constexpr double minimum = TC_TYPE_R_MIN, maximum = TC_TYPE_R_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::S> { static constexpr double minimum = TC_TYPE_S_MIN, maximum = TC_TYPE_S_MAX; };
+template<> struct ThermocoupleFlashRange<ThermocoupleType::T> { static constexpr double minimum = TC_TYPE_T_MIN, maximum = TC_TYPE_T_MAX; };
+
+// Segment holding the voltage at temperature, clamped to the forward range
+template<ThermocoupleType Type> static constexpr uint8_t tcFlashSegment(double temperature)
+{
+	typedef ThermocoupleCoefficients<Type, double> Coefficients;
+	return Thermocouple<Type>::segment(Thermocouple<Type>::computeVoltage(
+		(temperature < Coefficients::forwardBreakpoints[0]) ? Coefficients::forwardBreakpoints[0]
+			: ((temperature > Coefficients::forwardBreakpoints[Coefficients::forwardSegments]) ? Coefficients::forwardBreakpoints[Coefficients::forwardSegments] : temperature)));
+}
+
+/*********************************************************************************************************
+Compile-time table copies
+*********************************************************************************************************/
+
+// Which of a type's segments its flash copy keeps
+template<ThermocoupleType Type> struct ThermocoupleFlashLayout
+{
+	static constexpr uint8_t firstSegment = tcFlashSegment<Type>(ThermocoupleFlashRange<Type>::minimum);
+	static constexpr uint8_t lastSegment = tcFlashSegment<Type>(ThermocoupleFlashRange<Type>::maximum);
+	static_assert(firstSegment <= lastSegment, "TC_TYPE_x_MIN is above TC_TYPE_x_MAX");
+	static constexpr uint8_t segments = lastSegment - firstSegment + 1;
+	static constexpr uint8_t coldJunctionSegments = ThermocoupleCoefficients<Type, double>::coldJunctionSegments;
+};
+
+// One precision's copy, laid out as in ThermocoupleCoefficients (column c of
+// segment s at c * segments + s), with as many columns as the tables it's
+// copied from
+template<ThermocoupleType Type, typename T> struct ThermocoupleFlashArrays
+{
+	T breakpoints[ThermocoupleFlashLayout<Type>::segments + 1];
+	T coefficients[ThermocoupleTemperatureTables<Type, T>::columns * ThermocoupleFlashLayout<Type>::segments];
+	T coldJunctionBreakpoints[ThermocoupleFlashLayout<Type>::coldJunctionSegments + 1];
+	T coldJunction[TC_CJ_COEFF_COUNT * ThermocoupleFlashLayout<Type>::coldJunctionSegments];
+};
+
+#define TC_FLASH_CJ_COLUMN(column) Coefficients::coldJunction[(column) * sizeof...(J) + J]...
+
+// I = kept segments counted from First, K = their coefficients (column
+// K / kept of kept segment K % kept), J = cold junction segments
+template<ThermocoupleType Type, typename T, unsigned First, unsigned... I, unsigned... K, unsigned... J> static constexpr ThermocoupleFlashArrays<Type, T> tcFlashArrays(TCIndexList<I...>, TCIndexList<K...>, TCIndexList<J...>)
+{
+	typedef ThermocoupleCoefficients<Type, T> Coefficients;
+	typedef ThermocoupleTemperatureTables<Type, T> Tables;
+	return ThermocoupleFlashArrays<Type, T>
+	{
+		{ Tables::breakpoints[First + I]..., Tables::breakpoints[First + sizeof...(I)] },
+		{ Tables::coefficients[(K / sizeof...(I)) * Tables::segments + First + K % sizeof...(I)]... },
+		{ Coefficients::coldJunctionBreakpoints[J]..., Coefficients::coldJunctionBreakpoints[sizeof...(J)] },
+		{
+			TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_T0), TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_V0),
+			TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_P1), TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_P2), TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_P3), TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_P4),
+			TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_Q1), TC_FLASH_CJ_COLUMN(TC_CJ_COEFF_Q2)
+		}
+	};
+}
+
+#undef TC_FLASH_CJ_COLUMN
+
+template<ThermocoupleType Type, typename T> static constexpr ThermocoupleFlashArrays<Type, T> tcFlashArrays()
+{
+	return tcFlashArrays<Type, T, ThermocoupleFlashLayout<Type>::firstSegment>(
+		typename TCMakeIndexList<ThermocoupleFlashLayout<Type>::segments>::type(),
+		typename TCMakeIndexList<ThermocoupleTemperatureTables<Type, T>::columns * ThermocoupleFlashLayout<Type>::segments>::type(),
+		typename TCMakeIndexList<ThermocoupleFlashLayout<Type>::coldJunctionSegments>::type());
+}
+
+// A type's flash copy in both precisions.  Define one per type as a plain
+// (not templated) variable - GCC ignores section attributes, PROGMEM among
+// them, on static members of class templates:
+//   static const ThermocoupleFlashTables<ThermocoupleType::K> typeKFlash TC_FLASH = ThermocoupleFlashTables<ThermocoupleType::K>::build();
+template<ThermocoupleType Type, typename Single = tc_single_t> struct ThermocoupleFlashTables
+{
+	ThermocoupleFlashArrays<Type, double> full;
+	ThermocoupleFlashArrays<Type, Single> single;
+
+	static constexpr ThermocoupleFlashTables build()
+	{
+		return ThermocoupleFlashTables{ tcFlashArrays<Type, double>(), tcFlashArrays<Type, Single>() };
+	}
+
+	// The run-time view of this copy
+	constexpr ThermocoupleSegmentTable table() const
+	{
+		return ThermocoupleSegmentTable
+		{
+			ThermocoupleFlashLayout<Type>::segments,
+			ThermocoupleCoefficients<Type, double>::upperInclusive,
+			ThermocoupleTemperatureTables<Type, double>::degree,
+			ThermocoupleFlashLayout<Type>::coldJunctionSegments,
+			full.breakpoints, full.coefficients, full.coldJunctionBreakpoints, full.coldJunction,
+			single.breakpoints, single.coefficients, single.coldJunctionBreakpoints, single.coldJunction
+		};
+	}
+};
+
+// Where double is single precision (AVR) there's one copy, shared
+template<ThermocoupleType Type> struct ThermocoupleFlashTables<Type, double>
+{
+	ThermocoupleFlashArrays<Type, double> full;
+
+	static constexpr ThermocoupleFlashTables build()
+	{
+		return ThermocoupleFlashTables{ tcFlashArrays<Type, double>() };
+	}
+
+	constexpr ThermocoupleSegmentTable table() const
+	{
+		return ThermocoupleSegmentTable
+		{
+			ThermocoupleFlashLayout<Type>::segments,
+			ThermocoupleCoefficients<Type, double>::upperInclusive,
+			ThermocoupleTemperatureTables<Type, double>::degree,
+			ThermocoupleFlashLayout<Type>::coldJunctionSegments,
+			full.breakpoints, full.coefficients, full.coldJunctionBreakpoints, full.coldJunction,
+			full.breakpoints, full.coefficients, full.coldJunctionBreakpoints, full.coldJunction
+		};
+	}
+};
+
+/*********************************************************************************************************
+Conversions
+*********************************************************************************************************/
+
+// Stands in for Thermocouple<Type, T> in the TypeX classes, evaluating the
+// run-time table at Table (a flash copy's table()) with the shared kernel
+template<const ThermocoupleSegmentTable *Table, typename T = double>
+class ThermocoupleTableConversion
+{
+	public:
+		// millivolts = cold junction compensated voltage in mV
+		// Returns temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE
+		static T computeTemperature(T millivolts)
+		{
+			return tcTemperatureScalar(Table, millivolts);
+		}
+
+		// Tcj = cold junction temperature in Celsius
+		// Returns equivalent voltage in mV
+		static T computeColdJunctionVoltage(T Tcj)
+		{
+			return tcColdJunctionScalar(Table, Tcj);
+		}
+};
+
+#endif
@@ -0,0 +1,337 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleKernel.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Scalar evaluators shared by the per-sample and batch paths.  Every
+    thermocouple type is described by a ThermocoupleSegmentTable for each
+    direction, and these functions are the only code that evaluates them.
+    Internal to the library.
+
+    On AVR the tables are in flash (see ThermocoupleFlash.h), so every
+    read goes through tcTableRead().  Elsewhere that's a plain load.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_KERNEL_H_
+#define _THERMOCOUPLE_KERNEL_H_
+
+#include <math.h>
+#include "Thermocouple.h"
+
+#if defined(__AVR__)
+// Out of line (Thermocouple.cpp), so a table read costs a call rather than
+// an inlined flash load at every use
+float tcTableRead(const float *p);
+double tcTableRead(const double *p);
+#else
+template<typename T> static inline T tcTableRead(const T *p) { return *p; }
+#endif
+
+// Pick the double or single precision arrays out of a table
+static inline const double *tcBreakpoints(const ThermocoupleSegmentTable *table, double) { return table->breakpoints; }
+static inline const double *tcCoefficients(const ThermocoupleSegmentTable *table, double) { return table->coefficients; }
+static inline const double *tcColdJunctionBreakpoints(const ThermocoupleSegmentTable *table, double) { return table->coldJunctionBreakpoints; }
+static inline const double *tcColdJunction(const ThermocoupleSegmentTable *table, double) { return table->coldJunction; }
+#if !defined(__SIZEOF_DOUBLE__) || (__SIZEOF_DOUBLE__ != __SIZEOF_FLOAT__)
+static inline const float *tcBreakpoints(const ThermocoupleSegmentTable *table, float) { return table->breakpointsSingle; }
+static inline const float *tcCoefficients(const ThermocoupleSegmentTable *table, float) { return table->coefficientsSingle; }
+static inline const float *tcColdJunctionBreakpoints(const ThermocoupleSegmentTable *table, float) { return table->coldJunctionBreakpointsSingle; }
+static inline const float *tcColdJunction(const ThermocoupleSegmentTable *table, float) { return table->coldJunctionSingle; }
+#endif
+
+// Cold junction temperature (C) to equivalent thermocouple voltage (mV) on
+// n segments of cold junction tables.  Outside the tables the end segments
+// are extrapolated.
+template<typename T> static inline uint8_t tcColdJunctionSegment(const T *bp, uint8_t n, T Tcj)
+{
+	uint8_t seg = 0;
+	uint8_t i;
+
+	for (i = 1; i < n; i++)
+		seg += (Tcj >= tcTableRead(&bp[i]));
+	return seg;
+}
+
+template<typename T> static inline T tcColdJunctionSegments(const T *bp, const T *cj, uint8_t n, T Tcj)
+{
+	uint8_t seg = tcColdJunctionSegment(bp, n, Tcj);
+	T t = Tcj - tcTableRead(&cj[TC_CJ_COEFF_T0 * n + seg]);
+	T numerator = t * (tcTableRead(&cj[TC_CJ_COEFF_P1 * n + seg]) + t * (tcTableRead(&cj[TC_CJ_COEFF_P2 * n + seg]) + t * (tcTableRead(&cj[TC_CJ_COEFF_P3 * n + seg]) + tcTableRead(&cj[TC_CJ_COEFF_P4 * n + seg]) * t)));
+	T denominator = T(1.0) + t * (tcTableRead(&cj[TC_CJ_COEFF_Q1 * n + seg]) + tcTableRead(&cj[TC_CJ_COEFF_Q2 * n + seg]) * t);
+	return (tcTableRead(&cj[TC_CJ_COEFF_V0 * n + seg]) + (numerator / denominator));
+}
+
+template<typename T> static inline T tcColdJunctionScalar(const ThermocoupleSegmentTable *table, T Tcj)
+{
+	return tcColdJunctionSegments(tcColdJunctionBreakpoints(table, T()), tcColdJunction(table, T()), table->coldJunctionSegments, Tcj);
+}
+
+// tcColdJunctionScalar() with the cold junction's Seebeck coefficient
+// dV/dTcj (mV/C) in *slope, from the same numerator and denominator - the
+// voltage is exactly tcColdJunctionScalar()'s.
+//   r = N / D,  r' = (N' - D' r) / D
+template<typename T> static inline T tcColdJunctionSlopeScalar(const ThermocoupleSegmentTable *table, T Tcj, T *slope)
+{
+	const T *cj = tcColdJunction(table, T());
+	const uint8_t n = table->coldJunctionSegments;
+	uint8_t seg = tcColdJunctionSegment(tcColdJunctionBreakpoints(table, T()), n, Tcj);
+	T p1 = tcTableRead(&cj[TC_CJ_COEFF_P1 * n + seg]), p2 = tcTableRead(&cj[TC_CJ_COEFF_P2 * n + seg]);
+	T p3 = tcTableRead(&cj[TC_CJ_COEFF_P3 * n + seg]), p4 = tcTableRead(&cj[TC_CJ_COEFF_P4 * n + seg]);
+	T q1 = tcTableRead(&cj[TC_CJ_COEFF_Q1 * n + seg]), q2 = tcTableRead(&cj[TC_CJ_COEFF_Q2 * n + seg]);
+
+	T t = Tcj - tcTableRead(&cj[TC_CJ_COEFF_T0 * n + seg]);
+	T numerator = t * (p1 + t * (p2 + t * (p3 + p4 * t)));
+	T denominator = T(1.0) + t * (q1 + q2 * t);
+	T ratio = numerator / denominator;
+	*slope = ((p1 + t * (T(2.0) * p2 + t * (T(3.0) * p3 + T(4.0) * p4 * t))) - (q1 + T(2.0) * q2 * t) * ratio) / denominator;
+	return (tcTableRead(&cj[TC_CJ_COEFF_V0 * n + seg]) + ratio);
+}
+
+// One rational segment at x, the input's distance from the segment's input
+// offset, with the result offset by column Out
+template<uint8_t Out, typename T> static inline T tcRationalSegment(const T *c, uint8_t n, uint8_t seg, T x)
+{
+	T numerator = x * (tcTableRead(&c[TC_COEFF_P1 * n + seg]) + x * (tcTableRead(&c[TC_COEFF_P2 * n + seg]) + x * (tcTableRead(&c[TC_COEFF_P3 * n + seg]) + tcTableRead(&c[TC_COEFF_P4 * n + seg]) * x)));
+	T denominator = T(1.0) + x * (tcTableRead(&c[TC_COEFF_Q1 * n + seg]) + x * (tcTableRead(&c[TC_COEFF_Q2 * n + seg]) + tcTableRead(&c[TC_COEFF_Q3 * n + seg]) * x));
+	return (tcTableRead(&c[Out * n + seg]) + (numerator / denominator));
+}
+
+// tcRationalSegment() with its derivative with respect to x in *slope, from
+// the same numerator and denominator - the value is exactly
+// tcRationalSegment()'s.
+//   r = N / D,  r' = (N' - D' r) / D
+template<uint8_t Out, typename T> static inline T tcRationalSlopeSegment(const T *c, uint8_t n, uint8_t seg, T x, T *slope)
+{
+	T p1 = tcTableRead(&c[TC_COEFF_P1 * n + seg]), p2 = tcTableRead(&c[TC_COEFF_P2 * n + seg]);
+	T p3 = tcTableRead(&c[TC_COEFF_P3 * n + seg]), p4 = tcTableRead(&c[TC_COEFF_P4 * n + seg]);
+	T q1 = tcTableRead(&c[TC_COEFF_Q1 * n + seg]), q2 = tcTableRead(&c[TC_COEFF_Q2 * n + seg]), q3 = tcTableRead(&c[TC_COEFF_Q3 * n + seg]);
+
+	T numerator = x * (p1 + x * (p2 + x * (p3 + p4 * x)));
+	T denominator = T(1.0) + x * (q1 + x * (q2 + q3 * x));
+	T ratio = numerator / denominator;
+	*slope = ((p1 + x * (T(2.0) * p2 + x * (T(3.0) * p3 + T(4.0) * p4 * x))) - (q1 + x * (T(2.0) * q2 + T(3.0) * q3 * x)) * ratio) / denominator;
+	return (tcTableRead(&c[Out * n + seg]) + ratio);
+}
+
+// One polynomial segment (see ThermocoupleTemperatureTables) of the given
+// degree at x, the millivolts' distance from the segment's V0 - Horner's
+// rule, with no division:  t = T0 + x*(a1 + x*(a2 + ... + x*a_degree))
+template<typename T> static inline T tcPolynomialSegment(const T *c, uint8_t n, uint8_t degree, uint8_t seg, T x)
+{
+	T r = tcTableRead(&c[(TC_POLYNOMIAL_A1 + degree - 1) * n + seg]);
+	uint8_t k;
+
+	for (k = degree - 1; k > 0; k--)
+		r = tcTableRead(&c[(TC_POLYNOMIAL_A1 + k - 1) * n + seg]) + x * r;
+	return (tcTableRead(&c[TC_COEFF_T0 * n + seg]) + x * r);
+}
+
+// tcPolynomialSegment() with its derivative with respect to x in *slope,
+// carried along the same Horner steps - the value is exactly
+// tcPolynomialSegment()'s.
+//   t = T0 + x r,  t' = r + x r'
+template<typename T> static inline T tcPolynomialSlopeSegment(const T *c, uint8_t n, uint8_t degree, uint8_t seg, T x, T *slope)
+{
+	T r = tcTableRead(&c[(TC_POLYNOMIAL_A1 + degree - 1) * n + seg]);
+	T dr = T(0.0);
+	uint8_t k;
+
+	for (k = degree - 1; k > 0; k--)
+	{
+		dr = r + x * dr;
+		r = tcTableRead(&c[(TC_POLYNOMIAL_A1 + k - 1) * n + seg]) + x * r;
+	}
+	*slope = r + x * dr;
+	return (tcTableRead(&c[TC_COEFF_T0 * n + seg]) + x * r);
+}
+
+// One millivolt-to-temperature segment at x, the millivolts' distance from
+// the segment's V0 - rational, or polynomial for a non-zero degree
+template<typename T> static inline T tcInverseSegment(const T *c, uint8_t n, uint8_t degree, uint8_t seg, T x)
+{
+	return degree ? tcPolynomialSegment(c, n, degree, seg, x) : tcRationalSegment<TC_COEFF_T0>(c, n, seg, x);
+}
+
+template<typename T> static inline T tcInverseSlopeSegment(const T *c, uint8_t n, uint8_t degree, uint8_t seg, T x, T *slope)
+{
+	return degree ? tcPolynomialSlopeSegment(c, n, degree, seg, x, slope) : tcRationalSlopeSegment<TC_COEFF_T0>(c, n, seg, x, slope);
+}
+
+// One rational segment.  The input is offset by column In and the result by
+// column Out - <TC_COEFF_V0, TC_COEFF_T0> for millivolts to temperature and
+// <TC_COEFF_T0, TC_COEFF_V0> for the forward tables.
+template<uint8_t In, uint8_t Out, typename T> static inline T tcEvaluateSegment(const T *c, uint8_t n, uint8_t seg, T input)
+{
+	return tcRationalSegment<Out>(c, n, seg, input - tcTableRead(&c[In * n + seg]));
+}
+
+// The segment holding millivolts in *seg, or false if it's out of range.
+// The segment is found by counting the interior breakpoints at or below the
+// input rather than walking an if/else chain - the compares don't depend on
+// each other, so there's no serial chain of branches to mispredict.
+template<typename T> static inline bool tcTemperatureSegment(const T *bp, uint8_t n, bool upperInclusive, T millivolts, uint8_t *seg)
+{
+	uint8_t i;
+
+	*seg = 0;
+	if (upperInclusive)
+	{
+		if (!(tcTableRead(&bp[0]) < millivolts && millivolts <= tcTableRead(&bp[n])))
+			return false;
+		for (i = 1; i < n; i++)
+			*seg += (millivolts > tcTableRead(&bp[i]));
+	}
+	else
+	{
+		if (!(tcTableRead(&bp[0]) <= millivolts && millivolts < tcTableRead(&bp[n])))
+			return false;
+		for (i = 1; i < n; i++)
+			*seg += (millivolts >= tcTableRead(&bp[i]));
+	}
+	return true;
+}
+
+// Thermocouple voltage (mV) to temperature (C) on n segments of breakpoints
+// and coefficients of the given degree (0 for rational), or
+// TC_OUT_OF_RANGE_TEMPERATURE
+template<typename T> static inline T tcTemperatureSegments(const T *bp, const T *c, uint8_t n, bool upperInclusive, uint8_t degree, T millivolts)
+{
+	uint8_t seg;
+
+	if (!tcTemperatureSegment(bp, n, upperInclusive, millivolts, &seg))
+		return T(TC_OUT_OF_RANGE_TEMPERATURE);
+	return tcInverseSegment(c, n, degree, seg, millivolts - tcTableRead(&c[TC_COEFF_V0 * n + seg]));
+}
+
+template<typename T> static inline T tcTemperatureScalar(const ThermocoupleSegmentTable *table, T millivolts)
+{
+	return tcTemperatureSegments(tcBreakpoints(table, T()), tcCoefficients(table, T()), table->segments, table->upperInclusive, table->degree, millivolts);
+}
+
+// Raw thermocouple voltage (mV) and cold junction temperature (C) to
+// temperature (C), as tcTemperatureScalar() of the compensated voltage, with
+// dT/dV (C/mV) in *slope and in *uncertainty the standard uncertainty (C)
+// that reading noise sigmaMillivolts (mV) and cold junction uncertainty
+// sigmaTcj (C) give it.  Both are 0 out of range.  The cold junction
+// moves the compensated voltage by its own Seebeck coefficient, so
+//   uncertainty = |dT/dV| sqrt(sigmaMillivolts^2 + (dVcj/dTcj sigmaTcj)^2)
+template<typename T> static inline T tcSensitivityScalar(const ThermocoupleSegmentTable *table, T millivolts, T Tcj, T sigmaMillivolts, T sigmaTcj, T *slope, T *uncertainty)
+{
+	const T *c = tcCoefficients(table, T());
+	const uint8_t n = table->segments;
+	T coldJunctionSlope;
+	T compensated = millivolts + tcColdJunctionSlopeScalar(table, Tcj, &coldJunctionSlope);
+	uint8_t seg;
+
+	if (!tcTemperatureSegment(tcBreakpoints(table, T()), n, table->upperInclusive, compensated, &seg))
+	{
+		*slope = *uncertainty = T(0.0);
+		return T(TC_OUT_OF_RANGE_TEMPERATURE);
+	}
+	T temperature = tcInverseSlopeSegment(c, n, table->degree, seg, compensated - tcTableRead(&c[TC_COEFF_V0 * n + seg]), slope);
+	T sigmaColdJunction = coldJunctionSlope * sigmaTcj;
+	*uncertainty = (T)fabs(*slope) * (T)sqrt(sigmaMillivolts * sigmaMillivolts + sigmaColdJunction * sigmaColdJunction);
+	return temperature;
+}
+
+// Raw ADC code to temperature (C) on a channel from getAdcChannel(), or
+// TC_OUT_OF_RANGE_TEMPERATURE.  T is the type evaluated in - tc_single_t
+// for a float channel.
+template<typename T, typename C> static inline T tcAdcTemperatureScalar(const ThermocoupleSegmentTable *table, const ThermocoupleAdcChannel<C> &channel, int32_t code)
+{
+	const uint8_t n = table->segments;
+	const int32_t *k = channel.threshold;
+	uint8_t seg = 0;
+	uint8_t i;
+
+	if (!(code > k[0] && code <= k[n]))
+		return T(TC_OUT_OF_RANGE_TEMPERATURE);
+	for (i = 1; i < n; i++)
+		seg += (code > k[i]);
+
+	T x = (T)(code - channel.origin[seg]) * (T)channel.millivoltsPerCode - (T)channel.fraction[seg];
+	return tcInverseSegment(tcCoefficients(table, T()), n, table->degree, seg, x);
+}
+
+// A probe's calibration - see ThermocoupleCalibration.  T is the type
+// evaluated in, as for tcAdcTemperatureScalar().
+template<typename T, typename C> static inline T tcCalibratedMillivolts(const ThermocoupleCalibration<C> &calibration, T raw)
+{
+	return raw * (T)calibration.gain + (T)calibration.offset;
+}
+
+template<typename T, typename C> static inline T tcDeviation(const ThermocoupleCalibration<C> &calibration, T temperature)
+{
+	const C *d = calibration.deviation;
+
+	if (T(TC_OUT_OF_RANGE_TEMPERATURE) == temperature)
+		return temperature;
+	return temperature + ((T)d[0] + temperature * ((T)d[1] + temperature * ((T)d[2] + temperature * (T)d[3])));
+}
+
+// TC_STATUS_* bits for a raw thermocouple voltage and its compensated
+// voltage, using the same compares as tcTemperatureScalar().  Written as
+// bit arithmetic on compare results so it compiles without branches.
+template<typename T> static inline uint8_t tcStatusScalar(const ThermocoupleSegmentTable *table, T raw, T millivolts)
+{
+	const T *bp = tcBreakpoints(table, T());
+	const uint8_t n = table->segments;
+	uint8_t under, over;
+
+	if (table->upperInclusive)
+	{
+		under = !(millivolts > tcTableRead(&bp[0]));
+		over = !(millivolts <= tcTableRead(&bp[n]));
+	}
+	else
+	{
+		under = !(millivolts >= tcTableRead(&bp[0]));
+		over = !(millivolts < tcTableRead(&bp[n]));
+	}
+	uint8_t open = !(raw > -T(TC_OPEN_CIRCUIT_MILLIVOLTS) && raw < T(TC_OPEN_CIRCUIT_MILLIVOLTS));
+	return (uint8_t)(under * TC_STATUS_UNDER_RANGE | over * TC_STATUS_OVER_RANGE | open * TC_STATUS_OPEN_CIRCUIT);
+}
+
+template<typename T> static inline uint8_t tcColdJunctionStatus(const ThermocoupleSegmentTable *table, T Tcj)
+{
+	const T *bp = tcColdJunctionBreakpoints(table, T());
+	return (uint8_t)(!(Tcj >= tcTableRead(&bp[0]) && Tcj <= tcTableRead(&bp[table->coldJunctionSegments])) * TC_STATUS_COLD_JUNCTION_RANGE);
+}
+
+// Temperature (C) to voltage referenced to 0C (mV), or TC_OUT_OF_RANGE_TEMPERATURE.
+// table is a forward table - see TypedThermocouple.  The range is closed at
+// both ends.
+template<typename T> static inline T tcVoltageScalar(const ThermocoupleSegmentTable *table, T temperature)
+{
+	const uint8_t n = table->segments;
+	const T *bp = tcBreakpoints(table, T());
+	const T *c = tcCoefficients(table, T());
+	uint8_t seg = 0;
+	uint8_t i;
+
+	if (!(tcTableRead(&bp[0]) <= temperature && temperature <= tcTableRead(&bp[n])))
+		return T(TC_OUT_OF_RANGE_TEMPERATURE);
+	for (i = 1; i < n; i++)
+		seg += (temperature >= tcTableRead(&bp[i]));
+
+	return tcEvaluateSegment<TC_COEFF_T0, TC_COEFF_V0>(c, n, seg, temperature);
+}
+
+#endif
@@ -0,0 +1,323 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleLog.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Log writer and reader.  The writer is built everywhere but AVR and the
+    reader on POSIX hosts - see ThermocoupleLog.h for the format.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#if !defined(__AVR__)
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ThermocoupleLog.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool tcLogValidType(uint8_t type)
+{
+	return type <= (uint8_t)ThermocoupleType::T;
+}
+
+/*********************************************************************************************************
+Writer
+*********************************************************************************************************/
+
+template<typename T> ThermocoupleLogWriter<T>::ThermocoupleLogWriter() : file(NULL), channels(0), blockSamples(0), samples(0),
+	timestamps(NULL), coldJunction(NULL), millivolts(NULL), failed(false), started(false), lastTimestamp(0)
+{
+}
+
+template<typename T> ThermocoupleLogWriter<T>::~ThermocoupleLogWriter()
+{
+	close();
+}
+
+template<typename T> void ThermocoupleLogWriter<T>::release()
+{
+	if (file)
+		fclose(file);
+	free(timestamps);
+	free(coldJunction);
+	free(millivolts);
+	file = NULL;
+	timestamps = NULL;
+	coldJunction = NULL;
+	millivolts = NULL;
+}
+
+template<typename T> bool ThermocoupleLogWriter<T>::open(const char *path, const ThermocoupleType *types, uint8_t logChannels, uint32_t logBlockSamples)
+{
+	ThermocoupleLogHeader header;
+	uint8_t ch;
+
+	close();
+	if (0 == logChannels || 0 == logBlockSamples)
+		return false;
+	for (ch = 0; ch < logChannels; ch++)
+		if (!tcLogValidType((uint8_t)types[ch]))
+			return false;
+
+	channels = logChannels;
+	blockSamples = logBlockSamples;
+	samples = 0;
+	failed = false;
+	started = false;
+	timestamps = (int64_t *)malloc(sizeof(int64_t) * blockSamples);
+	coldJunction = (T *)malloc(sizeof(T) * blockSamples);
+	millivolts = (T *)malloc(sizeof(T) * blockSamples * channels);
+	if (NULL == timestamps || NULL == coldJunction || NULL == millivolts || NULL == (file = fopen(path, "wb")))
+	{
+		release();
+		return false;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TC_LOG_MAGIC, sizeof(header.magic));
+	header.byteOrder = TC_LOG_BYTE_ORDER;
+	header.version = TC_LOG_VERSION;
+	header.sampleSize = sizeof(T);
+	header.channels = channels;
+	header.blockSamples = blockSamples;
+	header.headerSize = tcLogAlign(sizeof(header) + channels);
+	write(&header, sizeof(header));
+	for (ch = 0; ch < channels; ch++)
+	{
+		uint8_t type = (uint8_t)types[ch];
+		write(&type, 1);
+	}
+	pad(sizeof(header) + channels);
+	return !failed;
+}
+
+template<typename T> bool ThermocoupleLogWriter<T>::append(int64_t timestamp, T Tcj, const T *reading)
+{
+	if (NULL == file || (started && timestamp < lastTimestamp))
+		return false;
+	started = true;
+	lastTimestamp = timestamp;
+
+	timestamps[samples] = timestamp;
+	coldJunction[samples] = Tcj;
+	for (uint8_t ch = 0; ch < channels; ch++)
+		millivolts[(size_t)ch * blockSamples + samples] = reading[ch];
+	if (++samples == blockSamples)
+		flush();
+	return !failed;
+}
+
+template<typename T> bool ThermocoupleLogWriter<T>::close()
+{
+	bool ok;
+
+	if (NULL == file)
+		return false;
+	flush();
+	ok = (0 == fclose(file)) && !failed;
+	file = NULL;
+	release();
+	return ok;
+}
+
+template<typename T> bool ThermocoupleLogWriter<T>::flush()
+{
+	ThermocoupleLogBlockHeader header;
+	T range[2 * 255];
+	uint32_t i;
+	uint8_t ch;
+
+	if (0 == samples)
+		return !failed;
+
+	for (ch = 0; ch < channels; ch++)
+	{
+		const T *column = millivolts + (size_t)ch * blockSamples;
+		T low = T(INFINITY), high = T(-INFINITY);
+		for (i = 0; i < samples; i++)
+		{
+			if (column[i] < low)
+				low = column[i];
+			if (column[i] > high)
+				high = column[i];
+		}
+		range[ch] = low;
+		range[channels + ch] = high;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic = TC_LOG_BLOCK_MAGIC;
+	header.samples = samples;
+	header.size = tcLogBlockSize(channels, sizeof(T), samples);
+	header.firstTimestamp = timestamps[0];
+	header.lastTimestamp = timestamps[samples - 1];
+
+	write(&header, sizeof(header));
+	pad(sizeof(header));
+	write(range, sizeof(T) * 2 * channels);
+	pad(sizeof(T) * 2 * channels);
+	write(timestamps, sizeof(int64_t) * samples);
+	pad(sizeof(int64_t) * samples);
+	write(coldJunction, sizeof(T) * samples);
+	pad(sizeof(T) * samples);
+	for (ch = 0; ch < channels; ch++)
+	{
+		write(millivolts + (size_t)ch * blockSamples, sizeof(T) * samples);
+		pad(sizeof(T) * samples);
+	}
+	samples = 0;
+	return !failed;
+}
+
+template<typename T> void ThermocoupleLogWriter<T>::write(const void *data, size_t bytes)
+{
+	if (!failed && bytes > 0 && fwrite(data, 1, bytes, file) != bytes)
+		failed = true;
+}
+
+// Zeros from the end of a part bytes long to the next TC_LOG_ALIGN boundary
+template<typename T> void ThermocoupleLogWriter<T>::pad(size_t bytes)
+{
+	static const uint8_t zeros[TC_LOG_ALIGN] = { 0 };
+	write(zeros, tcLogAlign(bytes) - bytes);
+}
+
+template class ThermocoupleLogWriter<float>;
+template class ThermocoupleLogWriter<double>;
+
+/*********************************************************************************************************
+Reader
+*********************************************************************************************************/
+
+#if defined(__unix__) || defined(__APPLE__)
+
+ThermocoupleLogReader::ThermocoupleLogReader() : data(NULL), size(0), header(NULL), blockStart(NULL), blockCount(0), sampleCount(0)
+{
+}
+
+ThermocoupleLogReader::~ThermocoupleLogReader()
+{
+	close();
+}
+
+void ThermocoupleLogReader::close()
+{
+	if (data)
+		munmap((void *)data, size);
+	free(blockStart);
+	data = NULL;
+	size = 0;
+	header = NULL;
+	blockStart = NULL;
+	blockCount = 0;
+	sampleCount = 0;
+}
+
+bool ThermocoupleLogReader::open(const char *path)
+{
+	struct stat info;
+	const ThermocoupleLogHeader *h;
+	uint32_t capacity = 0;
+	size_t offset;
+	uint8_t ch;
+	void *mapping;
+	int fd;
+
+	close();
+	if ((fd = ::open(path, O_RDONLY)) < 0)
+		return false;
+	if (0 != fstat(fd, &info) || (size_t)info.st_size < sizeof(ThermocoupleLogHeader))
+	{
+		::close(fd);
+		return false;
+	}
+	mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (MAP_FAILED == mapping)
+		return false;
+	data = (const uint8_t *)mapping;
+	size = (size_t)info.st_size;
+
+	h = (const ThermocoupleLogHeader *)data;
+	if (0 != memcmp(h->magic, TC_LOG_MAGIC, sizeof(h->magic)) || TC_LOG_BYTE_ORDER != h->byteOrder || TC_LOG_VERSION != h->version
+		|| (sizeof(float) != h->sampleSize && sizeof(double) != h->sampleSize) || 0 == h->channels
+		|| tcLogAlign(sizeof(ThermocoupleLogHeader) + h->channels) != h->headerSize || h->headerSize > size)
+	{
+		close();
+		return false;
+	}
+	for (ch = 0; ch < h->channels; ch++)
+	{
+		if (!tcLogValidType(data[sizeof(ThermocoupleLogHeader) + ch]))
+		{
+			close();
+			return false;
+		}
+	}
+	header = h;
+
+	// Index the blocks, stopping at the first that's damaged or cut short
+	for (offset = h->headerSize; offset + sizeof(ThermocoupleLogBlockHeader) <= size; offset += block(blockCount - 1)->size)
+	{
+		const ThermocoupleLogBlockHeader *b = (const ThermocoupleLogBlockHeader *)(data + offset);
+		if (TC_LOG_BLOCK_MAGIC != b->magic || 0 == b->samples || b->samples > h->blockSamples
+			|| tcLogBlockSize(h->channels, h->sampleSize, b->samples) != b->size || b->size > size - offset)
+			break;
+		if (blockCount == capacity)
+		{
+			capacity = capacity ? 2 * capacity : 64;
+			const uint8_t **grown = (const uint8_t **)realloc(blockStart, sizeof(*blockStart) * capacity);
+			if (NULL == grown)
+			{
+				close();
+				return false;
+			}
+			blockStart = grown;
+		}
+		blockStart[blockCount++] = data + offset;
+		sampleCount += b->samples;
+	}
+	return true;
+}
+
+uint32_t ThermocoupleLogReader::find(int64_t timestamp) const
+{
+	uint32_t low = 0, high = blockCount;
+
+	while (low < high)
+	{
+		uint32_t mid = low + (high - low) / 2;
+		if (block(mid)->lastTimestamp < timestamp)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+#endif
+
+#endif
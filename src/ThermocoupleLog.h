@@ -0,0 +1,243 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleLog.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Binary log of raw thermocouple readings, laid out so that a reader can
+    hand the stored columns straight to the batch conversions.
+
+    A log is a header followed by blocks.  The header holds the channel map
+    (a ThermocoupleType per channel), the sample size (float or double) and
+    the rows per block.  Each block holds up to that many rows - one
+    timestamp, one cold junction temperature and one reading per channel -
+    stored column by column:
+
+      ThermocoupleLogBlockHeader   samples, size, first and last timestamp
+      T minimum[channels]          smallest and largest reading per channel
+      T maximum[channels]            (mV), ignoring NaNs
+      int64_t timestamp[samples]   in whatever units the writer chose
+      T Tcj[samples]               C
+      T millivolts[samples]        one column per channel, in channel order
+      ...
+
+    Every part starts on an 8 byte boundary, so the columns of a mapped log
+    can be used in place.  Values are stored in the writer's byte order,
+    which the reader checks.
+
+    Timestamps never decrease, so ThermocoupleLogReader::find() can skip to
+    a time with a binary search over the block headers, and the per-block
+    minimum and maximum let range and alarm queries skip whole blocks
+    without touching their samples.
+
+    ThermocoupleLogWriter writes logs with stdio (not available on AVR).
+    ThermocoupleLogReader memory-maps them (POSIX hosts only).
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_LOG_H_
+#define _THERMOCOUPLE_LOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ThermocoupleCoefficients.h"
+
+// First 8 bytes of a log - the CR LF and ^Z catch text-mode mangling
+#define TC_LOG_MAGIC "TCLOG\r\n\032"
+#define TC_LOG_VERSION 1
+// Written as-is, so a reader on the other byte order sees 0x04030201
+#define TC_LOG_BYTE_ORDER 0x01020304UL
+#define TC_LOG_BLOCK_MAGIC 0x4B4C4254UL   // "TBLK" little-endian
+#define TC_LOG_ALIGN 8
+#define TC_LOG_BLOCK_SAMPLES 4096
+
+struct ThermocoupleLogHeader
+{
+	char magic[8];           // TC_LOG_MAGIC
+	uint32_t byteOrder;      // TC_LOG_BYTE_ORDER
+	uint16_t version;        // TC_LOG_VERSION
+	uint8_t sampleSize;      // 4 (float) or 8 (double)
+	uint8_t channels;
+	uint32_t blockSamples;   // rows in a full block
+	uint32_t headerSize;     // bytes to the first block, channel map included
+	uint64_t reserved;
+	// uint8_t type[channels] follows, ThermocoupleType values
+};
+
+struct ThermocoupleLogBlockHeader
+{
+	uint32_t magic;           // TC_LOG_BLOCK_MAGIC
+	uint32_t samples;         // rows in this block
+	uint64_t size;            // bytes in the whole block, this header included
+	int64_t firstTimestamp;
+	int64_t lastTimestamp;
+};
+
+static inline size_t tcLogAlign(size_t bytes)
+{
+	return (bytes + TC_LOG_ALIGN - 1) & ~(size_t)(TC_LOG_ALIGN - 1);
+}
+
+// Byte offsets of a block's parts from the start of the block
+static inline size_t tcLogRangeOffset()
+{
+	return tcLogAlign(sizeof(ThermocoupleLogBlockHeader));
+}
+
+static inline size_t tcLogTimestampOffset(uint8_t channels, uint8_t sampleSize)
+{
+	return tcLogRangeOffset() + tcLogAlign((size_t)2 * channels * sampleSize);
+}
+
+static inline size_t tcLogColdJunctionOffset(uint8_t channels, uint8_t sampleSize, uint32_t samples)
+{
+	return tcLogTimestampOffset(channels, sampleSize) + tcLogAlign((size_t)samples * sizeof(int64_t));
+}
+
+// channel = channels gives the size of the whole block
+static inline size_t tcLogMillivoltOffset(uint8_t channels, uint8_t sampleSize, uint32_t samples, uint8_t channel)
+{
+	return tcLogColdJunctionOffset(channels, sampleSize, samples) + (size_t)(1 + channel) * tcLogAlign((size_t)samples * sampleSize);
+}
+
+static inline size_t tcLogBlockSize(uint8_t channels, uint8_t sampleSize, uint32_t samples)
+{
+	return tcLogMillivoltOffset(channels, sampleSize, samples, channels);
+}
+
+#if !defined(__AVR__)
+
+#include <stdio.h>
+
+// T = float or double, the precision stored.  Rows are buffered and written
+// a block at a time.
+template<typename T = float>
+class ThermocoupleLogWriter
+{
+	public:
+		ThermocoupleLogWriter();
+		~ThermocoupleLogWriter();
+
+		// types = channels entries; blockSamples = rows per block
+		// Returns false if the file can't be created or the buffers allocated
+		bool open(const char *path, const ThermocoupleType *types, uint8_t channels, uint32_t blockSamples = TC_LOG_BLOCK_SAMPLES);
+		// One row - timestamp, cold junction temperature in C and channels
+		// readings in mV.  Returns false if not open, the timestamp is earlier
+		// than the last, or a full block can't be written.
+		bool append(int64_t timestamp, T Tcj, const T *millivolts);
+		// Writes the last (partial) block and closes the file.  Returns false if
+		// anything since open() failed to write.
+		bool close();
+
+	private:
+		ThermocoupleLogWriter(const ThermocoupleLogWriter &);
+		ThermocoupleLogWriter &operator=(const ThermocoupleLogWriter &);
+
+		bool flush();
+		void write(const void *data, size_t bytes);
+		void pad(size_t bytes);
+		void release();
+
+		FILE *file;
+		uint8_t channels;
+		uint32_t blockSamples;
+		uint32_t samples;      // rows buffered
+		int64_t *timestamps;
+		T *coldJunction;
+		T *millivolts;         // channel major, blockSamples per channel
+		bool failed;           // a write has failed since open()
+		bool started;          // a row has been appended since open()
+		int64_t lastTimestamp;
+};
+
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// A log mapped read-only.  Every pointer it returns points into the mapping
+// and is good until close().
+class ThermocoupleLogReader
+{
+	public:
+		ThermocoupleLogReader();
+		~ThermocoupleLogReader();
+
+		// Returns false if the file can't be mapped or isn't a log in this
+		// machine's byte order.  A partly written last block is left out.
+		bool open(const char *path);
+		void close();
+
+		uint8_t channels() const { return header ? header->channels : 0; }
+		// sizeof(float) or sizeof(double)
+		uint8_t sampleSize() const { return header ? header->sampleSize : 0; }
+		ThermocoupleType type(uint8_t channel) const { return (ThermocoupleType)data[sizeof(ThermocoupleLogHeader) + channel]; }
+		uint32_t blocks() const { return blockCount; }
+		uint64_t samples() const { return sampleCount; }
+		const ThermocoupleLogBlockHeader *block(uint32_t b) const { return (const ThermocoupleLogBlockHeader *)blockStart[b]; }
+
+		// First block that may hold a sample at or after timestamp, or blocks()
+		// if none do
+		uint32_t find(int64_t timestamp) const;
+
+		// Columns of block b, block(b)->samples long.  The T forms return NULL
+		// if T isn't the stored precision.
+		const int64_t *timestamps(uint32_t b) const
+		{
+			return (const int64_t *)(blockStart[b] + tcLogTimestampOffset(header->channels, header->sampleSize));
+		}
+
+		template<typename T> const T *coldJunction(uint32_t b) const
+		{
+			if (sizeof(T) != header->sampleSize)
+				return NULL;
+			return (const T *)(blockStart[b] + tcLogColdJunctionOffset(header->channels, header->sampleSize, block(b)->samples));
+		}
+
+		template<typename T> const T *millivolts(uint32_t b, uint8_t channel) const
+		{
+			if (sizeof(T) != header->sampleSize)
+				return NULL;
+			return (const T *)(blockStart[b] + tcLogMillivoltOffset(header->channels, header->sampleSize, block(b)->samples, channel));
+		}
+
+		// Smallest and largest reading on channel in block b (mV)
+		template<typename T> T minimum(uint32_t b, uint8_t channel) const
+		{
+			return (sizeof(T) == header->sampleSize) ? ((const T *)(blockStart[b] + tcLogRangeOffset()))[channel] : T(0);
+		}
+
+		template<typename T> T maximum(uint32_t b, uint8_t channel) const
+		{
+			return (sizeof(T) == header->sampleSize) ? ((const T *)(blockStart[b] + tcLogRangeOffset()))[header->channels + channel] : T(0);
+		}
+
+	private:
+		ThermocoupleLogReader(const ThermocoupleLogReader &);
+		ThermocoupleLogReader &operator=(const ThermocoupleLogReader &);
+
+		const uint8_t *data;
+		size_t size;
+		const ThermocoupleLogHeader *header;
+		const uint8_t **blockStart;
+		uint32_t blockCount;
+		uint64_t sampleCount;
+};
+
+#endif
+
+#endif
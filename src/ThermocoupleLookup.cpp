@@ -0,0 +1,240 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleLookup.cpp
+License:  GNU General Public License v3
+
+ABOUT:
+    Run time lookup table builder.  Each run of intervals is sized by
+    bisecting on the interval count, measuring the float lookup against
+    the double rational fit it replaces at several points per interval.
+    Not built on AVR - use the tables from extras/tools/lookup_table.cpp
+    there instead.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#if !defined(__AVR__)
+
+#include <stdlib.h>
+#include <string.h>
+#include "ThermocoupleLookup.h"
+
+#define TC_LOOKUP_MAX_INTERVALS 65535
+#define TC_LOOKUP_SAMPLES_PER_INTERVAL 16
+// Headroom for what the samples miss - peaks between them, float rounding of
+// the result, and the step between fits inside a uniform table's intervals
+#define TC_LOOKUP_ERROR_MARGIN 0.95
+
+// What one run of intervals is fitted to - a single rational segment, or
+// for a uniform table the whole piecewise fit
+struct ThermocoupleLookupSource
+{
+	const double *breakpoints;
+	uint8_t segments;
+	uint8_t seg;            // segment to evaluate, or segments for "whichever applies"
+	double (*evaluate)(double, uint8_t);
+};
+
+static double tcLookupReference(const ThermocoupleLookupSource *src, double millivolts)
+{
+	uint8_t seg = src->seg;
+	uint8_t i;
+
+	if (seg == src->segments)
+		for (seg = 0, i = 1; i < src->segments; i++)
+			seg += (millivolts >= src->breakpoints[i]);
+	return src->evaluate(millivolts, seg);
+}
+
+// Fill intervals coefficients for the run starting at lo with scale intervals/mV
+static void tcLookupFill(const ThermocoupleLookupSource *src, float lo, float scale, uint16_t intervals, uint8_t order, float *coefficients)
+{
+	const double h = 1.0 / (double)scale;
+	const double step = h * 1.0e-3;
+	uint16_t k;
+
+	for (k = 0; k < intervals; k++)
+	{
+		double x0 = (double)lo + k * h;
+		double x1 = x0 + h;
+		double y0 = tcLookupReference(src, x0);
+		double y1 = tcLookupReference(src, x1);
+		float *c = coefficients + (size_t)k * (order + 1);
+
+		if (TC_LOOKUP_LINEAR == order)
+		{
+			c[0] = (float)y0;
+			c[1] = (float)(y1 - y0);
+			continue;
+		}
+
+		// Hermite in f = 0..1, slopes scaled by the interval width
+		double d0 = h * (tcLookupReference(src, x0 + step) - tcLookupReference(src, x0 - step)) / (2.0 * step);
+		double d1 = h * (tcLookupReference(src, x1 + step) - tcLookupReference(src, x1 - step)) / (2.0 * step);
+		c[0] = (float)y0;
+		c[1] = (float)d0;
+		c[2] = (float)(3.0 * (y1 - y0) - 2.0 * d0 - d1);
+		c[3] = (float)(2.0 * (y0 - y1) + d0 + d1);
+	}
+}
+
+// Worst difference between a one segment table and its source over [lo, hi]
+static double tcLookupError(const ThermocoupleLookupSource *src, float lo, float hi, float scale, uint16_t intervals, uint8_t order, float *coefficients)
+{
+	const float limits[2] = { lo, hi };
+	const uint16_t first[2] = { 0, intervals };
+	const ThermocoupleLookupTable run = { 1, order, limits, &scale, first, coefficients };
+	const uint32_t samples = (uint32_t)intervals * TC_LOOKUP_SAMPLES_PER_INTERVAL;
+	double worst = 0.0;
+	uint32_t j;
+
+	tcLookupFill(src, lo, scale, intervals, order, coefficients);
+	for (j = 0; j <= samples; j++)
+	{
+		float mv = (j == samples) ? hi : lo + (float)((double)(hi - lo) * j / samples);
+		double err = fabs((double)tcLookupTemperature(&run, mv) - tcLookupReference(src, mv));
+		if (err > worst)
+			worst = err;
+	}
+	return worst;
+}
+
+// Smallest interval count meeting maxError on [lo, hi], or 0 if there isn't one
+static uint16_t tcLookupSize(const ThermocoupleLookupSource *src, float lo, float hi, uint8_t order, float maxError, float *scratch, double *error)
+{
+	const double target = maxError * TC_LOOKUP_ERROR_MARGIN;
+	uint32_t good = 0, bad = 0, trial = 1;
+	double trialError;
+
+	// Double up to a count that works, then bisect back down
+	while (trial <= TC_LOOKUP_MAX_INTERVALS)
+	{
+		if (tcLookupError(src, lo, hi, (float)(trial / ((double)hi - lo)), trial, order, scratch) <= target)
+		{
+			good = trial;
+			break;
+		}
+		bad = trial;
+		trial = (trial * 2 > TC_LOOKUP_MAX_INTERVALS && trial < TC_LOOKUP_MAX_INTERVALS) ? TC_LOOKUP_MAX_INTERVALS : trial * 2;
+	}
+	if (!good)
+		return 0;
+
+	while (good - bad > 1)
+	{
+		trial = (good + bad) / 2;
+		if (tcLookupError(src, lo, hi, (float)(trial / ((double)hi - lo)), trial, order, scratch) <= target)
+			good = trial;
+		else
+			bad = trial;
+	}
+
+	trialError = tcLookupError(src, lo, hi, (float)(good / ((double)hi - lo)), good, order, scratch);
+	if (trialError > *error)
+		*error = trialError;
+	return (uint16_t)good;
+}
+
+ThermocoupleLookup::ThermocoupleLookup()
+	: coldJunction(NULL), storage(NULL), tableBytes(0), measuredError(0.0)
+{
+	memset(&lookupTable, 0, sizeof(lookupTable));
+}
+
+ThermocoupleLookup::~ThermocoupleLookup()
+{
+	release();
+}
+
+void ThermocoupleLookup::release()
+{
+	free(storage);
+	storage = NULL;
+	tableBytes = 0;
+	measuredError = 0.0;
+	memset(&lookupTable, 0, sizeof(lookupTable));
+}
+
+bool ThermocoupleLookup::build(const double *breakpoints, uint8_t segments, double (*evaluate)(double, uint8_t), float (*coldJunctionVoltage)(float), float maxError, uint8_t order, bool alignToBreakpoints)
+{
+	const uint8_t runs = alignToBreakpoints ? segments : 1;
+	uint16_t intervals[256];
+	float *scratch;
+	double error = 0.0;
+	uint32_t total = 0;
+	uint8_t r;
+
+	release();
+	if (TC_LOOKUP_LINEAR != order && TC_LOOKUP_CUBIC != order)
+		return false;
+
+	scratch = (float *)malloc(sizeof(float) * (order + 1) * TC_LOOKUP_MAX_INTERVALS);
+	if (NULL == scratch)
+		return false;
+
+	for (r = 0; r < runs; r++)
+	{
+		ThermocoupleLookupSource src = { breakpoints, segments, alignToBreakpoints ? r : segments, evaluate };
+		float lo = (float)breakpoints[alignToBreakpoints ? r : 0];
+		float hi = (float)breakpoints[alignToBreakpoints ? r + 1 : segments];
+
+		intervals[r] = tcLookupSize(&src, lo, hi, order, maxError, scratch, &error);
+		total += intervals[r];
+		if (0 == intervals[r] || total > TC_LOOKUP_MAX_INTERVALS)
+		{
+			free(scratch);
+			return false;
+		}
+	}
+	free(scratch);
+
+	// One allocation - floats first, then the uint16 offsets
+	size_t floats = (runs + 1) + runs + (size_t)total * (order + 1);
+	size_t bytes = sizeof(float) * floats + sizeof(uint16_t) * (runs + 1);
+	storage = malloc(bytes);
+	if (NULL == storage)
+		return false;
+
+	float *bp = (float *)storage;
+	float *scale = bp + runs + 1;
+	float *coefficients = scale + runs;
+	uint16_t *first = (uint16_t *)(coefficients + (size_t)total * (order + 1));
+
+	first[0] = 0;
+	for (r = 0; r < runs; r++)
+	{
+		ThermocoupleLookupSource src = { breakpoints, segments, alignToBreakpoints ? r : segments, evaluate };
+		bp[r] = (float)breakpoints[alignToBreakpoints ? r : 0];
+		bp[r + 1] = (float)breakpoints[alignToBreakpoints ? r + 1 : segments];
+		scale[r] = (float)(intervals[r] / ((double)bp[r + 1] - bp[r]));
+		first[r + 1] = first[r] + intervals[r];
+		tcLookupFill(&src, bp[r], scale[r], intervals[r], order, coefficients + (size_t)first[r] * (order + 1));
+	}
+
+	lookupTable.segments = runs;
+	lookupTable.order = order;
+	lookupTable.breakpoints = bp;
+	lookupTable.scale = scale;
+	lookupTable.first = first;
+	lookupTable.coefficients = coefficients;
+	coldJunction = coldJunctionVoltage;
+	tableBytes = bytes;
+	measuredError = (float)error;
+	return true;
+}
+
+#endif
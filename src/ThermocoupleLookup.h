@@ -0,0 +1,167 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleLookup.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Lookup table conversion - millivolts to temperature by interpolating a
+    table built from the rational fits, trading memory for speed.
+
+    The table is breakpoint-aligned by default: each of the type's rational
+    segments gets its own uniformly spaced run of intervals, so no interval
+    straddles the small step between two fits, and each run is only as fine
+    as its own segment needs.  A lookup is a compare per breakpoint to pick
+    the run, a multiply for the index, and then one multiply-add (linear) or
+    three (cubic Hermite) on that interval's coefficients.
+
+    Tables come from one of two places:
+      - ThermocoupleLookup builds them on the heap at run time, sized for a
+        requested maximum error (not available on AVR)
+      - extras/tools/lookup_table.cpp writes them out as a header, with the
+        arrays in PROGMEM on AVR
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_LOOKUP_H_
+#define _THERMOCOUPLE_LOOKUP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "Thermocouple.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define TC_LOOKUP_FLOAT(p) pgm_read_float(p)
+#define TC_LOOKUP_WORD(p) pgm_read_word(p)
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define TC_LOOKUP_FLOAT(p) (*(p))
+#define TC_LOOKUP_WORD(p) (*(p))
+#endif
+
+// Interpolation order
+#define TC_LOOKUP_LINEAR 1
+#define TC_LOOKUP_CUBIC 3
+
+struct ThermocoupleLookupTable
+{
+	uint8_t segments;
+	uint8_t order;              // TC_LOOKUP_LINEAR or TC_LOOKUP_CUBIC
+	const float *breakpoints;   // segments+1 millivolt limits
+	const float *scale;         // intervals per millivolt, per segment
+	const uint16_t *first;      // segments+1 - first interval of each segment
+	const float *coefficients;  // order+1 per interval, in the interval's fraction f
+};
+
+// millivolts = cold junction compensated voltage in mV
+// Returns temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE outside
+// [breakpoints[0], breakpoints[segments]]
+static inline float tcLookupTemperature(const ThermocoupleLookupTable *table, float millivolts)
+{
+	const uint8_t n = table->segments;
+	uint8_t seg = 0;
+	uint8_t i;
+
+	if (!(TC_LOOKUP_FLOAT(&table->breakpoints[0]) <= millivolts && millivolts <= TC_LOOKUP_FLOAT(&table->breakpoints[n])))
+		return TC_OUT_OF_RANGE_TEMPERATURE;
+	for (i = 1; i < n; i++)
+		seg += (millivolts >= TC_LOOKUP_FLOAT(&table->breakpoints[i]));
+
+	uint16_t first = TC_LOOKUP_WORD(&table->first[seg]);
+	uint16_t last = TC_LOOKUP_WORD(&table->first[seg + 1]) - 1;
+	float u = (millivolts - TC_LOOKUP_FLOAT(&table->breakpoints[seg])) * TC_LOOKUP_FLOAT(&table->scale[seg]);
+	uint16_t interval = first + (uint16_t)u;
+	if (interval > last)
+		interval = last;
+	float f = u - (float)(interval - first);
+
+	const float *c = table->coefficients + (size_t)interval * (table->order + 1);
+#if defined(FP_FAST_FMAF)
+	if (TC_LOOKUP_LINEAR == table->order)
+		return fmaf(TC_LOOKUP_FLOAT(&c[1]), f, TC_LOOKUP_FLOAT(&c[0]));
+	return fmaf(fmaf(fmaf(TC_LOOKUP_FLOAT(&c[3]), f, TC_LOOKUP_FLOAT(&c[2])), f, TC_LOOKUP_FLOAT(&c[1])), f, TC_LOOKUP_FLOAT(&c[0]));
+#else
+	if (TC_LOOKUP_LINEAR == table->order)
+		return TC_LOOKUP_FLOAT(&c[0]) + TC_LOOKUP_FLOAT(&c[1]) * f;
+	return TC_LOOKUP_FLOAT(&c[0]) + f * (TC_LOOKUP_FLOAT(&c[1]) + f * (TC_LOOKUP_FLOAT(&c[2]) + f * TC_LOOKUP_FLOAT(&c[3])));
+#endif
+}
+
+#if !defined(__AVR__)
+
+// A lookup table built on the heap at run time
+class ThermocoupleLookup
+{
+	public:
+		ThermocoupleLookup();
+		~ThermocoupleLookup();
+
+		// Build a table for Type whose worst-case difference from the type's fits
+		// (rational or polynomial) is at most maxError (C).  alignToBreakpoints =
+		// false gives a single uniformly spaced run over the whole range, which
+		// can't get below the step between fits at their breakpoints (a few
+		// hundredths of a degree).
+		// Returns false if the error can't be met within 65535 intervals or the
+		// allocation fails.
+		template<ThermocoupleType Type> bool build(float maxError, uint8_t order = TC_LOOKUP_LINEAR, bool alignToBreakpoints = true)
+		{
+			return build(Thermocouple<Type>::Tables::breakpoints, Thermocouple<Type>::Tables::segments,
+				&Thermocouple<Type>::evaluateSegment, &Thermocouple<Type, float>::computeColdJunctionVoltage, maxError, order, alignToBreakpoints);
+		}
+
+		// millivolts = thermocouple voltage in mV, Tcj = cold junction temperature in Celsius
+		// Both return TC_OUT_OF_RANGE_TEMPERATURE until build() has succeeded
+		float getTemperature(float millivolts, float Tcj)
+		{
+			if (NULL == storage)
+				return TC_OUT_OF_RANGE_TEMPERATURE;
+			return tcLookupTemperature(&lookupTable, millivolts + coldJunction(Tcj));
+		}
+
+		float computeTemperature(float millivolts)
+		{
+			if (NULL == storage)
+				return TC_OUT_OF_RANGE_TEMPERATURE;
+			return tcLookupTemperature(&lookupTable, millivolts);
+		}
+
+		const ThermocoupleLookupTable *table() const { return &lookupTable; }
+		// Table size in bytes, and the worst-case error measured while building it
+		size_t bytes() const { return tableBytes; }
+		float maxError() const { return measuredError; }
+
+	private:
+		ThermocoupleLookup(const ThermocoupleLookup &);
+		ThermocoupleLookup &operator=(const ThermocoupleLookup &);
+
+		bool build(const double *breakpoints, uint8_t segments, double (*evaluate)(double, uint8_t), float (*coldJunction)(float), float maxError, uint8_t order, bool alignToBreakpoints);
+		void release();
+
+		ThermocoupleLookupTable lookupTable;
+		float (*coldJunction)(float);
+		void *storage;
+		size_t tableBytes;
+		float measuredError;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleProfile.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Optional counters on the TypeX classes' per-sample conversions, to see
+    where conversion time goes on a deployed board.  Built in only with the
+    TC_PROFILE build flag - without it nothing here is compiled into the
+    library and the conversions are unchanged.
+
+    For each type built, every getTemperature(), computeTemperature() and
+    computeColdJunctionVoltage() call (float and double) is counted and
+    timed into a histogram of powers of two ticks, and computeTemperature()
+    also counts the segment each reading fell in, or whether it was under
+    or over the type's range.  A tick is the fastest clock available:
+      Cortex-M3 and up  DWT cycle counter (started by tcProfileReset())
+      x86               rdtsc
+      Linux, macOS      clock_gettime(CLOCK_MONOTONIC), ns
+      other Arduino     micros()
+    and the time includes reading it.  getTemperature() includes the other
+    two, which getResult(), getColdJunction() and the per-sample millivolt
+    convert() forms also go through.  The batch, ADC code and sensitivity
+    paths and the Thermocouple<> templates don't, and aren't counted.
+
+    The counters are plain increments.  Take snapshots from the code that
+    converts, or with interrupts off if conversions run in an interrupt.
+    tcProfileExport() packs a snapshot for telemetry, little-endian with a
+    CRC like a saved calibration.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_PROFILE_H_
+#define _THERMOCOUPLE_PROFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ThermocoupleTemplate.h"
+
+#if defined(TC_PROFILE)
+
+// Histogram buckets - bucket i counts calls taking 2^i to 2^(i+1)-1 ticks
+// (bucket 0 also 0 ticks), and the last one everything longer
+#ifndef TC_PROFILE_BUCKETS
+#define TC_PROFILE_BUCKETS 16
+#endif
+
+// What a tick is, from tcProfileClock()
+enum
+{
+	TC_PROFILE_CLOCK_NONE = 0,           // no clock - every call lands in bucket 0
+	TC_PROFILE_CLOCK_CYCLES = 1,         // CPU cycles (DWT)
+	TC_PROFILE_CLOCK_TSC = 2,            // x86 time stamp counter
+	TC_PROFILE_CLOCK_NANOSECONDS = 3,
+	TC_PROFILE_CLOCK_MICROSECONDS = 4
+};
+
+#if defined(__ARM_ARCH_PROFILE) && ('M' == __ARM_ARCH_PROFILE) && (__ARM_ARCH >= 7) && !defined(__ARM_ARCH_8M_BASE__)
+#define TC_PROFILE_CLOCK TC_PROFILE_CLOCK_CYCLES
+#define TC_PROFILE_DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#define TC_PROFILE_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+#define TC_PROFILE_DEMCR (*(volatile uint32_t *)0xE000EDFC)
+static inline uint32_t tcProfileTicks() { return TC_PROFILE_DWT_CYCCNT; }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TC_PROFILE_CLOCK TC_PROFILE_CLOCK_TSC
+static inline uint32_t tcProfileTicks() { return (uint32_t)__rdtsc(); }
+#elif defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#define TC_PROFILE_CLOCK TC_PROFILE_CLOCK_NANOSECONDS
+static inline uint32_t tcProfileTicks()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+#elif defined(ARDUINO)
+#include <Arduino.h>
+#define TC_PROFILE_CLOCK TC_PROFILE_CLOCK_MICROSECONDS
+static inline uint32_t tcProfileTicks() { return micros(); }
+#else
+#define TC_PROFILE_CLOCK TC_PROFILE_CLOCK_NONE
+static inline uint32_t tcProfileTicks() { return 0; }
+#endif
+
+// One function's calls and how long they took
+struct ThermocoupleProfileTimes
+{
+	uint32_t calls;
+	uint32_t histogram[TC_PROFILE_BUCKETS];
+};
+
+// One type's counters, from tcProfileSnapshot()
+struct ThermocoupleProfile
+{
+	ThermocoupleProfileTimes conversion;     // getTemperature()
+	ThermocoupleProfileTimes temperature;    // computeTemperature()
+	ThermocoupleProfileTimes coldJunction;   // computeColdJunctionVoltage()
+	uint32_t segmentCalls[TC_MAX_SEGMENTS];  // computeTemperature() readings in each segment
+	uint32_t underRange;                     // ... below the first segment
+	uint32_t overRange;                      // ... above the last (or NaN)
+};
+
+// Count one call that took ticks (wrapped differences are fine)
+static inline void tcProfileCount(ThermocoupleProfileTimes *times, uint32_t ticks)
+{
+	uint8_t bucket = 0;
+
+	while ((ticks >>= 1) && bucket < TC_PROFILE_BUCKETS - 1)
+		bucket++;
+	times->calls++;
+	times->histogram[bucket]++;
+}
+
+// Exported snapshot layout: version, type, clock, bucket count, segment
+// count, every counter in struct order as 32 bits little-endian, then a
+// CRC-16/CCITT-FALSE of all of it, low byte first
+#define TC_PROFILE_VERSION 1
+#define TC_PROFILE_SIZE (5 + 4 * (3 * (1 + TC_PROFILE_BUCKETS) + TC_MAX_SEGMENTS + 2) + 2)
+
+// Clear every type's counters.  On Cortex-M3 and up this also starts the
+// DWT cycle counter, so call it once from setup().
+void tcProfileReset();
+// Copy one type's counters to *profile.  Returns false, leaving *profile
+// alone, if the library wasn't built with that type.
+bool tcProfileSnapshot(ThermocoupleType type, ThermocoupleProfile *profile);
+// Write a snapshot of type to buffer (TC_PROFILE_SIZE bytes) and return the
+// number of bytes written
+size_t tcProfileExport(ThermocoupleType type, const ThermocoupleProfile &profile, uint8_t *buffer);
+// What the histograms count - TC_PROFILE_CLOCK_*
+static inline uint8_t tcProfileClock() { return TC_PROFILE_CLOCK; }
+
+#endif
+
+#endif
@@ -0,0 +1,301 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleRing.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Hands readings from an ADC interrupt (or a reader thread) to the loop
+    that converts them, without disabling interrupts or taking a lock.
+
+    ThermocoupleRing is a fixed-size single-producer, single-consumer ring
+    of ThermocoupleSample records.  The producer owns the head index and
+    the consumer owns the tail; each only reads the other's with an
+    acquire load and publishes its own with a release store, so a record
+    is always written in full before the consumer can see it, and its slot
+    isn't reused until the consumer is done with it.  Each side caches the
+    other's index and only reloads it when the ring looks full (or empty).
+
+    Indices are one byte on AVR, where that's the only size loads and
+    stores are atomic, which limits the ring to 128 records there.  On
+    hosts the two sides' indices are kept a cache line apart so the
+    threads don't contend for it.
+
+    ThermocoupleRingConverter drains a ring a batch at a time and converts
+    each batch with one array call per thermocouple type, using each
+    record's own cold junction temperature.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_RING_H_
+#define _THERMOCOUPLE_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Thermocouple.h"
+
+#if defined(__AVR__)
+typedef uint8_t tc_ring_index_t;
+#define TC_RING_MAX_CAPACITY 128
+#else
+typedef uint32_t tc_ring_index_t;
+#define TC_RING_MAX_CAPACITY 32768
+#endif
+
+// Space kept between the producer's and consumer's indices, 0 for parts
+// without a data cache
+#if !defined(TC_RING_CACHE_LINE)
+#if defined(__AVR__) || (defined(__ARM_ARCH_PROFILE) && 'M' == __ARM_ARCH_PROFILE)
+#define TC_RING_CACHE_LINE 0
+#else
+#define TC_RING_CACHE_LINE 64
+#endif
+#endif
+
+// One reading as the producer saw it
+template<typename T = float> struct ThermocoupleSample
+{
+	T millivolts;     // raw thermocouple voltage, mV
+	T Tcj;            // cold junction temperature, C
+	uint8_t channel;
+};
+
+// Capacity = records held, a power of two up to TC_RING_MAX_CAPACITY
+template<uint16_t Capacity, typename T = float>
+class ThermocoupleRing
+{
+	static_assert(Capacity > 0 && 0 == (Capacity & (Capacity - 1)), "capacity must be a power of two");
+	static_assert(Capacity <= TC_RING_MAX_CAPACITY, "capacity too large for the index type");
+
+	public:
+		ThermocoupleRing() { reset(); }
+
+		// Empties the ring and clears the overflow count.  Only while neither
+		// side is using it.
+		void reset()
+		{
+			head = tail = tailCache = headCache = 0;
+			overflowCount = 0;
+		}
+
+		// Producer side.  Returns false (and counts an overflow) if the ring is
+		// full - the record is dropped.
+		bool push(uint8_t channel, T millivolts, T Tcj)
+		{
+			tc_ring_index_t h = head;
+
+			if ((tc_ring_index_t)(h - tailCache) >= Capacity)
+			{
+				tailCache = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+				if ((tc_ring_index_t)(h - tailCache) >= Capacity)
+				{
+					if ((tc_ring_index_t)(overflowCount + 1) != 0)
+						__atomic_store_n(&overflowCount, (tc_ring_index_t)(overflowCount + 1), __ATOMIC_RELAXED);
+					return false;
+				}
+			}
+
+			ThermocoupleSample<T> &s = slot[h & (Capacity - 1)];
+			s.millivolts = millivolts;
+			s.Tcj = Tcj;
+			s.channel = channel;
+			__atomic_store_n(&head, (tc_ring_index_t)(h + 1), __ATOMIC_RELEASE);
+			return true;
+		}
+
+		// Consumer side.  Copies up to max records, oldest first, and returns
+		// how many.
+		uint16_t pop(ThermocoupleSample<T> *out, uint16_t max)
+		{
+			tc_ring_index_t t = tail;
+			tc_ring_index_t n = (tc_ring_index_t)(headCache - t);
+			uint16_t i;
+
+			if (n < max)
+			{
+				headCache = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+				n = (tc_ring_index_t)(headCache - t);
+			}
+			if (n > max)
+				n = (tc_ring_index_t)max;
+
+			for (i = 0; i < n; i++)
+				out[i] = slot[(tc_ring_index_t)(t + i) & (Capacity - 1)];
+			__atomic_store_n(&tail, (tc_ring_index_t)(t + n), __ATOMIC_RELEASE);
+			return (uint16_t)n;
+		}
+
+		bool pop(ThermocoupleSample<T> &out) { return 1 == pop(&out, 1); }
+
+		// Consumer side - records waiting
+		uint16_t available() const
+		{
+			return (uint16_t)(tc_ring_index_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - tail);
+		}
+
+		// Records dropped because the ring was full, since reset().  Stops at
+		// the largest tc_ring_index_t rather than wrapping.
+		tc_ring_index_t overflows() const { return __atomic_load_n(&overflowCount, __ATOMIC_RELAXED); }
+
+		static uint16_t capacity() { return Capacity; }
+
+	private:
+		// Written by the producer
+		tc_ring_index_t head;
+		tc_ring_index_t tailCache;       // last tail seen
+		tc_ring_index_t overflowCount;
+#if TC_RING_CACHE_LINE > 0
+		uint8_t producerPad[TC_RING_CACHE_LINE];
+#endif
+		// Written by the consumer
+		tc_ring_index_t tail;
+		tc_ring_index_t headCache;       // last head seen
+#if TC_RING_CACHE_LINE > 0
+		uint8_t consumerPad[TC_RING_CACHE_LINE];
+#endif
+		ThermocoupleSample<T> slot[Capacity];
+};
+
+// Channels = number of channel numbers the producer uses (up to 255),
+// Batch = records converted per array call, T = float or double
+template<uint8_t Channels, uint16_t Batch = 32, typename T = float>
+class ThermocoupleRingConverter
+{
+	static_assert(Batch > 0, "batch must hold at least one record");
+
+	public:
+		ThermocoupleRingConverter()
+		{
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				channel[ch] = NULL;
+			group();
+		}
+
+		// map[ch] = thermocouple on channel ch, or NULL if unused.  Share one
+		// object per type, as for ThermocoupleScanner.
+		ThermocoupleRingConverter(AbstractThermocouple *const map[Channels])
+		{
+			setChannels(map);
+		}
+
+		void setChannels(AbstractThermocouple *const map[Channels])
+		{
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				channel[ch] = map[ch];
+			group();
+		}
+
+		void setChannel(uint8_t ch, AbstractThermocouple *tc)
+		{
+			if (ch >= Channels)
+				return;
+			channel[ch] = tc;
+			group();
+		}
+
+		// Consumer side.  Pops up to Batch records into samples and converts
+		// them, filling temperatures (C) and, if not NULL, status (TC_STATUS_*
+		// bits) in the same order.  Results are identical to getResult() on
+		// each record.  A record for an unused channel reads
+		// TC_OUT_OF_RANGE_TEMPERATURE with TC_STATUS_UNUSED and
+		// TC_STATUS_OUT_OF_RANGE.  Returns the
+		// number of records popped - call until it returns 0 to empty the ring.
+		template<uint16_t Capacity> uint16_t drain(ThermocoupleRing<Capacity, T> &ring, ThermocoupleSample<T> *samples, T *temperatures, uint8_t *status)
+		{
+			uint16_t n = ring.pop(samples, Batch);
+			uint16_t i, p;
+			uint8_t g;
+
+			// Sort the batch by group, unused channels last, keeping each
+			// record's place so the results can be put back in ring order
+			for (g = 0; g <= groups; g++)
+				next[g] = 0;
+			for (i = 0; i < n; i++)
+			{
+				g = (samples[i].channel < Channels) ? groupOf[samples[i].channel] : groups;
+				recordGroup[i] = g;
+				next[g]++;
+			}
+			for (g = 0, p = 0; g <= groups; g++)
+			{
+				uint16_t count = next[g];
+				next[g] = p;
+				p += count;
+			}
+			for (i = 0; i < n; i++)
+			{
+				p = next[recordGroup[i]]++;
+				index[p] = i;
+				millivolts[p] = samples[i].millivolts;
+				Tcj[p] = samples[i].Tcj;
+			}
+
+			// next[g] is now the end of group g.  Convert each in place.
+			for (g = 0, p = 0; g < groups; p = next[g++])
+				if (next[g] > p)
+					object[g]->getTemperatures(millivolts + p, Tcj + p, millivolts + p, batchStatus + p, next[g] - p);
+			for (; p < n; p++)
+			{
+				millivolts[p] = T(TC_OUT_OF_RANGE_TEMPERATURE);
+				batchStatus[p] = TC_STATUS_UNUSED | TC_STATUS_OUT_OF_RANGE;
+			}
+
+			for (p = 0; p < n; p++)
+				temperatures[index[p]] = millivolts[p];
+			if (status)
+				for (p = 0; p < n; p++)
+					status[index[p]] = batchStatus[p];
+			return n;
+		}
+
+	private:
+		// Number the distinct thermocouple objects in first appearance order,
+		// with the unused channels in group number groups
+		void group()
+		{
+			uint8_t ch, g;
+
+			groups = 0;
+			for (ch = 0; ch < Channels; ch++)
+			{
+				if (NULL == channel[ch])
+					continue;
+				for (g = 0; g < groups && object[g] != channel[ch]; g++)
+					;
+				if (g == groups)
+					object[groups++] = channel[ch];
+				groupOf[ch] = g;
+			}
+			for (ch = 0; ch < Channels; ch++)
+				if (NULL == channel[ch])
+					groupOf[ch] = groups;
+		}
+
+		AbstractThermocouple *channel[Channels];
+		AbstractThermocouple *object[Channels];   // one per group
+		uint8_t groupOf[Channels];                // group of each channel
+		uint8_t groups;
+		// One batch, sorted by group
+		uint16_t next[Channels + 1];              // start, then end, of each group
+		uint8_t recordGroup[Batch];
+		uint16_t index[Batch];                    // record each entry came from
+		T millivolts[Batch];                      // readings, then temperatures
+		T Tcj[Batch];
+		uint8_t batchStatus[Batch];
+};
+
+#endif
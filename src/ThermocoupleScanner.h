@@ -0,0 +1,154 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleScanner.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Mixed-type multi-channel scanner.  Each channel is assigned a
+    thermocouple object; the scanner groups the channels by object once,
+    when the channel map changes.  Each scan then gathers a frame of
+    millivolt readings into group order, converts every group with one
+    batch call against a shared cold junction context, and scatters the
+    temperatures and their TC_STATUS_* bits back into channel order.
+
+    Nothing is allocated - the channel count is a template parameter and
+    all working storage is part of the object.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_SCANNER_H_
+#define _THERMOCOUPLE_SCANNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Thermocouple.h"
+
+// Channels = number of ADC inputs (up to 255), T = float or double
+template<uint8_t Channels, typename T = float>
+class ThermocoupleScanner
+{
+	public:
+		ThermocoupleScanner()
+		{
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				channel[ch] = NULL;
+			group();
+		}
+
+		// map[ch] = thermocouple on channel ch, or NULL if unused.  Channels with
+		// the same object are converted together, so share one object per type.
+		ThermocoupleScanner(AbstractThermocouple *const map[Channels])
+		{
+			setChannels(map);
+		}
+
+		void setChannels(AbstractThermocouple *const map[Channels])
+		{
+			for (uint8_t ch = 0; ch < Channels; ch++)
+				channel[ch] = map[ch];
+			group();
+		}
+
+		void setChannel(uint8_t ch, AbstractThermocouple *tc)
+		{
+			if (ch >= Channels)
+				return;
+			channel[ch] = tc;
+			group();
+		}
+
+		AbstractThermocouple *getChannel(uint8_t ch) const
+		{
+			return (ch < Channels) ? channel[ch] : NULL;
+		}
+
+		// millivolts = one reading per channel in mV, Tcj = cold junction temperature in Celsius
+		// Fills temperatures (C) and, if not NULL, status (TC_STATUS_* bits) - both
+		// in channel order, as getResult() would.  Unused channels read
+		// TC_OUT_OF_RANGE_TEMPERATURE with TC_STATUS_UNUSED and TC_STATUS_OUT_OF_RANGE.
+		// Returns the used channels' bits ORed together - 0 if they're all good.
+		uint8_t scan(const T *millivolts, T Tcj, T *temperatures, uint8_t *status)
+		{
+			uint8_t g, i, any = TC_STATUS_OK;
+
+			for (g = 0; g < groups; g++)
+			{
+				AbstractThermocouple *tc = channel[order[groupStart[g]]];
+				ThermocoupleColdJunction<T> coldJunction = tc->getColdJunction(Tcj);
+
+				for (i = groupStart[g]; i < groupStart[g + 1]; i++)
+					frame[i] = millivolts[order[i]];
+				// In place - the kernels read each sample before writing its result
+				any |= tc->convert(coldJunction, frame + groupStart[g], frame + groupStart[g], frameStatus + groupStart[g], groupStart[g + 1] - groupStart[g]);
+			}
+			for (i = groupStart[groups]; i < Channels; i++)
+			{
+				frame[i] = T(TC_OUT_OF_RANGE_TEMPERATURE);
+				frameStatus[i] = TC_STATUS_UNUSED | TC_STATUS_OUT_OF_RANGE;
+			}
+
+			for (i = 0; i < Channels; i++)
+				temperatures[order[i]] = frame[i];
+			if (NULL != status)
+				for (i = 0; i < Channels; i++)
+					status[order[i]] = frameStatus[i];
+			return any;
+		}
+
+	private:
+		// Sort the channels into runs sharing a thermocouple object, first
+		// appearance order, with the unused channels at the end of order[]
+		void group()
+		{
+			bool placed[Channels];
+			uint8_t n = 0, ch, other;
+
+			for (ch = 0; ch < Channels; ch++)
+				placed[ch] = (NULL == channel[ch]);
+
+			groups = 0;
+			for (ch = 0; ch < Channels; ch++)
+			{
+				if (placed[ch])
+					continue;
+				groupStart[groups++] = n;
+				for (other = ch; other < Channels; other++)
+				{
+					if (!placed[other] && channel[other] == channel[ch])
+					{
+						order[n++] = other;
+						placed[other] = true;
+					}
+				}
+			}
+			groupStart[groups] = n;
+
+			for (ch = 0; ch < Channels; ch++)
+				if (NULL == channel[ch])
+					order[n++] = ch;
+		}
+
+		AbstractThermocouple *channel[Channels];
+		uint8_t order[Channels];            // channel numbers, grouped
+		uint8_t groupStart[Channels + 1];   // start of each group in order[]
+		uint8_t groups;
+		T frame[Channels];                  // readings, then temperatures, in group order
+		uint8_t frameStatus[Channels];      // TC_STATUS_* bits, in group order
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleTemplate.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Compile-time specialized thermocouple conversions.  Thermocouple<Type, T>
+    has no state and no virtual functions - every member is a static
+    constexpr function, so conversions inline straight into the caller's
+    loop and conversions of constants happen entirely at compile time:
+
+      constexpr float limit = Thermocouple<ThermocoupleType::K, float>::getTemperature(20.644f, 0.0f);
+
+    T is the evaluation type (double or float).  The segment count is a
+    compile time constant, so the breakpoint count unrolls into a handful of
+    independent compares.  Polynomial picks the rational or the polynomial
+    millivolt-to-temperature tables, defaulting to the type's
+    TC_TYPE_x_POLYNOMIAL flag.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_TEMPLATE_H_
+#define _THERMOCOUPLE_TEMPLATE_H_
+
+#include "ThermocoupleCoefficients.h"
+
+template<ThermocoupleType Type, typename T = double, bool Polynomial = ThermocouplePolynomial<Type>::enabled>
+class Thermocouple
+{
+	public:
+		typedef ThermocoupleCoefficients<Type, T> Coefficients;
+		typedef ThermocoupleTemperatureTables<Type, T, Polynomial> Tables;
+
+		// millivolts = thermocouple voltage in mV, Tcj = cold junction temperature in Celsius
+		// Returns thermocouple temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE
+		static constexpr T getTemperature(T millivolts, T Tcj)
+		{
+			return computeTemperature(millivolts + computeColdJunctionVoltage(Tcj));
+		}
+
+		// millivolts = cold junction compensated voltage in mV
+		// Returns temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE
+		static constexpr T computeTemperature(T millivolts)
+		{
+			return inRange(millivolts) ? evaluateSegment(millivolts, segment(millivolts)) : T(TC_OUT_OF_RANGE_TEMPERATURE);
+		}
+
+		// getTemperature() with the reading's TC_STATUS_* bits
+		static constexpr ThermocoupleResult<T> getResult(T millivolts, T Tcj)
+		{
+			return result(millivolts + computeColdJunctionVoltage(Tcj), inputStatus(millivolts) | coldJunctionStatus(Tcj));
+		}
+
+		// millivolts = cold junction compensated voltage in mV
+		// Returns TC_STATUS_UNDER_RANGE, TC_STATUS_OVER_RANGE or TC_STATUS_OK
+		static constexpr uint8_t computeStatus(T millivolts)
+		{
+			return Tables::upperInclusive
+				? (uint8_t)((!(millivolts > Tables::breakpoints[0]) ? TC_STATUS_UNDER_RANGE : 0) | (!(millivolts <= Tables::breakpoints[Tables::segments]) ? TC_STATUS_OVER_RANGE : 0))
+				: (uint8_t)((!(millivolts >= Tables::breakpoints[0]) ? TC_STATUS_UNDER_RANGE : 0) | (!(millivolts < Tables::breakpoints[Tables::segments]) ? TC_STATUS_OVER_RANGE : 0));
+		}
+
+		// millivolts = raw thermocouple voltage in mV
+		// Returns TC_STATUS_OPEN_CIRCUIT or TC_STATUS_OK
+		static constexpr uint8_t inputStatus(T millivolts)
+		{
+			return (millivolts > -T(TC_OPEN_CIRCUIT_MILLIVOLTS) && millivolts < T(TC_OPEN_CIRCUIT_MILLIVOLTS)) ? TC_STATUS_OK : TC_STATUS_OPEN_CIRCUIT;
+		}
+
+		// Returns TC_STATUS_COLD_JUNCTION_RANGE or TC_STATUS_OK
+		static constexpr uint8_t coldJunctionStatus(T Tcj)
+		{
+			return (Tcj >= Coefficients::coldJunctionBreakpoints[0] && Tcj <= Coefficients::coldJunctionBreakpoints[Coefficients::coldJunctionSegments]) ? TC_STATUS_OK : TC_STATUS_COLD_JUNCTION_RANGE;
+		}
+
+		// Tcj = cold junction temperature in Celsius
+		// Returns equivalent voltage in mV.  Outside the cold junction tables the
+		// end segments are extrapolated.
+		static constexpr T computeColdJunctionVoltage(T Tcj)
+		{
+			return evaluateColdJunctionSegment(Tcj, coldJunctionSegment(Tcj));
+		}
+
+		// Index of the cold junction segment containing Tcj, clamped to the end segments
+		static constexpr uint8_t coldJunctionSegment(T Tcj)
+		{
+			return countColdJunctionBreakpoints(Tcj, 1);
+		}
+
+		// Index of the segment containing millivolts (only meaningful when in range)
+		static constexpr uint8_t segment(T millivolts)
+		{
+			return countBreakpoints(millivolts, 1);
+		}
+
+		static constexpr bool inRange(T millivolts)
+		{
+			return Tables::upperInclusive
+				? (Tables::breakpoints[0] < millivolts && millivolts <= Tables::breakpoints[Tables::segments])
+				: (Tables::breakpoints[0] <= millivolts && millivolts < Tables::breakpoints[Tables::segments]);
+		}
+
+		// Segment seg's rational or polynomial at millivolts, with no range check - also usable
+		// a little past the segment's ends, which table generators rely on
+		static constexpr T evaluateSegment(T millivolts, uint8_t seg)
+		{
+			return evaluate(millivolts - coefficient(TC_COEFF_V0, seg), seg);
+		}
+
+		// temperature = thermocouple temperature in Celsius, Tcj = cold junction temperature in Celsius
+		// Returns the voltage the thermocouple reads in mV, or TC_OUT_OF_RANGE_TEMPERATURE
+		static constexpr T getVoltage(T temperature, T Tcj)
+		{
+			return inForwardRange(temperature)
+				? (evaluateForwardSegment(temperature, forwardSegment(temperature)) - computeColdJunctionVoltage(Tcj))
+				: T(TC_OUT_OF_RANGE_TEMPERATURE);
+		}
+
+		// temperature = thermocouple temperature in Celsius
+		// Returns voltage referenced to 0C in mV, or TC_OUT_OF_RANGE_TEMPERATURE
+		static constexpr T computeVoltage(T temperature)
+		{
+			return inForwardRange(temperature) ? evaluateForwardSegment(temperature, forwardSegment(temperature)) : T(TC_OUT_OF_RANGE_TEMPERATURE);
+		}
+
+		// Index of the forward segment containing temperature (only meaningful when in range)
+		static constexpr uint8_t forwardSegment(T temperature)
+		{
+			return countForwardBreakpoints(temperature, 1);
+		}
+
+		static constexpr bool inForwardRange(T temperature)
+		{
+			return (Coefficients::forwardBreakpoints[0] <= temperature && temperature <= Coefficients::forwardBreakpoints[Coefficients::forwardSegments]);
+		}
+
+	private:
+		// millivolts = cold junction compensated voltage, status = raw reading and cold junction bits
+		static constexpr ThermocoupleResult<T> result(T millivolts, uint8_t status)
+		{
+			return ThermocoupleResult<T>{ computeTemperature(millivolts), (uint8_t)(status | computeStatus(millivolts)) };
+		}
+
+		static constexpr uint8_t countBreakpoints(T millivolts, uint8_t i)
+		{
+			return (i < Tables::segments) ? (uint8_t)(above(millivolts, i) + countBreakpoints(millivolts, i + 1)) : 0;
+		}
+
+		static constexpr uint8_t above(T millivolts, uint8_t i)
+		{
+			return Tables::upperInclusive ? (millivolts > Tables::breakpoints[i]) : (millivolts >= Tables::breakpoints[i]);
+		}
+
+		static constexpr T coefficient(uint8_t column, uint8_t seg)
+		{
+			return Tables::coefficients[column * Tables::segments + seg];
+		}
+
+		// x = millivolts - V0 for the segment
+		static constexpr T evaluate(T x, uint8_t seg)
+		{
+			return Tables::degree ? coefficient(TC_COEFF_T0, seg) + x * evaluatePolynomial(x, seg, 1) : evaluateRational(x, seg);
+		}
+
+		// a_k + x*(a_k+1 + ... + x*a_degree), in the kernels' Horner order
+		static constexpr T evaluatePolynomial(T x, uint8_t seg, uint8_t k)
+		{
+			return (k < Tables::degree)
+				? coefficient(TC_POLYNOMIAL_A1 + k - 1, seg) + x * evaluatePolynomial(x, seg, k + 1)
+				: coefficient(TC_POLYNOMIAL_A1 + k - 1, seg);
+		}
+
+		static constexpr T evaluateRational(T x, uint8_t seg)
+		{
+			return coefficient(TC_COEFF_T0, seg)
+				+ ((x * (coefficient(TC_COEFF_P1, seg) + x * (coefficient(TC_COEFF_P2, seg) + x * (coefficient(TC_COEFF_P3, seg) + coefficient(TC_COEFF_P4, seg) * x))))
+				/ (T(1.0) + x * (coefficient(TC_COEFF_Q1, seg) + x * (coefficient(TC_COEFF_Q2, seg) + coefficient(TC_COEFF_Q3, seg) * x))));
+		}
+
+		static constexpr uint8_t countForwardBreakpoints(T temperature, uint8_t i)
+		{
+			return (i < Coefficients::forwardSegments) ? (uint8_t)((temperature >= Coefficients::forwardBreakpoints[i]) + countForwardBreakpoints(temperature, i + 1)) : 0;
+		}
+
+		static constexpr T forwardCoefficient(uint8_t column, uint8_t seg)
+		{
+			return Coefficients::forwardCoefficients[column * Coefficients::forwardSegments + seg];
+		}
+
+		static constexpr T evaluateForwardSegment(T temperature, uint8_t seg)
+		{
+			return evaluateForward(temperature - forwardCoefficient(TC_COEFF_T0, seg), seg);
+		}
+
+		// x = temperature - T0 for the segment
+		static constexpr T evaluateForward(T x, uint8_t seg)
+		{
+			return forwardCoefficient(TC_COEFF_V0, seg)
+				+ ((x * (forwardCoefficient(TC_COEFF_P1, seg) + x * (forwardCoefficient(TC_COEFF_P2, seg) + x * (forwardCoefficient(TC_COEFF_P3, seg) + forwardCoefficient(TC_COEFF_P4, seg) * x))))
+				/ (T(1.0) + x * (forwardCoefficient(TC_COEFF_Q1, seg) + x * (forwardCoefficient(TC_COEFF_Q2, seg) + forwardCoefficient(TC_COEFF_Q3, seg) * x))));
+		}
+
+		static constexpr uint8_t countColdJunctionBreakpoints(T Tcj, uint8_t i)
+		{
+			return (i < Coefficients::coldJunctionSegments) ? (uint8_t)((Tcj >= Coefficients::coldJunctionBreakpoints[i]) + countColdJunctionBreakpoints(Tcj, i + 1)) : 0;
+		}
+
+		static constexpr T coldJunctionCoefficient(uint8_t column, uint8_t seg)
+		{
+			return Coefficients::coldJunction[column * Coefficients::coldJunctionSegments + seg];
+		}
+
+		static constexpr T evaluateColdJunctionSegment(T Tcj, uint8_t seg)
+		{
+			return evaluateColdJunction(Tcj - coldJunctionCoefficient(TC_CJ_COEFF_T0, seg), seg);
+		}
+
+		// t = Tcj - T0 for the segment
+		static constexpr T evaluateColdJunction(T t, uint8_t seg)
+		{
+			return coldJunctionCoefficient(TC_CJ_COEFF_V0, seg)
+				+ ((t * (coldJunctionCoefficient(TC_CJ_COEFF_P1, seg) + t * (coldJunctionCoefficient(TC_CJ_COEFF_P2, seg) + t * (coldJunctionCoefficient(TC_CJ_COEFF_P3, seg) + coldJunctionCoefficient(TC_CJ_COEFF_P4, seg) * t))))
+				/ (T(1.0) + t * (coldJunctionCoefficient(TC_CJ_COEFF_Q1, seg) + coldJunctionCoefficient(TC_CJ_COEFF_Q2, seg) * t)));
+		}
+};
+
+#endif
@@ -0,0 +1,255 @@
+/*************************************************************************
+Title:    Thermocouple Direct Measurement Library
+Authors:  Nathan D. Holmes <maverick@drgw.net>
+Authors:  Michael D. Petersen <railfan@drgw.net>
+File:     ThermocoupleTracker.h
+License:  GNU General Public License v3
+
+ABOUT:
+    Incremental conversion for slowly changing channels.  A tracker holds
+    one channel's last fully converted reading (the anchor) along with the
+    derivatives of the rational fit there, and converts readings near the
+    anchor with a Taylor step instead of a segment search and a divide:
+
+      linear     t = t0 + dv * dT/dV
+      quadratic  t = t0 + dv * (dT/dV + dv * d2T/dV2 / 2)
+
+    The window around the anchor where the step is used is sized from the
+    next derivative so the step stays within maxError of the full
+    conversion, and never crosses a segment breakpoint.  A reading outside
+    the window is converted in full and becomes the new anchor.
+
+    In float, Type E below -9.66 mV (about -245C) is the exception: the
+    full conversion there is itself up to 0.03C off the double one, so a
+    step can differ from it by twice that on top of maxError.  Use a double
+    tracker if that range matters.
+
+    The derivatives are taken from the rational tables, so a tracker always
+    converts with those, even for a type built with TC_TYPE_x_POLYNOMIAL.
+
+    Hit and miss counts are always kept.  With auditing on, every hit is
+    also converted in full and the largest difference recorded, for tuning
+    maxError and the order against real data.
+
+LICENSE:
+    Copyright (C) 2021 Nathan D. Holmes & Michael D. Petersen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+*************************************************************************/
+
+#ifndef _THERMOCOUPLE_TRACKER_H_
+#define _THERMOCOUPLE_TRACKER_H_
+
+#include <stdint.h>
+#include <math.h>
+#include "ThermocoupleTemplate.h"
+
+// Taylor step order
+#define TC_TRACKER_LINEAR 1
+#define TC_TRACKER_QUADRATIC 2
+
+// Fraction of maxError the window is sized for.  The window comes from the
+// derivative at the anchor, which changes across the window.
+#define TC_TRACKER_ERROR_MARGIN 0.5
+
+struct ThermocoupleTrackerStats
+{
+	uint32_t hits;       // readings converted with the Taylor step
+	uint32_t misses;     // readings converted in full (including out of range)
+	uint32_t audited;    // hits also converted in full, with auditing on
+	float maxError;      // largest |step - full conversion| seen in C, with auditing on
+};
+
+// Largest dv with |derivative| dv^(1/power) <= limit - unlimited for a zero derivative
+template<typename T> static inline T tcTrackerRoot(T limit, T derivative, T power)
+{
+	return (T(0) != derivative) ? (T)pow(limit / fabs(derivative), power) : T(INFINITY);
+}
+
+template<typename T> static inline T tcTrackerMin(T a, T b)
+{
+	return (a < b) ? a : b;
+}
+
+template<ThermocoupleType Type, typename T = float>
+class ThermocoupleTracker
+{
+	typedef Thermocouple<Type, T, false> Conversion;
+	typedef ThermocoupleCoefficients<Type, T> Coefficients;
+
+	public:
+		// maxError = allowed difference from the full conversion in C
+		// order = TC_TRACKER_LINEAR or TC_TRACKER_QUADRATIC
+		ThermocoupleTracker(T maxError = T(0.01), uint8_t order = TC_TRACKER_LINEAR) : maxError(maxError), order(order), audit(false)
+		{
+			reset();
+			clearStats();
+		}
+
+		// Drop the anchor - the next reading is converted in full.  Call when the
+		// channel's input jumps (sensor swapped, mux restarted).
+		void reset()
+		{
+			windowLow = windowHigh = T(0);
+			anchor = anchorTemperature = slope = curvature = T(0);
+			Tcj = T(TC_OUT_OF_RANGE_TEMPERATURE);
+			coldJunction = T(0);
+		}
+
+		void setMaxError(T error)
+		{
+			maxError = error;
+			reset();
+		}
+
+		void setOrder(uint8_t taylorOrder)
+		{
+			order = taylorOrder;
+			reset();
+		}
+
+		// Also convert every hit in full and track the largest difference
+		void setAudit(bool enable) { audit = enable; }
+
+		const ThermocoupleTrackerStats &getStats() const { return stats; }
+
+		void clearStats()
+		{
+			stats.hits = stats.misses = stats.audited = 0;
+			stats.maxError = 0.0f;
+		}
+
+		// millivolts = thermocouple voltage in mV, Tcj = cold junction temperature in Celsius
+		// Returns thermocouple temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE
+		// The cold junction voltage is only recomputed when Tcj changes.
+		T getTemperature(T millivolts, T coldJunctionTemperature)
+		{
+			if (coldJunctionTemperature != Tcj)
+			{
+				Tcj = coldJunctionTemperature;
+				coldJunction = Conversion::computeColdJunctionVoltage(Tcj);
+			}
+			return computeTemperature(millivolts + coldJunction);
+		}
+
+		// millivolts = cold junction compensated voltage in mV
+		// Returns temperature in Celsius, or TC_OUT_OF_RANGE_TEMPERATURE
+		T computeTemperature(T millivolts)
+		{
+			if (windowLow < millivolts && millivolts < windowHigh)
+			{
+				T dv = millivolts - anchor;
+				T temperature = anchorTemperature + dv * (slope + dv * curvature);
+				stats.hits++;
+				if (audit)
+				{
+					float error = fabs((float)(temperature - Conversion::computeTemperature(millivolts)));
+					stats.audited++;
+					if (error > stats.maxError)
+						stats.maxError = error;
+				}
+				return temperature;
+			}
+
+			stats.misses++;
+			if (!Conversion::inRange(millivolts))
+			{
+				windowLow = windowHigh = T(0);
+				return T(TC_OUT_OF_RANGE_TEMPERATURE);
+			}
+			return anchorAt(millivolts);
+		}
+
+	private:
+		// Full conversion of millivolts (in range), and the Taylor step and
+		// window around it
+		T anchorAt(T millivolts)
+		{
+			const uint8_t n = Coefficients::segments;
+			const T *c = Coefficients::coefficients;
+			const uint8_t seg = Conversion::segment(millivolts);
+			T p1 = c[TC_COEFF_P1 * n + seg], p2 = c[TC_COEFF_P2 * n + seg], p3 = c[TC_COEFF_P3 * n + seg], p4 = c[TC_COEFF_P4 * n + seg];
+			T q1 = c[TC_COEFF_Q1 * n + seg], q2 = c[TC_COEFF_Q2 * n + seg], q3 = c[TC_COEFF_Q3 * n + seg];
+			T x = millivolts - c[TC_COEFF_V0 * n + seg];
+			T half;
+
+			anchor = millivolts;
+			anchorTemperature = Conversion::evaluateSegment(millivolts, seg);
+
+			// Derivatives of r = N/D from D r = N, differentiated term by term:
+			//   D r' = N' - D' r
+			//   D r'' = N'' - 2 D' r' - D'' r
+			//   D r''' = N''' - 3 D' r'' - 3 D'' r' - D''' r
+			//   D r'''' = N'''' - 4 D' r''' - 6 D'' r'' - 4 D''' r'
+			T dN1 = p1 + x * (T(2) * p2 + x * (T(3) * p3 + T(4) * p4 * x));
+			T dN2 = T(2) * p2 + x * (T(6) * p3 + T(12) * p4 * x);
+			T dN3 = T(6) * p3 + T(24) * p4 * x;
+			T dN4 = T(24) * p4;
+			T D = T(1) + x * (q1 + x * (q2 + q3 * x));
+			T dD1 = q1 + x * (T(2) * q2 + T(3) * q3 * x);
+			T dD2 = T(2) * q2 + T(6) * q3 * x;
+			T dD3 = T(6) * q3;
+			T invD = T(1) / D;
+			T r = anchorTemperature - c[TC_COEFF_T0 * n + seg];
+			T r1 = (dN1 - dD1 * r) * invD;
+			T r2 = (dN2 - T(2) * dD1 * r1 - dD2 * r) * invD;
+			T r3 = (dN3 - T(3) * dD1 * r2 - T(3) * dD2 * r1 - dD3 * r) * invD;
+			T budget = T(TC_TRACKER_ERROR_MARGIN) * maxError;
+
+			// The step's error is about the next Taylor term, but that alone gives
+			// far too wide a window where its derivative passes through zero (an
+			// inflection, for linear steps).  So the next two terms are each held
+			// to half the budget.
+			slope = r1;
+			if (TC_TRACKER_QUADRATIC == order)
+			{
+				// |r'''| dv^3 / 6 + |r''''| dv^4 / 24, with D'''' = 0
+				T r4 = (dN4 - T(4) * dD1 * r3 - T(6) * dD2 * r2 - T(4) * dD3 * r1) * invD;
+				curvature = r2 / T(2);
+				half = tcTrackerMin(tcTrackerRoot(T(3) * budget, r3, T(1) / T(3)), tcTrackerRoot(T(12) * budget, r4, T(0.25)));
+			}
+			else
+			{
+				// |r''| dv^2 / 2 + |r'''| dv^3 / 6
+				curvature = T(0);
+				half = tcTrackerMin(tcTrackerRoot(budget, r2, T(0.5)), tcTrackerRoot(T(3) * budget, r3, T(1) / T(3)));
+			}
+
+			windowLow = anchor - half;
+			windowHigh = anchor + half;
+			if (windowLow < Coefficients::breakpoints[seg])
+				windowLow = Coefficients::breakpoints[seg];
+			if (windowHigh > Coefficients::breakpoints[seg + 1])
+				windowHigh = Coefficients::breakpoints[seg + 1];
+
+			return anchorTemperature;
+		}
+
+		T maxError;
+		uint8_t order;
+		bool audit;
+		ThermocoupleTrackerStats stats;
+
+		// Open interval of readings converted with the Taylor step - empty
+		// (0, 0) until the first in-range reading
+		T windowLow;
+		T windowHigh;
+		T anchor;
+		T anchorTemperature;
+		T slope;       // dT/dV at the anchor
+		T curvature;   // d2T/dV2 / 2 at the anchor, or 0 for linear steps
+
+		T Tcj;            // cold junction temperature of the cached voltage
+		T coldJunction;   // its equivalent voltage in mV
+};
+
+#endif